@@ -0,0 +1,243 @@
+// Benchmark: CodexScanner vs the former QRegularExpression parsing path.
+//
+// Usage: bench_codex_scanner [iterations] [files...]
+// Without files, runs on codex-nag-hammadi.md and texts_clean/*.md from the
+// source tree. Both paths must produce identical pages, page offset, table of
+// contents and (NH X, Y) titles; the exit code is non-zero otherwise or when
+// the scanner is not faster.
+
+#include "core/services/CodexScanner.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QTextStream>
+
+#include <algorithm>
+#include <limits>
+
+using namespace codex::core;
+
+namespace {
+
+struct LegacyResult {
+    QVector<PageSpan> pages;
+    QVector<CodexTitleHeader> titleHeaders;
+    int codexStartPage = -1;
+};
+
+// Same normalization as TextParser::normalizeContent()
+QString loadNormalized(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return {};
+
+    QString content = QString::fromUtf8(file.readAll());
+    if (content.startsWith(QChar(0xFEFF))) content.remove(0, 1);
+    content.replace("\r\n", "\n");
+    content.replace(u'\r', u'\n');
+    content.replace(QChar(0x2013), u'-');
+    content.replace(QChar(0x2014), u'-');
+    return content;
+}
+
+// Former TextParser::parsePages(), detectPageOffset() and parseByTitleHeaders() regexes.
+// The separator search stops before the next marker: searching from the next
+// page's content start picked that page's own "---" when it was blank.
+LegacyResult legacyScan(const QString& content) {
+    LegacyResult result;
+
+    QRegularExpression pageRegex("## Page (\\d+)\\s*\\n");
+    QRegularExpressionMatchIterator it = pageRegex.globalMatch(content);
+
+    QVector<int> pageMarkers;
+    QVector<int> pageStarts;
+    QVector<int> pageNumbers;
+    while (it.hasNext()) {
+        QRegularExpressionMatch match = it.next();
+        pageMarkers.append(match.capturedStart());
+        pageStarts.append(match.capturedEnd());
+        pageNumbers.append(match.captured(1).toInt());
+    }
+
+    for (int i = 0; i < pageStarts.size(); ++i) {
+        int start = pageStarts[i];
+        int end = content.length();
+        if (i + 1 < pageStarts.size()) {
+            end = content.lastIndexOf("---", pageMarkers[i + 1] - 3);
+            if (end < start) end = pageMarkers[i + 1];
+        }
+
+        QStringView page = QStringView(content).mid(start, end - start).trimmed();
+        if (page.endsWith(u"---")) {
+            page.chop(3);
+            page = page.trimmed();
+        }
+
+        int pageNum = pageNumbers[i];
+        if (result.pages.size() <= pageNum) result.pages.resize(pageNum + 1);
+        result.pages[pageNum] = {page.data() - content.constData(), page.size()};
+    }
+
+    auto pageView = [&](int i) {
+        return QStringView(content).mid(result.pages[i].offset, result.pages[i].length);
+    };
+
+    QRegularExpression codexStartRegex(R"(^1\s*\nCodex\s+I-1)", QRegularExpression::MultilineOption);
+    for (int i = 0; i < result.pages.size(); ++i) {
+        if (codexStartRegex.matchView(pageView(i)).hasMatch()) {
+            result.codexStartPage = i;
+            break;
+        }
+    }
+
+    QRegularExpression titleRegex(
+        R"(^<?([A-ZÀÂÄÉÈÊËÏÎÔÙÛÜÇ][A-ZÀÂÄÉÈÊËÏÎÔÙÛÜÇ'\s\-]+?)>?\s*\(NH\s+([IVX]+),?\s*(\d+)\))",
+        QRegularExpression::MultilineOption
+    );
+    for (int i = 0; i < result.pages.size(); ++i) {
+        QRegularExpressionMatchIterator titles = titleRegex.globalMatchView(pageView(i));
+        while (titles.hasNext()) {
+            QRegularExpressionMatch match = titles.next();
+            result.titleHeaders.append({i, match.captured(2) + "-" + match.captured(3),
+                                        match.captured(1).trimmed()});
+        }
+    }
+
+    return result;
+}
+
+// Former TextParser::parseTableOfContents() regex
+QVector<TreatiseInfo> legacyTableOfContents(const QString& toc) {
+    QVector<TreatiseInfo> entries;
+    QRegularExpression tocRegex(
+        R"(([IVX]+-\d+|8502-\d+|X)\s+(\d+\*?-\d+\*?|A-B)\s+(.+?)\s*(?:\.[\s.]*){2,}\s*(\d+))"
+    );
+
+    QRegularExpressionMatchIterator it = tocRegex.globalMatch(toc);
+    while (it.hasNext()) {
+        QRegularExpressionMatch match = it.next();
+        TreatiseInfo info;
+        info.code = match.captured(1);
+        info.pages = match.captured(2);
+        info.title = match.captured(3).trimmed();
+        info.startPage = match.captured(4).toInt();
+        entries.append(info);
+    }
+    return entries;
+}
+
+QString tableOfContents(const QString& content, const QVector<PageSpan>& pages) {
+    QString toc;
+    for (int i = 7; i <= 8 && i < pages.size(); ++i) {
+        toc += QStringView(content).mid(pages[i].offset, pages[i].length);
+        toc += u'\n';
+    }
+    return toc;
+}
+
+bool samePages(const QVector<PageSpan>& a, const QVector<PageSpan>& b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const PageSpan& x, const PageSpan& y) {
+        return x.offset == y.offset && x.length == y.length;
+    });
+}
+
+bool sameHeaders(const QVector<CodexTitleHeader>& a, const QVector<CodexTitleHeader>& b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const CodexTitleHeader& x, const CodexTitleHeader& y) {
+        return x.page == y.page && x.code == y.code && x.title == y.title;
+    });
+}
+
+bool sameEntries(const QVector<TreatiseInfo>& a, const QVector<TreatiseInfo>& b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const TreatiseInfo& x, const TreatiseInfo& y) {
+        return x.code == y.code && x.pages == y.pages && x.title == y.title && x.startPage == y.startPage;
+    });
+}
+
+// Best of N runs, in milliseconds
+template <typename Fn>
+double bestOf(int iterations, Fn&& fn) {
+    qint64 best = std::numeric_limits<qint64>::max();
+    QElapsedTimer timer;
+    for (int i = 0; i < iterations; ++i) {
+        timer.start();
+        fn();
+        best = std::min(best, timer.nsecsElapsed());
+    }
+    return best / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QTextStream out(stdout);
+
+    int iterations = 10;
+    QStringList files;
+    for (int i = 1; i < argc; ++i) {
+        bool isNumber = false;
+        const int value = QString::fromLocal8Bit(argv[i]).toInt(&isNumber);
+        if (isNumber && value > 0) {
+            iterations = value;
+        } else {
+            files.append(QString::fromLocal8Bit(argv[i]));
+        }
+    }
+
+    if (files.isEmpty()) {
+        const QDir source(CODEX_SOURCE_DIR);
+        files.append(source.filePath("codex-nag-hammadi.md"));
+        const QDir texts(source.filePath("texts_clean"));
+        for (const QString& name : texts.entryList({"*.md"}, QDir::Files, QDir::Name)) {
+            files.append(texts.filePath(name));
+        }
+    }
+
+    bool ok = true;
+    out << QString("%1  %2  %3  %4  %5\n")
+           .arg("file", -40).arg("stage", -10).arg("regex ms", 10).arg("scan ms", 10).arg("speedup", 8);
+
+    for (const QString& path : files) {
+        const QString content = loadNormalized(path);
+        if (content.isEmpty()) {
+            out << "cannot read " << path << "\n";
+            ok = false;
+            continue;
+        }
+        const QString name = QFileInfo(path).fileName().left(40);
+
+        LegacyResult legacy;
+        CodexScan scan;
+        const double legacyPages = bestOf(iterations, [&]() { legacy = legacyScan(content); });
+        const double scanPages = bestOf(iterations, [&]() { scan = CodexScanner::scan(content); });
+
+        const QString toc = tableOfContents(content, scan.pages);
+        QVector<TreatiseInfo> legacyToc, scanToc;
+        const double legacyTocMs = bestOf(iterations, [&]() { legacyToc = legacyTableOfContents(toc); });
+        const double scanTocMs = bestOf(iterations, [&]() { scanToc = CodexScanner::scanTableOfContents(toc); });
+
+        auto report = [&](const QString& stage, double regexMs, double scanMs) {
+            out << QString("%1  %2  %3  %4  %5x\n")
+                   .arg(name, -40).arg(stage, -10)
+                   .arg(regexMs, 10, 'f', 3).arg(scanMs, 10, 'f', 3)
+                   .arg(scanMs > 0 ? regexMs / scanMs : 0.0, 7, 'f', 1);
+            if (scanMs >= regexMs) ok = false;
+        };
+        report("pages", legacyPages, scanPages);
+        if (!toc.isEmpty()) report("toc", legacyTocMs, scanTocMs);
+
+        const bool same = samePages(legacy.pages, scan.pages)
+            && legacy.codexStartPage == scan.codexStartPage
+            && sameHeaders(legacy.titleHeaders, scan.titleHeaders)
+            && sameEntries(legacyToc, scanToc);
+        out << QString("%1  %2 pages, %3 titles, %4 toc entries, codex start %5: %6\n")
+               .arg(name, -40).arg(scan.pages.size()).arg(scan.titleHeaders.size())
+               .arg(scanToc.size()).arg(scan.codexStartPage)
+               .arg(same ? "identical" : "MISMATCH");
+        ok = ok && same;
+    }
+
+    out.flush();
+    return ok ? 0 : 1;
+}
@@ -1,16 +1,34 @@
 #include "ApiClient.h"
+#include "RateLimiter.h"
+#include "ResponseCache.h"
+#include "SharedRequest.h"
+#include "utils/Config.h"
 #include "utils/Logger.h"
 
 #include <QNetworkRequest>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+#include <QUrl>
 
 namespace codex::api {
 
 ApiClient::ApiClient(QObject* parent)
     : QObject(parent)
-    , m_networkManager(new QNetworkAccessManager(this))
+    , m_network(&NetworkTransport::instance())
 {
 }
 
+ApiClient::~ApiClient() {
+    // The shared transport outlives its clients: drop what is still in flight
+    const QList<QNetworkReply*> replies = m_pending.keys();
+    for (QNetworkReply* reply : replies) {
+        reply->disconnect(this);
+        reply->abort();
+        reply->deleteLater();
+    }
+}
+
 void ApiClient::setApiKey(const QString& key) {
     m_apiKey = key;
 }
@@ -32,6 +50,17 @@ void ApiClient::setProvider(GoogleAIProvider provider) {
              .arg(provider == GoogleAIProvider::VertexAI ? "Vertex AI" : "AI Studio"));
 }
 
+QThreadPool* ApiClient::decoderPool() {
+    // Separate from the global pool so decoding never competes with other
+    // background work; a couple of threads is enough for a few replies at once
+    static QThreadPool* pool = [] {
+        auto* p = new QThreadPool();
+        p->setMaxThreadCount(qBound(2, QThread::idealThreadCount() / 2, 4));
+        return p;
+    }();
+    return pool;
+}
+
 bool ApiClient::isConfigured() const {
     if (m_provider == GoogleAIProvider::VertexAI) {
         return !m_accessToken.isEmpty() && !m_vertexProjectId.isEmpty();
@@ -43,6 +72,102 @@ QString ApiClient::getVertexBaseUrl() const {
     return QString("https://%1-aiplatform.googleapis.com/v1").arg(m_vertexRegion);
 }
 
+QString ApiClient::quotaKey() const {
+    return QUrl(m_baseUrl).host();
+}
+
+bool ApiClient::serveFromCache(const QByteArray& key, const CacheHandler& deliver) {
+    if (m_cacheBypass) return false;
+
+    const QList<QByteArray> blobs = ResponseCache::instance().lookup(key);
+    if (blobs.isEmpty()) return false;
+
+    LOG_INFO(QString("ApiClient: %1 answered from the response cache").arg(quotaKey()));
+    QTimer::singleShot(0, this, [deliver, blobs]() { deliver(blobs); });
+    return true;
+}
+
+void ApiClient::sendPost(const QNetworkRequest& request, const QByteArray& body, const ReplyHandler& attach) {
+    send({request, body, true, quotaKey(), m_ticket, attach, 0});
+}
+
+void ApiClient::sendGet(const QNetworkRequest& request, const ReplyHandler& attach) {
+    send({request, QByteArray(), false, quotaKey(), m_ticket, attach, 0});
+}
+
+void ApiClient::send(const PendingRequest& pending) {
+    // Generation calls are queued and shared with identical ones in flight,
+    // polls and downloads go straight out
+    QNetworkReply* reply = pending.post
+        ? SharedRequest::subscribe(pending.request, pending.body, pending.quotaKey, pending.ticket)
+        : m_network->get(pending.request);
+    m_pending.insert(reply, pending);
+
+    connect(reply, &QObject::destroyed, this, [this, reply]() {
+        m_pending.remove(reply);
+    });
+
+    pending.attach(reply);
+}
+
+bool ApiClient::scheduleRetry(QNetworkReply* reply) {
+    const auto it = m_pending.constFind(reply);
+    if (it == m_pending.cend()) return false;
+
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    bool transient = false;
+    if (status != 0) {
+        transient = status == 429 || (status >= 500 && status != 501);
+    } else {
+        switch (reply->error()) {
+            case QNetworkReply::RemoteHostClosedError:
+            case QNetworkReply::TimeoutError:
+            case QNetworkReply::TemporaryNetworkFailureError:
+            case QNetworkReply::NetworkSessionFailedError:
+            case QNetworkReply::ProxyTimeoutError:
+            case QNetworkReply::UnknownNetworkError:
+                transient = true;
+                break;
+            default:
+                break;
+        }
+    }
+    if (!transient) return false;
+
+    PendingRequest pending = it.value();
+    if (pending.attempt >= codex::utils::Config::instance().quotaMaxRetries()) {
+        LOG_WARN(QString("ApiClient: %1 still failing after %2 retries, giving up")
+                 .arg(pending.quotaKey).arg(pending.attempt));
+        return false;
+    }
+    m_pending.remove(reply);
+
+    // Callers sharing a network reply each retry, but the queue and the
+    // limiter hear of the failure once
+    bool firstReport = true;
+    if (auto* shared = qobject_cast<SharedReply*>(reply)) {
+        firstReport = RequestQueue::instance().markRetried(shared->networkReply());
+    }
+    ++pending.attempt;
+
+    // Retry-After is in seconds for these APIs
+    const int retryAfterMs = reply->rawHeader("Retry-After").toInt() * 1000;
+    const int delay = RateLimiter::backoffDelay(pending.attempt, retryAfterMs);
+    if (status == 429 && firstReport) {
+        RateLimiter::instance().reportThrottled(pending.quotaKey, delay);
+    }
+
+    LOG_WARN(QString("ApiClient: %1 failed (%2), retry %3 in %4 ms")
+             .arg(pending.quotaKey)
+             .arg(status != 0 ? QString::number(status) : reply->errorString())
+             .arg(pending.attempt)
+             .arg(delay));
+    emit retryScheduled(pending.attempt, delay);
+
+    QTimer::singleShot(delay, this, [this, pending]() { send(pending); });
+    return true;
+}
+
 QNetworkRequest ApiClient::createRequest(const QString& endpoint) {
     QNetworkRequest request;
     request.setUrl(QUrl(m_baseUrl + endpoint));
@@ -71,9 +196,11 @@ QNetworkRequest ApiClient::createVertexRequest(const QString& model, const QStri
     return request;
 }
 
-void ApiClient::handleNetworkError(QNetworkReply* reply) {
+void ApiClient::handleNetworkError(QNetworkReply* reply, const QByteArray& body) {
+    if (scheduleRetry(reply)) return;
+
     QString errorMsg = reply->errorString();
-    QByteArray responseData = reply->readAll();
+    QByteArray responseData = body.isEmpty() ? reply->readAll() : body;
 
     if (!responseData.isEmpty()) {
         errorMsg += "\nResponse: " + QString::fromUtf8(responseData.left(500));
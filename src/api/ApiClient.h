@@ -1,10 +1,19 @@
 #pragma once
 
+#include "NetworkTransport.h"
+#include "RequestQueue.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
 #include <QObject>
-#include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QString>
 
+#include <functional>
+
+class QThreadPool;
+
 namespace codex::api {
 
 enum class GoogleAIProvider {
@@ -17,7 +26,7 @@ class ApiClient : public QObject {
 
 public:
     explicit ApiClient(QObject* parent = nullptr);
-    virtual ~ApiClient() = default;
+    virtual ~ApiClient();
 
     // API Key authentication (Google AI Studio)
     void setApiKey(const QString& key);
@@ -32,21 +41,55 @@ public:
     void setProvider(GoogleAIProvider provider);
     GoogleAIProvider provider() const { return m_provider; }
 
+    // Place of the next requests in the RequestQueue
+    void setTicket(const RequestTicket& ticket) { m_ticket = ticket; }
+    RequestTicket ticket() const { return m_ticket; }
+
+    // Next requests skip the ResponseCache lookup to get a fresh sample;
+    // the new response still replaces the cached one
+    void setCacheBypass(bool bypass) { m_cacheBypass = bypass; }
+    bool cacheBypass() const { return m_cacheBypass; }
+
     virtual bool isConfigured() const;
 
 signals:
     void requestStarted();
     void requestFinished();
     void errorOccurred(const QString& error);
+    // A transient error (429, 5xx, dropped connection) will be retried after delayMs
+    void retryScheduled(int attempt, int delayMs);
 
 protected:
+    // Connects a reply; runs again on the new reply of every retry
+    using ReplyHandler = std::function<void(QNetworkReply*)>;
+
+    // POSTs wait in the RequestQueue for a token of quotaKey() and are shared
+    // with identical POSTs in flight; both retry transient errors with backoff.
+    // A reply that is going to be retried still finishes, but handleNetworkError
+    // then reports nothing.
+    void sendPost(const QNetworkRequest& request, const QByteArray& body, const ReplyHandler& attach);
+    void sendGet(const QNetworkRequest& request, const ReplyHandler& attach);
+
+    // Rate limiter bucket, "provider/model"
+    virtual QString quotaKey() const;
+
+    // Hands the blobs cached under key to deliver on the next event loop
+    // turn, like a reply would; false when there is nothing cached or the
+    // cache is bypassed
+    using CacheHandler = std::function<void(const QList<QByteArray>&)>;
+    bool serveFromCache(const QByteArray& key, const CacheHandler& deliver);
+
     QNetworkRequest createRequest(const QString& endpoint);
     QNetworkRequest createVertexRequest(const QString& model, const QString& method);
-    void handleNetworkError(QNetworkReply* reply);
+    // body: reply content already consumed by a streaming parser, if any
+    void handleNetworkError(QNetworkReply* reply, const QByteArray& body = QByteArray());
+
+    // Worker pool for decoding large media replies off the GUI thread
+    static QThreadPool* decoderPool();
 
     QString getVertexBaseUrl() const;
 
-    QNetworkAccessManager* m_networkManager;
+    NetworkTransport* m_network;     // Shared by every client
     QString m_apiKey;
     QString m_accessToken;
     QString m_baseUrl;
@@ -55,6 +98,26 @@ protected:
     GoogleAIProvider m_provider = GoogleAIProvider::AIStudio;
     QString m_vertexProjectId;
     QString m_vertexRegion = "us-central1";
+
+    RequestTicket m_ticket;
+    bool m_cacheBypass = false;
+
+private:
+    struct PendingRequest {
+        QNetworkRequest request;
+        QByteArray body;
+        bool post = false;
+        QString quotaKey;
+        RequestTicket ticket;
+        ReplyHandler attach;
+        int attempt = 0;
+    };
+
+    void send(const PendingRequest& pending);
+    bool scheduleRetry(QNetworkReply* reply);
+
+    // Replies in flight, with what is needed to send them again
+    QHash<QNetworkReply*, PendingRequest> m_pending;
 };
 
 } // namespace codex::api
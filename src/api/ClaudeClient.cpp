@@ -35,12 +35,17 @@ void ClaudeClient::enrichPassage(const QString& prompt) {
     messages.append(message);
     body["messages"] = messages;
 
-    QNetworkReply* reply = m_networkManager->post(request, QJsonDocument(body).toJson());
-    connect(reply, &QNetworkReply::finished, this, [this, reply]() {
-        onReplyFinished(reply);
+    sendPost(request, QJsonDocument(body).toJson(), [this](QNetworkReply* reply) {
+        connect(reply, &QNetworkReply::finished, this, [this, reply]() {
+            onReplyFinished(reply);
+        });
     });
 }
 
+QString ClaudeClient::quotaKey() const {
+    return "claude/" + m_model;
+}
+
 void ClaudeClient::onReplyFinished(QNetworkReply* reply) {
     emit requestFinished();
 
@@ -59,9 +64,9 @@ void ClaudeClient::onReplyFinished(QNetworkReply* reply) {
     if (!content.isEmpty()) {
         QString text = content[0].toObject()["text"].toString();
 
-        // Try to parse as JSON (for structured responses)
+        // Try to parse as JSON object (for structured responses)
         QJsonDocument contentDoc = QJsonDocument::fromJson(text.toUtf8());
-        if (!contentDoc.isNull()) {
+        if (contentDoc.isObject()) {
             emit enrichmentCompleted(contentDoc.object());
         } else {
             // Return as plain text wrapped in JSON
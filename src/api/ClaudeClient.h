@@ -13,12 +13,18 @@ public:
 
     void enrichPassage(const QString& prompt);
 
+    void setMaxTokens(int maxTokens) { m_maxTokens = maxTokens; }
+    QString model() const { return m_model; }
+
 signals:
     void enrichmentCompleted(const QJsonObject& response);
 
 private slots:
     void onReplyFinished(QNetworkReply* reply);
 
+protected:
+    QString quotaKey() const override;
+
 private:
     QString m_model = "claude-sonnet-4-20250514";
     int m_maxTokens = 1000;
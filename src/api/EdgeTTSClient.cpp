@@ -1,9 +1,12 @@
 #include "EdgeTTSClient.h"
+#include "ResponseCache.h"
 #include "utils/Logger.h"
 
 #include <QFile>
 #include <QDir>
+#include <QJsonObject>
 #include <QStandardPaths>
+#include <QTimer>
 #include <QUuid>
 
 namespace codex::api {
@@ -60,7 +63,7 @@ void EdgeTTSClient::stop() {
     m_isGenerating = false;
 }
 
-void EdgeTTSClient::generateSpeech(const QString& text, const EdgeVoiceSettings& settings) {
+void EdgeTTSClient::generateSpeech(const QString& text, const EdgeVoiceSettings& settings, bool freshSample) {
     if (m_isGenerating) {
         emit errorOccurred("Une generation est deja en cours");
         return;
@@ -77,6 +80,26 @@ void EdgeTTSClient::generateSpeech(const QString& text, const EdgeVoiceSettings&
     emit requestStarted();
     emit generationProgress(5);
 
+    const QJsonObject cacheParameters{
+        {"rate", settings.rate}, {"pitch", settings.pitch}, {"volume", settings.volume}
+    };
+    m_cacheKey = ResponseCache::key("edge-tts", settings.voiceId, cacheParameters, text);
+    if (!freshSample) {
+        const QList<QByteArray> cached = ResponseCache::instance().lookup(m_cacheKey);
+        if (!cached.isEmpty()) {
+            LOG_INFO("EdgeTTS: answered from the response cache");
+            // Delivered on the next event loop turn, like the process output
+            QTimer::singleShot(0, this, [this, audioData = cached.first(), durationMs = estimateDuration(text)]() {
+                if (!m_isGenerating) return;    // Stopped meanwhile
+                m_isGenerating = false;
+                emit generationProgress(100);
+                emit requestFinished();
+                emit speechGenerated(audioData, durationMs);
+            });
+            return;
+        }
+    }
+
     // Clean up previous temp files
     if (!m_outputFilePath.isEmpty() && QFile::exists(m_outputFilePath)) {
         QFile::remove(m_outputFilePath);
@@ -182,6 +205,7 @@ void EdgeTTSClient::onProcessFinished(int exitCode, QProcess::ExitStatus exitSta
 
                 int durationMs = estimateDuration(m_currentText);
                 emit speechGenerated(audioData, durationMs);
+                ResponseCache::instance().store(m_cacheKey, {audioData});
 
                 LOG_INFO(QString("EdgeTTS: Generation complete, audio size: %1 bytes")
                          .arg(audioData.size()));
@@ -21,8 +21,10 @@ public:
     explicit EdgeTTSClient(QObject* parent = nullptr);
     ~EdgeTTSClient();
 
-    // Generate speech from text (returns MP3 audio data)
-    void generateSpeech(const QString& text, const EdgeVoiceSettings& settings = EdgeVoiceSettings());
+    // Generate speech from text (returns MP3 audio data). freshSample skips the
+    // ResponseCache lookup; the new take still replaces the cached one
+    void generateSpeech(const QString& text, const EdgeVoiceSettings& settings = EdgeVoiceSettings(),
+                        bool freshSample = false);
 
     // Stop current generation
     void stop();
@@ -53,6 +55,7 @@ private:
     QString m_outputFilePath;
     QString m_textFilePath;
     QString m_currentText;
+    QByteArray m_cacheKey;
     bool m_isGenerating = false;
 };
 
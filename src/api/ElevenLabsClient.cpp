@@ -1,4 +1,5 @@
 #include "ElevenLabsClient.h"
+#include "ResponseCache.h"
 #include "utils/Logger.h"
 
 #include <QJsonDocument>
@@ -39,9 +40,20 @@ void ElevenLabsClient::generateSpeech(const QString& text, const VoiceSettings&
     voiceSettings["speed"] = settings.speed;
     body["voice_settings"] = voiceSettings;
 
-    QNetworkReply* reply = m_networkManager->post(request, QJsonDocument(body).toJson());
-    connect(reply, &QNetworkReply::finished, this, [this, reply]() {
-        onSpeechReplyFinished(reply);
+    QJsonObject cacheParameters = voiceSettings;
+    cacheParameters["voice_id"] = settings.voiceId;
+    const QByteArray cacheKey = ResponseCache::key("elevenlabs", m_modelId, cacheParameters, text);
+    const bool cached = serveFromCache(cacheKey, [this](const QList<QByteArray>& blobs) {
+        emit requestFinished();
+        // Same rough estimate as for a network reply
+        emit speechGenerated(blobs.first(), blobs.first().size() / 32);
+    });
+    if (cached) return;
+
+    sendPost(request, QJsonDocument(body).toJson(), [this, cacheKey](QNetworkReply* reply) {
+        connect(reply, &QNetworkReply::finished, this, [this, reply, cacheKey]() {
+            onSpeechReplyFinished(reply, cacheKey);
+        });
     });
 }
 
@@ -56,13 +68,18 @@ void ElevenLabsClient::fetchAvailableVoices() {
     QNetworkRequest request = createRequest("/voices");
     request.setRawHeader("xi-api-key", m_apiKey.toUtf8());
 
-    QNetworkReply* reply = m_networkManager->get(request);
-    connect(reply, &QNetworkReply::finished, this, [this, reply]() {
-        onVoicesReplyFinished(reply);
+    sendGet(request, [this](QNetworkReply* reply) {
+        connect(reply, &QNetworkReply::finished, this, [this, reply]() {
+            onVoicesReplyFinished(reply);
+        });
     });
 }
 
-void ElevenLabsClient::onSpeechReplyFinished(QNetworkReply* reply) {
+QString ElevenLabsClient::quotaKey() const {
+    return "elevenlabs/" + m_modelId;
+}
+
+void ElevenLabsClient::onSpeechReplyFinished(QNetworkReply* reply, const QByteArray& cacheKey) {
     emit requestFinished();
 
     if (reply->error() != QNetworkReply::NoError) {
@@ -78,6 +95,9 @@ void ElevenLabsClient::onSpeechReplyFinished(QNetworkReply* reply) {
     int estimatedDurationMs = audioData.size() / 32; // Very rough estimate
 
     emit speechGenerated(audioData, estimatedDurationMs);
+    if (!audioData.isEmpty()) {
+        ResponseCache::instance().store(cacheKey, {audioData});
+    }
     reply->deleteLater();
 }
 
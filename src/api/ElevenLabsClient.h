@@ -27,9 +27,12 @@ signals:
     void voicesListReceived(const QJsonArray& voices);
 
 private slots:
-    void onSpeechReplyFinished(QNetworkReply* reply);
+    void onSpeechReplyFinished(QNetworkReply* reply, const QByteArray& cacheKey);
     void onVoicesReplyFinished(QNetworkReply* reply);
 
+protected:
+    QString quotaKey() const override;
+
 private:
     QString m_modelId = "eleven_multilingual_v2";
 };
@@ -1,4 +1,5 @@
 #include "GeminiClient.h"
+#include "ResponseCache.h"
 #include "utils/Logger.h"
 
 #include <QJsonDocument>
@@ -51,9 +52,11 @@ void GeminiClient::enrichPassage(const QString& prompt) {
     genConfig["temperature"] = 0.7;
     body["generationConfig"] = genConfig;
 
-    QNetworkReply* reply = m_networkManager->post(request, QJsonDocument(body).toJson());
-    connect(reply, &QNetworkReply::finished, this, [this, reply]() {
-        onEnrichReplyFinished(reply);
+    // Not in the ResponseCache: PipelineController keeps parsed scenes in the enrichment cache
+    sendPost(request, QJsonDocument(body).toJson(), [this](QNetworkReply* reply) {
+        connect(reply, &QNetworkReply::finished, this, [this, reply]() {
+            onEnrichReplyFinished(reply);
+        });
     });
 }
 
@@ -108,12 +111,24 @@ void GeminiClient::generateImagePrompt(const QString& passage, const QString& st
     genConfig["temperature"] = 0.8;
     body["generationConfig"] = genConfig;
 
-    QNetworkReply* reply = m_networkManager->post(request, QJsonDocument(body).toJson());
-    connect(reply, &QNetworkReply::finished, this, [this, reply]() {
-        onPromptReplyFinished(reply);
+    const QByteArray cacheKey = ResponseCache::key("gemini", m_model, genConfig, fullPrompt);
+    const bool cached = serveFromCache(cacheKey, [this](const QList<QByteArray>& blobs) {
+        emit requestFinished();
+        handlePromptResponse(blobs.first());
+    });
+    if (cached) return;
+
+    sendPost(request, QJsonDocument(body).toJson(), [this, cacheKey](QNetworkReply* reply) {
+        connect(reply, &QNetworkReply::finished, this, [this, reply, cacheKey]() {
+            onPromptReplyFinished(reply, cacheKey);
+        });
     });
 }
 
+QString GeminiClient::quotaKey() const {
+    return QString("%1/%2").arg(m_provider == GoogleAIProvider::VertexAI ? "vertex" : "aistudio", m_model);
+}
+
 void GeminiClient::onEnrichReplyFinished(QNetworkReply* reply) {
     emit requestFinished();
 
@@ -146,7 +161,7 @@ void GeminiClient::onEnrichReplyFinished(QNetworkReply* reply) {
     reply->deleteLater();
 }
 
-void GeminiClient::onPromptReplyFinished(QNetworkReply* reply) {
+void GeminiClient::onPromptReplyFinished(QNetworkReply* reply, const QByteArray& cacheKey) {
     emit requestFinished();
 
     if (reply->error() != QNetworkReply::NoError) {
@@ -156,24 +171,34 @@ void GeminiClient::onPromptReplyFinished(QNetworkReply* reply) {
     }
 
     QByteArray data = reply->readAll();
+    if (handlePromptResponse(data)) {
+        ResponseCache::instance().store(cacheKey, {data});
+    }
+
+    reply->deleteLater();
+}
+
+bool GeminiClient::handlePromptResponse(const QByteArray& data) {
     QJsonDocument doc = QJsonDocument::fromJson(data);
     QJsonObject response = doc.object();
 
     QJsonArray candidates = response["candidates"].toArray();
-    if (!candidates.isEmpty()) {
-        QJsonObject candidate = candidates[0].toObject();
-        QJsonObject content = candidate["content"].toObject();
-        QJsonArray parts = content["parts"].toArray();
-        if (!parts.isEmpty()) {
-            QString prompt = parts[0].toObject()["text"].toString().trimmed();
-            LOG_INFO(QString("Generated image prompt: %1").arg(prompt.left(100)));
-            emit imagePromptGenerated(prompt);
-        }
-    } else {
+    if (candidates.isEmpty()) {
         emit errorOccurred("No prompt generated from Gemini");
+        return false;
     }
 
-    reply->deleteLater();
+    QJsonObject candidate = candidates[0].toObject();
+    QJsonObject content = candidate["content"].toObject();
+    QJsonArray parts = content["parts"].toArray();
+    if (parts.isEmpty()) {
+        return false;
+    }
+
+    QString prompt = parts[0].toObject()["text"].toString().trimmed();
+    LOG_INFO(QString("Generated image prompt: %1").arg(prompt.left(100)));
+    emit imagePromptGenerated(prompt);
+    return true;
 }
 
 } // namespace codex::api
@@ -20,6 +20,7 @@ public:
     // Configuration
     void setModel(const QString& model) { m_model = model; }
     QString model() const { return m_model; }
+    void setMaxTokens(int maxTokens) { m_maxTokens = maxTokens; }
 
 signals:
     void enrichmentCompleted(const QJsonObject& response);
@@ -27,9 +28,15 @@ signals:
 
 private slots:
     void onEnrichReplyFinished(QNetworkReply* reply);
-    void onPromptReplyFinished(QNetworkReply* reply);
+    void onPromptReplyFinished(QNetworkReply* reply, const QByteArray& cacheKey);
+
+protected:
+    QString quotaKey() const override;
 
 private:
+    // Emits the image prompt of a response body, false when it has none
+    bool handlePromptResponse(const QByteArray& data);
+
     QString m_model = "gemini-2.0-flash";
     int m_maxTokens = 2048;
 };
@@ -1,13 +1,33 @@
 #include "ImagenClient.h"
+#include "MediaReplyParser.h"
+#include "ResponseCache.h"
 #include "utils/Logger.h"
 
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QBuffer>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentRun>
 
 namespace codex::api {
 
+namespace {
+
+// Runs on the decoder pool: PNG decoding of every sample
+QList<QImage> decodeSamples(const QList<QByteArray>& samples) {
+    QList<QImage> images;
+    for (const QByteArray& data : samples) {
+        QImage image;
+        if (!data.isEmpty() && image.loadFromData(data)) {
+            images.append(image);
+        }
+    }
+    return images;
+}
+
+} // namespace
+
 ImagenClient::ImagenClient(QObject* parent)
     : ApiClient(parent)
 {
@@ -28,6 +48,16 @@ void ImagenClient::generateImage(const ImageGenerationParams& params) {
     emit requestStarted();
     emit generationProgress(10);
 
+    const int sampleCount = qBound(1, params.numberOfImages, MAX_SAMPLES);
+
+    const QJsonObject cacheParameters{{"aspectRatio", params.aspectRatio}, {"sampleCount", sampleCount}};
+    const QByteArray cacheKey = ResponseCache::key("imagen", m_model, cacheParameters, params.prompt);
+    const bool cached = serveFromCache(cacheKey, [this, prompt = params.prompt](const QList<QByteArray>& samples) {
+        emit requestFinished();
+        decodeImages(samples, prompt, QByteArray());
+    });
+    if (cached) return;
+
     QNetworkRequest request;
     QJsonObject body;
     QString url;
@@ -45,7 +75,7 @@ void ImagenClient::generateImage(const ImageGenerationParams& params) {
 
         QJsonObject parameters;
         parameters["aspectRatio"] = params.aspectRatio;
-        parameters["sampleCount"] = params.numberOfImages;
+        parameters["sampleCount"] = sampleCount;
         body["parameters"] = parameters;
     } else {
         // AI Studio endpoint
@@ -55,71 +85,93 @@ void ImagenClient::generateImage(const ImageGenerationParams& params) {
 
         QJsonObject imageParams;
         imageParams["aspectRatio"] = params.aspectRatio;
-        imageParams["numberOfImages"] = params.numberOfImages;
+        imageParams["numberOfImages"] = sampleCount;
         body["imageGenerationConfig"] = imageParams;
     }
     request.setUrl(QUrl(url));
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
 
-    QNetworkReply* reply = m_networkManager->post(request, QJsonDocument(body).toJson());
-
-    connect(reply, &QNetworkReply::downloadProgress, this, [this](qint64 received, qint64 total) {
-        if (total > 0) {
-            int progress = 10 + static_cast<int>(80.0 * received / total);
-            emit generationProgress(progress);
-        }
+    sendPost(request, QJsonDocument(body).toJson(), [this, params, cacheKey, sampleCount](QNetworkReply* reply) {
+        // Samples are base64-decoded as the reply streams in, both providers use
+        // bytesBase64Encoded (predictions[i] on Vertex AI, images[i] on AI Studio)
+        auto* parser = new MediaReplyParser(reply, {"bytesBase64Encoded"}, sampleCount == 1);
+
+        connect(reply, &QNetworkReply::downloadProgress, this, [this](qint64 received, qint64 total) {
+            if (total > 0) {
+                int progress = 10 + static_cast<int>(80.0 * received / total);
+                emit generationProgress(progress);
+            }
+        });
+
+        connect(reply, &QNetworkReply::finished, this, [this, reply, parser, params, cacheKey]() {
+            onReplyFinished(reply, parser, params.prompt, cacheKey);
+        });
     });
+}
 
-    connect(reply, &QNetworkReply::finished, this, [this, reply, params]() {
-        onReplyFinished(reply, params.prompt);
-    });
+QString ImagenClient::quotaKey() const {
+    return QString("%1/%2").arg(m_provider == GoogleAIProvider::VertexAI ? "vertex" : "aistudio", m_model);
 }
 
-void ImagenClient::onReplyFinished(QNetworkReply* reply, const QString& originalPrompt) {
+void ImagenClient::onReplyFinished(QNetworkReply* reply, MediaReplyParser* parser, const QString& originalPrompt,
+                                  const QByteArray& cacheKey) {
     emit requestFinished();
-    emit generationProgress(100);
+    parser->finish();
 
     if (reply->error() != QNetworkReply::NoError) {
-        handleNetworkError(reply);
+        emit generationProgress(100);
+        handleNetworkError(reply, parser->skeleton());
         reply->deleteLater();
         return;
     }
 
-    QByteArray data = reply->readAll();
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    QJsonObject response = doc.object();
+    QList<QByteArray> samples = parser->takeMedia();
+    reply->deleteLater();
 
-    // Extract base64 image data - different format for AI Studio vs Vertex AI
-    QString base64Data;
+    decodeImages(samples, originalPrompt, cacheKey);
+}
 
-    if (m_provider == GoogleAIProvider::VertexAI) {
-        // Vertex AI response format: predictions[0].bytesBase64Encoded
-        QJsonArray predictions = response["predictions"].toArray();
-        if (!predictions.isEmpty()) {
-            base64Data = predictions[0].toObject()["bytesBase64Encoded"].toString();
-        }
-    } else {
-        // AI Studio response format: images[0].bytesBase64Encoded
-        QJsonArray images = response["images"].toArray();
-        if (!images.isEmpty()) {
-            base64Data = images[0].toObject()["bytesBase64Encoded"].toString();
+void ImagenClient::decodeImages(const QList<QByteArray>& samples, const QString& originalPrompt,
+                                const QByteArray& cacheKey) {
+    // Decode on the worker pool, the watcher dies with this client if the
+    // job is cancelled meanwhile
+    const int sampleCount = samples.size();
+    auto* watcher = new QFutureWatcher<QList<QImage>>(this);
+    connect(watcher, &QFutureWatcher<QList<QImage>>::finished, this,
+            [this, watcher, samples, sampleCount, originalPrompt, cacheKey]() {
+        QList<QImage> decoded = watcher->result();
+        watcher->deleteLater();
+
+        // Only replies whose samples all decode are worth serving again
+        if (!cacheKey.isEmpty() && sampleCount > 0 && decoded.size() == sampleCount) {
+            ResponseCache::instance().store(cacheKey, samples);
         }
+        emitDecodedImages(decoded, sampleCount, originalPrompt);
+    });
+    watcher->setFuture(QtConcurrent::run(decoderPool(), decodeSamples, samples));
+}
+
+void ImagenClient::emitDecodedImages(const QList<QImage>& decoded, int sampleCount, const QString& originalPrompt) {
+    emit generationProgress(100);
+
+    if (decoded.size() < sampleCount) {
+        LOG_WARN(QString("Imagen: %1 of %2 samples could not be decoded, skipping")
+                 .arg(sampleCount - decoded.size()).arg(sampleCount));
     }
 
-    if (!base64Data.isEmpty()) {
-        QByteArray imageData = QByteArray::fromBase64(base64Data.toUtf8());
+    // Only the QPixmap conversion has to happen on the GUI thread
+    QList<QPixmap> images;
+    for (const QImage& image : decoded) {
+        images.append(QPixmap::fromImage(image));
+    }
 
-        QPixmap pixmap;
-        if (pixmap.loadFromData(imageData)) {
-            emit imageGenerated(pixmap, originalPrompt);
-        } else {
-            emit errorOccurred("Failed to decode image data");
-        }
+    if (!images.isEmpty()) {
+        emit imagesGenerated(images, originalPrompt);
+    } else if (sampleCount > 0) {
+        emit errorOccurred("Failed to decode image data");
     } else {
         emit errorOccurred("No images in response");
     }
-
-    reply->deleteLater();
 }
 
 } // namespace codex::api
@@ -1,14 +1,18 @@
 #pragma once
 
 #include "ApiClient.h"
+#include <QImage>
+#include <QList>
 #include <QPixmap>
 
 namespace codex::api {
 
+class MediaReplyParser;
+
 struct ImageGenerationParams {
     QString prompt;
     QString aspectRatio = "16:9";
-    int numberOfImages = 1;
+    int numberOfImages = 1;     // 1 to MAX_SAMPLES per request
 };
 
 class ImagenClient : public ApiClient {
@@ -17,19 +21,29 @@ class ImagenClient : public ApiClient {
 public:
     explicit ImagenClient(QObject* parent = nullptr);
 
+    // Imagen returns at most 4 samples per request
+    static constexpr int MAX_SAMPLES = 4;
+
     void generateImage(const ImageGenerationParams& params);
 
     // Override: ImagenClient uses API key for both providers
     bool isConfigured() const override;
 
+protected:
+    QString quotaKey() const override;
+
 signals:
-    void imageGenerated(const QPixmap& image, const QString& prompt);
+    // All samples decoded from one request (at least one)
+    void imagesGenerated(const QList<QPixmap>& images, const QString& prompt);
     void generationProgress(int percent);
 
-private slots:
-    void onReplyFinished(QNetworkReply* reply, const QString& originalPrompt);
-
 private:
+    void onReplyFinished(QNetworkReply* reply, MediaReplyParser* parser, const QString& originalPrompt,
+                         const QByteArray& cacheKey);
+    // cacheKey: where to store the samples once decoded, empty when they come from the cache
+    void decodeImages(const QList<QByteArray>& samples, const QString& originalPrompt, const QByteArray& cacheKey);
+    void emitDecodedImages(const QList<QImage>& decoded, int sampleCount, const QString& originalPrompt);
+
     QString m_model = "imagen-3.0-generate-001";
 };
 
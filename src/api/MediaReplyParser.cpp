@@ -0,0 +1,152 @@
+#include "MediaReplyParser.h"
+#include "utils/Logger.h"
+
+#include <QJsonDocument>
+#include <QNetworkReply>
+
+namespace codex::api {
+
+namespace {
+
+// Decode in blocks so the pending buffer stays small
+constexpr int BASE64_BLOCK = 64 * 1024;
+
+bool isJsonWhitespace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+} // namespace
+
+MediaReplyParser::MediaReplyParser(QNetworkReply* reply, const QStringList& mediaFields, bool singleMedia)
+    : QObject(reply)
+    , m_reply(reply)
+    , m_mediaFields(mediaFields)
+    , m_singleMedia(singleMedia)
+{
+    for (const QString& field : mediaFields) {
+        m_maxFieldLength = qMax(m_maxFieldLength, static_cast<int>(field.size()));
+    }
+    m_pendingBase64.reserve(BASE64_BLOCK + 4);
+
+    connect(reply, &QNetworkReply::readyRead, this, [this]() {
+        feed(m_reply->readAll());
+    });
+}
+
+void MediaReplyParser::finish() {
+    feed(m_reply->readAll());
+
+    // Truncated reply: keep what was decoded so far
+    if (m_state == State::InMedia) {
+        LOG_WARN("MediaReplyParser: reply ended inside a media field");
+        flushBase64(true);
+        m_state = State::Outside;
+    }
+}
+
+QJsonObject MediaReplyParser::document() const {
+    return QJsonDocument::fromJson(m_skeleton).object();
+}
+
+QList<QByteArray> MediaReplyParser::takeMedia() {
+    QList<QByteArray> media;
+    media.swap(m_media);
+    return media;
+}
+
+void MediaReplyParser::feed(const QByteArray& chunk) {
+    const char* data = chunk.constData();
+    const qsizetype size = chunk.size();
+
+    for (qsizetype i = 0; i < size; ++i) {
+        const char c = data[i];
+
+        switch (m_state) {
+        case State::Outside:
+            m_skeleton.append(c);
+            if (c == '"') {
+                m_state = State::InString;
+                m_currentString.clear();
+                m_stringTooLong = false;
+            }
+            break;
+
+        case State::InString:
+            m_skeleton.append(c);
+            if (m_escape) {
+                m_escape = false;
+                m_stringTooLong = true;     // field names never contain escapes
+            } else if (c == '\\') {
+                m_escape = true;
+            } else if (c == '"') {
+                bool isField = !m_stringTooLong
+                    && m_mediaFields.contains(QString::fromLatin1(m_currentString));
+                m_state = isField ? State::ExpectColon : State::Outside;
+            } else if (!m_stringTooLong) {
+                if (m_currentString.size() < m_maxFieldLength) {
+                    m_currentString.append(c);
+                } else {
+                    m_stringTooLong = true;
+                }
+            }
+            break;
+
+        case State::ExpectColon:
+            m_skeleton.append(c);
+            if (c == ':') {
+                m_state = State::ExpectValue;
+            } else if (!isJsonWhitespace(c)) {
+                // The string was a value, not a key
+                m_state = (c == '"') ? State::InString : State::Outside;
+                m_currentString.clear();
+                m_stringTooLong = false;
+            }
+            break;
+
+        case State::ExpectValue:
+            m_skeleton.append(c);
+            if (c == '"') {
+                m_state = State::InMedia;
+                m_media.append(QByteArray());
+                // The only media field makes up nearly the whole reply; with
+                // several samples the reply size says nothing about each one
+                if (m_singleMedia && m_media.size() == 1) {
+                    const qint64 total = m_reply->header(QNetworkRequest::ContentLengthHeader).toLongLong();
+                    if (total > 0) m_media.last().reserve(total * 3 / 4);
+                }
+            } else if (!isJsonWhitespace(c)) {
+                // Object or other non-string value: nothing to decode
+                m_state = State::Outside;
+            }
+            break;
+
+        case State::InMedia:
+            if (m_escape) {
+                m_escape = false;
+                if (c == '/') m_pendingBase64.append(c);   // "\/" is a legal escape
+            } else if (c == '\\') {
+                m_escape = true;
+            } else if (c == '"') {
+                flushBase64(true);
+                m_skeleton.append(c);
+                m_state = State::Outside;
+            } else if (!isJsonWhitespace(c)) {
+                m_pendingBase64.append(c);
+                if (m_pendingBase64.size() >= BASE64_BLOCK) flushBase64(false);
+            }
+            break;
+        }
+    }
+}
+
+void MediaReplyParser::flushBase64(bool final) {
+    // Only whole 4-character quanta can be decoded before the end of the value
+    qsizetype usable = final ? m_pendingBase64.size() : (m_pendingBase64.size() / 4) * 4;
+    if (usable == 0) return;
+
+    m_media.last().append(QByteArray::fromBase64(
+        QByteArray::fromRawData(m_pendingBase64.constData(), usable)));
+    m_pendingBase64.remove(0, usable);
+}
+
+} // namespace codex::api
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QJsonObject>
+#include <QList>
+#include <QStringList>
+
+class QNetworkReply;
+
+namespace codex::api {
+
+// Incremental parser for JSON replies carrying base64 media (Imagen images,
+// Veo videos). Chunks are consumed as they arrive on readyRead: string values
+// of the media fields are base64-decoded straight into their output buffer and
+// everything else is kept as a small "skeleton" JSON in which those values are
+// empty strings. Peak memory stays at about one copy of the decoded media.
+class MediaReplyParser : public QObject {
+    Q_OBJECT
+
+public:
+    // Attaches to the reply and is deleted with it. singleMedia: the reply
+    // carries one media field, whose buffer is then sized from Content-Length
+    MediaReplyParser(QNetworkReply* reply, const QStringList& mediaFields, bool singleMedia = false);
+
+    // Reads whatever is left in the reply; call from the finished handler
+    void finish();
+
+    // Reply JSON without the media payloads
+    const QByteArray& skeleton() const { return m_skeleton; }
+    QJsonObject document() const;
+
+    // Decoded media in order of appearance in the reply
+    QList<QByteArray> takeMedia();
+    int mediaCount() const { return m_media.size(); }
+
+private:
+    enum class State {
+        Outside,        // JSON structure, copied to the skeleton
+        InString,       // ordinary string, copied to the skeleton
+        ExpectColon,    // a media field name just closed
+        ExpectValue,    // after the colon of a media field
+        InMedia         // inside a media string value, decoded
+    };
+
+    void feed(const QByteArray& chunk);
+    void flushBase64(bool final);
+
+    QNetworkReply* m_reply;
+    QStringList m_mediaFields;
+    int m_maxFieldLength = 0;
+    bool m_singleMedia;
+
+    State m_state = State::Outside;
+    bool m_escape = false;
+    QByteArray m_currentString;     // key candidate, bounded by m_maxFieldLength
+    bool m_stringTooLong = false;
+
+    QByteArray m_pendingBase64;     // characters not yet forming a full quantum
+    QByteArray m_skeleton;
+    QList<QByteArray> m_media;
+};
+
+} // namespace codex::api
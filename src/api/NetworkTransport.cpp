@@ -0,0 +1,77 @@
+#include "NetworkTransport.h"
+#include "utils/Logger.h"
+
+#include <QHttp1Configuration>
+
+namespace codex::api {
+
+namespace {
+
+// Set on a reply once it has opened its own connection
+constexpr char NEW_CONNECTION_PROPERTY[] = "codexNewConnection";
+
+} // namespace
+
+NetworkTransport& NetworkTransport::instance() {
+    // Never destroyed: the manager must not outlive the application object
+    // in a static destructor, and its connections close with the process
+    static NetworkTransport* transport = new NetworkTransport();
+    return *transport;
+}
+
+NetworkTransport::NetworkTransport()
+    : m_manager(new QNetworkAccessManager(this))
+{
+}
+
+QNetworkReply* NetworkTransport::get(QNetworkRequest request) {
+    prepare(request);
+    return track(m_manager->get(request));
+}
+
+QNetworkReply* NetworkTransport::post(QNetworkRequest request, const QByteArray& data) {
+    prepare(request);
+    return track(m_manager->post(request, data));
+}
+
+void NetworkTransport::prepare(QNetworkRequest& request) const {
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+    request.setAttribute(QNetworkRequest::ConnectionCacheExpiryTimeoutSecondsAttribute, KEEP_ALIVE_SECONDS);
+
+    QHttp1Configuration http1;
+    http1.setNumberOfConnectionsPerHost(MAX_CONNECTIONS_PER_HOST);
+    request.setHttp1Configuration(http1);
+}
+
+QNetworkReply* NetworkTransport::track(QNetworkReply* reply) {
+    ++m_stats.requests;
+
+    connect(reply, &QNetworkReply::socketStartedConnecting, this, [this, reply]() {
+        reply->setProperty(NEW_CONNECTION_PROPERTY, true);
+        ++m_stats.newConnections;
+        LOG_INFO(QString("Network: New connection to %1 (%2 opened, %3 reused)")
+                 .arg(reply->url().host())
+                 .arg(m_stats.newConnections)
+                 .arg(m_stats.reusedConnections));
+    });
+
+    connect(reply, &QNetworkReply::encrypted, this, [this]() {
+        ++m_stats.tlsHandshakes;
+    });
+
+    connect(reply, &QNetworkReply::finished, this, [this, reply]() {
+        // Replies that never reached the server (DNS, refused) count as neither
+        const bool answered = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).isValid();
+        if (answered && !reply->property(NEW_CONNECTION_PROPERTY).toBool()) {
+            ++m_stats.reusedConnections;
+        }
+        if (reply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool()) {
+            ++m_stats.http2Replies;
+        }
+        emit statsChanged();
+    });
+
+    return reply;
+}
+
+} // namespace codex::api
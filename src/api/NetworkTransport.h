@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QObject>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+
+namespace codex::api {
+
+// Connection counters since startup
+struct TransportStats {
+    quint64 requests = 0;           // Requests sent
+    quint64 newConnections = 0;     // Replies that had to open a connection
+    quint64 tlsHandshakes = 0;      // Full TLS handshakes among them
+    quint64 reusedConnections = 0;  // Replies served on an already open connection
+    quint64 http2Replies = 0;       // Replies multiplexed over HTTP/2
+};
+
+// One network access manager for every client and dialog, so connections to
+// the Google, Anthropic and ElevenLabs hosts are opened once and then reused.
+// HTTP/2 is requested everywhere; hosts that fall back to HTTP/1.1 get
+// keep-alive and at most MAX_CONNECTIONS_PER_HOST parallel connections.
+// Lives on the GUI thread, like the clients that use it.
+class NetworkTransport : public QObject {
+    Q_OBJECT
+
+public:
+    static NetworkTransport& instance();
+
+    QNetworkReply* get(QNetworkRequest request);
+    QNetworkReply* post(QNetworkRequest request, const QByteArray& data);
+
+    TransportStats stats() const { return m_stats; }
+
+    static constexpr int MAX_CONNECTIONS_PER_HOST = 4;
+    static constexpr int KEEP_ALIVE_SECONDS = 180;
+
+signals:
+    void statsChanged();
+
+private:
+    NetworkTransport();
+
+    void prepare(QNetworkRequest& request) const;
+    QNetworkReply* track(QNetworkReply* reply);
+
+    QNetworkAccessManager* m_manager;
+    TransportStats m_stats;
+};
+
+} // namespace codex::api
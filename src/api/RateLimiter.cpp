@@ -0,0 +1,98 @@
+#include "RateLimiter.h"
+#include "utils/Config.h"
+#include "utils/Logger.h"
+
+#include <QRandomGenerator>
+
+#include <cmath>
+
+namespace codex::api {
+
+RateLimiter& RateLimiter::instance() {
+    // Never destroyed, like the transport
+    static RateLimiter* limiter = new RateLimiter();
+    return *limiter;
+}
+
+RateLimiter::RateLimiter() {
+    m_clock.start();
+}
+
+RateLimiter::Bucket& RateLimiter::bucket(const QString& key) {
+    auto& config = codex::utils::Config::instance();
+    const double quotaPerMs = config.quotaRequestsPerMinute(key) / 60000.0;
+    const double capacity = config.quotaBurst(key);
+
+    auto it = m_buckets.find(key);
+    if (it == m_buckets.end()) {
+        Bucket fresh;
+        fresh.ratePerMs = quotaPerMs;
+        fresh.tokens = capacity;
+        fresh.lastRefill = m_clock.elapsed();
+        it = m_buckets.insert(key, fresh);
+    }
+
+    // Quotas are read again on every use so that edits apply without a restart
+    Bucket& b = it.value();
+    b.quotaPerMs = quotaPerMs;
+    b.ratePerMs = qMin(b.ratePerMs, quotaPerMs);
+    b.capacity = capacity;
+    b.tokens = qMin(b.tokens, capacity);
+    return b;
+}
+
+void RateLimiter::refill(Bucket& b, qint64 now) const {
+    // Nothing accumulates while the bucket is held after a 429
+    const qint64 from = qMax(b.lastRefill, b.heldUntil);
+    if (now > from) {
+        b.tokens = qMin(b.capacity, b.tokens + (now - from) * b.ratePerMs);
+    }
+    b.lastRefill = qMax(b.lastRefill, now);
+}
+
+qint64 RateLimiter::tryAcquire(const QString& key) {
+    Bucket& b = bucket(key);
+    const qint64 now = m_clock.elapsed();
+    refill(b, now);
+
+    if (now < b.heldUntil) {
+        return b.heldUntil - now;
+    }
+    if (b.tokens < 1.0) {
+        return qMax<qint64>(1, qint64(std::ceil((1.0 - b.tokens) / b.ratePerMs)));
+    }
+
+    b.tokens -= 1.0;
+    return 0;
+}
+
+void RateLimiter::reportSuccess(const QString& key) {
+    Bucket& b = bucket(key);
+    b.ratePerMs = qMin(b.quotaPerMs, b.ratePerMs + b.quotaPerMs / 10.0);
+}
+
+void RateLimiter::reportThrottled(const QString& key, int holdMs) {
+    Bucket& b = bucket(key);
+    const qint64 now = m_clock.elapsed();
+    refill(b, now);
+
+    b.ratePerMs = qMax(b.quotaPerMs / 8.0, b.ratePerMs / 2.0);
+    b.tokens = 0.0;
+    b.heldUntil = qMax(b.heldUntil, now + holdMs);
+
+    LOG_WARN(QString("RateLimiter: %1 throttled, holding %2 ms, rate now %3/min")
+             .arg(key)
+             .arg(holdMs)
+             .arg(b.ratePerMs * 60000.0, 0, 'f', 1));
+}
+
+int RateLimiter::backoffDelay(int attempt, int retryAfterMs) {
+    const int ceiling = qMin(BACKOFF_MAX_MS, BACKOFF_BASE_MS << qBound(0, attempt - 1, 6));
+
+    // Jitter over the upper half of the window spreads out the retries of a
+    // burst that failed together
+    const int delay = ceiling / 2 + int(QRandomGenerator::global()->bounded(ceiling / 2 + 1));
+    return qMax(delay, retryAfterMs);
+}
+
+} // namespace codex::api
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QString>
+
+namespace codex::api {
+
+// Token bucket per "provider/model" key, shared by every client. The bucket
+// refills at the quota from Config and holds a few requests of burst; a 429
+// halves the current rate and holds the bucket for the backoff delay, each
+// success then climbs back towards the quota. The RequestQueue decides which
+// request gets the next token. Lives on the GUI thread.
+class RateLimiter {
+public:
+    static RateLimiter& instance();
+
+    // Takes a token from the bucket of key and returns 0, or returns the
+    // milliseconds until one is available without taking anything
+    qint64 tryAcquire(const QString& key);
+
+    // Feedback from the replies
+    void reportSuccess(const QString& key);
+    void reportThrottled(const QString& key, int holdMs);
+
+    // Exponential backoff with jitter for the given retry (1 for the first),
+    // never shorter than the server's Retry-After
+    static int backoffDelay(int attempt, int retryAfterMs = 0);
+
+    static constexpr int BACKOFF_BASE_MS = 1000;
+    static constexpr int BACKOFF_MAX_MS = 60000;
+
+private:
+    struct Bucket {
+        double quotaPerMs = 0.0;    // Configured rate
+        double ratePerMs = 0.0;     // Current rate, lowered after a 429
+        double capacity = 1.0;      // Burst
+        double tokens = 1.0;
+        qint64 lastRefill = 0;
+        qint64 heldUntil = 0;
+    };
+
+    RateLimiter();
+
+    Bucket& bucket(const QString& key);
+    void refill(Bucket& bucket, qint64 now) const;
+
+    QHash<QString, Bucket> m_buckets;
+    QElapsedTimer m_clock;
+};
+
+} // namespace codex::api
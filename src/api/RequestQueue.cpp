@@ -0,0 +1,140 @@
+#include "RequestQueue.h"
+#include "RateLimiter.h"
+
+#include <QTimer>
+
+#include <algorithm>
+#include <climits>
+#include <tuple>
+
+namespace codex::api {
+
+RequestQueue& RequestQueue::instance() {
+    // Never destroyed, like the transport
+    static RequestQueue* queue = new RequestQueue();
+    return *queue;
+}
+
+RequestQueue::RequestQueue()
+    : m_timer(new QTimer(this))
+{
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &RequestQueue::dispatch);
+}
+
+void RequestQueue::submit(const QString& key, const RequestTicket& ticket, QObject* context,
+                          std::function<QNetworkReply*()> start) {
+    m_waiting.append({m_nextSequence++, key, ticket, context, std::move(start)});
+    dispatch();
+}
+
+void RequestQueue::setFocus(const QString& session, int panel) {
+    if (panel < 0) {
+        m_focus.remove(session);
+    } else {
+        m_focus.insert(session, panel);
+    }
+    dispatch();
+}
+
+bool RequestQueue::markRetried(QNetworkReply* reply) {
+    if (!reply || m_retried.contains(reply)) return false;
+
+    m_retried.insert(reply);
+    return true;
+}
+
+int RequestQueue::focusDistance(const Entry& entry) const {
+    const auto it = m_focus.constFind(entry.ticket.session);
+    if (it == m_focus.cend() || entry.ticket.panel < 0) return INT_MAX;
+
+    // The viewer moves forward: panels after the focused one come next,
+    // the ones already passed last
+    const int panel = entry.ticket.panel;
+    return panel >= *it ? panel - *it : INT_MAX / 2 + panel;
+}
+
+bool RequestQueue::before(const Entry& a, const Entry& b) const {
+    auto rank = [this](const Entry& e) {
+        const int distance = focusDistance(e);
+        return std::make_tuple(int(e.ticket.priority),
+                               distance != 0,
+                               m_runningBySession.value(e.ticket.session),
+                               m_lastServed.value(e.ticket.session),
+                               e.ticket.session,
+                               distance,
+                               e.sequence);
+    };
+    return rank(a) < rank(b);
+}
+
+void RequestQueue::dispatch() {
+    m_waiting.removeIf([](const Entry& entry) { return entry.context.isNull(); });
+
+    // Forget the turn of sessions with nothing queued or running, so that
+    // finished sessions do not pile up
+    QSet<QString> active;
+    for (const Entry& entry : std::as_const(m_waiting)) {
+        active.insert(entry.ticket.session);
+    }
+    m_lastServed.removeIf([this, &active](const QHash<QString, quint64>::iterator it) {
+        return !active.contains(it.key()) && !m_runningBySession.contains(it.key());
+    });
+
+    // Keys without a token are skipped for the rest of the pass, so that a
+    // less urgent request of the same key cannot overtake
+    QSet<QString> held;
+    qint64 wait = -1;
+
+    bool started = true;
+    while (started) {
+        started = false;
+        std::stable_sort(m_waiting.begin(), m_waiting.end(),
+                         [this](const Entry& a, const Entry& b) { return before(a, b); });
+
+        for (qsizetype i = 0; i < m_waiting.size(); ++i) {
+            const QString key = m_waiting[i].key;
+            if (held.contains(key)) continue;
+
+            const qint64 ms = RateLimiter::instance().tryAcquire(key);
+            if (ms > 0) {
+                held.insert(key);
+                wait = wait < 0 ? ms : qMin(wait, ms);
+                continue;
+            }
+
+            // Fairness counters change with every start: sort again
+            run(m_waiting.takeAt(i));
+            started = true;
+            break;
+        }
+    }
+
+    if (wait > 0) {
+        m_timer->start(int(qMin<qint64>(wait, RateLimiter::BACKOFF_MAX_MS)));
+    }
+    emit countsChanged(queuedCount(), m_running, m_done);
+}
+
+void RequestQueue::run(Entry entry) {
+    const QString session = entry.ticket.session;
+    ++m_running;
+    ++m_runningBySession[session];
+    m_lastServed.insert(session, ++m_dispatchCount);
+
+    QNetworkReply* reply = entry.start();
+
+    // The client deletes its reply once handled, or aborts it when destroyed
+    connect(reply, &QObject::destroyed, this, [this, reply, session]() {
+        --m_running;
+        if (--m_runningBySession[session] <= 0) {
+            m_runningBySession.remove(session);
+        }
+        if (!m_retried.remove(reply)) {
+            ++m_done;
+        }
+        dispatch();
+    });
+}
+
+} // namespace codex::api
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QNetworkReply>
+#include <QObject>
+#include <QPointer>
+#include <QSet>
+#include <QString>
+
+#include <functional>
+
+class QTimer;
+
+namespace codex::api {
+
+enum class RequestPriority {
+    Interactive,    // The user waits on this one (preview, single image)
+    Batch           // Plates, video and audio batches
+};
+
+// Who a request is for, orders the queue
+struct RequestTicket {
+    RequestPriority priority = RequestPriority::Interactive;
+    QString session;    // Work session, sessions share the quota fairly
+    int panel = -1;     // Plate panel or slide of the session, -1 when none
+};
+
+// Central queue of the generation requests (image, LLM, TTS and video).
+// Waiting requests leave in this order: interactive before batch, the panel
+// on screen before the others, then the session with the fewest requests
+// running (the least recently served on a tie), then from the focused panel
+// onwards within the session, then first come first served. A request only
+// leaves when the RateLimiter has a token for its key; a request held by its
+// key does not hold back the requests of other keys. Lives on the GUI thread.
+class RequestQueue : public QObject {
+    Q_OBJECT
+
+public:
+    static RequestQueue& instance();
+
+    // start sends the request once its turn comes and returns the reply.
+    // Dropped if context is destroyed while waiting.
+    void submit(const QString& key, const RequestTicket& ticket, QObject* context,
+                std::function<QNetworkReply*()> start);
+
+    // Panel on screen for a session, -1 to clear
+    void setFocus(const QString& session, int panel);
+
+    // Reply that finished only to be sent again: not counted as done.
+    // False when already marked, by another caller sharing it.
+    bool markRetried(QNetworkReply* reply);
+
+    int queuedCount() const { return int(m_waiting.size()); }
+    int runningCount() const { return m_running; }
+    int doneCount() const { return m_done; }
+
+signals:
+    void countsChanged(int queued, int running, int done);
+
+private:
+    struct Entry {
+        quint64 sequence = 0;
+        QString key;
+        RequestTicket ticket;
+        QPointer<QObject> context;
+        std::function<QNetworkReply*()> start;
+    };
+
+    RequestQueue();
+
+    bool before(const Entry& a, const Entry& b) const;
+    int focusDistance(const Entry& entry) const;
+    void dispatch();
+    void run(Entry entry);
+
+    QList<Entry> m_waiting;
+    QHash<QString, int> m_focus;                // session -> panel on screen
+    QHash<QString, int> m_runningBySession;
+    QHash<QString, quint64> m_lastServed;       // session -> dispatch number
+    QSet<QNetworkReply*> m_retried;
+    quint64 m_nextSequence = 0;
+    quint64 m_dispatchCount = 0;
+    int m_running = 0;
+    int m_done = 0;
+    QTimer* m_timer;
+};
+
+} // namespace codex::api
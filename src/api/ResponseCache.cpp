@@ -0,0 +1,261 @@
+#include "ResponseCache.h"
+#include "utils/Config.h"
+#include "utils/Logger.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTimer>
+
+#include <algorithm>
+
+namespace codex::api {
+
+namespace {
+
+// Index file: bump the version whenever the format changes
+constexpr quint32 CACHE_MAGIC = 0x43445243;    // "CDRC"
+constexpr quint32 CACHE_VERSION = 1;
+
+// Index saves are grouped, never one per response
+constexpr int SAVE_DELAY_MS = 5000;
+
+} // namespace
+
+ResponseCache& ResponseCache::instance() {
+    // Never destroyed, like the transport
+    static ResponseCache* cache = new ResponseCache();
+    return *cache;
+}
+
+ResponseCache::ResponseCache()
+    : m_saveTimer(new QTimer(this))
+{
+    m_directory = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/responses";
+    QDir().mkpath(m_directory + "/blobs");
+
+    m_saveTimer->setSingleShot(true);
+    m_saveTimer->setInterval(SAVE_DELAY_MS);
+    connect(m_saveTimer, &QTimer::timeout, this, &ResponseCache::save);
+
+    if (auto* app = QCoreApplication::instance()) {
+        connect(app, &QCoreApplication::aboutToQuit, this, [this]() {
+            if (m_dirty) save();
+        });
+    }
+
+    if (load()) {
+        LOG_INFO(QString("ResponseCache: %1 entries, %2 MB")
+                 .arg(m_entries.size())
+                 .arg(m_totalBytes / (1024.0 * 1024.0), 0, 'f', 1));
+    }
+}
+
+QByteArray ResponseCache::key(const QString& provider, const QString& model,
+                              const QJsonObject& parameters, const QString& prompt) {
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(provider.toUtf8());
+    hash.addData("\n");
+    hash.addData(model.toUtf8());
+    hash.addData("\n");
+    // QJsonObject keeps its keys sorted: same parameters, same bytes
+    hash.addData(QJsonDocument(parameters).toJson(QJsonDocument::Compact));
+    hash.addData("\n");
+    hash.addData(QCryptographicHash::hash(prompt.toUtf8(), QCryptographicHash::Sha256));
+    return hash.result();
+}
+
+QList<QByteArray> ResponseCache::lookup(const QByteArray& key) {
+    if (!codex::utils::Config::instance().responseCacheEnabled()) return {};
+
+    const auto it = m_entries.find(key);
+    if (it == m_entries.end()) return {};
+
+    QList<QByteArray> blobs;
+    for (const QByteArray& hash : std::as_const(it->blobs)) {
+        QFile file(blobPath(hash));
+        if (!file.open(QIODevice::ReadOnly) || file.size() != m_blobSizes.value(hash)) {
+            // Removed or truncated outside the application
+            LOG_WARN(QString("ResponseCache: blob %1 missing, dropping its entry")
+                     .arg(QString::fromLatin1(hash.toHex().left(12))));
+            const Entry entry = it.value();
+            m_entries.erase(it);
+            release(entry);
+            scheduleSave();
+            return {};
+        }
+        blobs.append(file.readAll());
+    }
+
+    it->lastUsed = ++m_clock;
+    scheduleSave();
+    return blobs;
+}
+
+void ResponseCache::store(const QByteArray& key, const QList<QByteArray>& blobs) {
+    auto& config = codex::utils::Config::instance();
+    if (!config.responseCacheEnabled() || blobs.isEmpty()) return;
+
+    Entry entry;
+    entry.lastUsed = ++m_clock;
+    for (const QByteArray& data : blobs) {
+        const QByteArray hash = QCryptographicHash::hash(data, QCryptographicHash::Sha256);
+        if (!m_blobRefs.contains(hash)) {
+            if (!writeBlob(hash, data)) {
+                LOG_WARN(QString("ResponseCache: could not write %1").arg(blobPath(hash)));
+                release(entry);
+                return;
+            }
+            m_blobSizes.insert(hash, data.size());
+            m_totalBytes += data.size();
+        }
+        ++m_blobRefs[hash];
+        entry.blobs.append(hash);
+    }
+
+    // The new references are taken first, so blobs shared with the entry
+    // being replaced stay on disk
+    const auto previous = m_entries.constFind(key);
+    if (previous != m_entries.cend()) {
+        release(previous.value());
+    }
+    m_entries.insert(key, entry);
+
+    evict(qint64(config.responseCacheMaxMb()) * 1024 * 1024);
+    scheduleSave();
+}
+
+QString ResponseCache::blobPath(const QByteArray& hash) const {
+    const QString hex = QString::fromLatin1(hash.toHex());
+    return QString("%1/blobs/%2/%3").arg(m_directory, hex.left(2), hex);
+}
+
+bool ResponseCache::writeBlob(const QByteArray& hash, const QByteArray& data) {
+    const QString path = blobPath(hash);
+    QDir().mkpath(QFileInfo(path).path());
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    return file.write(data) == data.size() && file.commit();
+}
+
+void ResponseCache::release(const Entry& entry) {
+    for (const QByteArray& hash : entry.blobs) {
+        const auto ref = m_blobRefs.find(hash);
+        if (ref == m_blobRefs.end() || --ref.value() > 0) continue;
+
+        m_blobRefs.erase(ref);
+        m_totalBytes -= m_blobSizes.take(hash);
+        QFile::remove(blobPath(hash));
+    }
+}
+
+void ResponseCache::evict(qint64 maxBytes) {
+    if (m_totalBytes <= maxBytes) return;
+
+    QList<QPair<quint64, QByteArray>> order;
+    order.reserve(m_entries.size());
+    for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it) {
+        order.append({it->lastUsed, it.key()});
+    }
+    std::sort(order.begin(), order.end());
+
+    int evicted = 0;
+    for (const auto& [lastUsed, key] : std::as_const(order)) {
+        if (m_totalBytes <= maxBytes) break;
+        release(m_entries.take(key));
+        ++evicted;
+    }
+
+    LOG_INFO(QString("ResponseCache: evicted %1 entries, %2 MB left")
+             .arg(evicted)
+             .arg(m_totalBytes / (1024.0 * 1024.0), 0, 'f', 1));
+}
+
+bool ResponseCache::load() {
+    QFile file(m_directory + "/index.bin");
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_5);
+
+    quint32 magic = 0, version = 0;
+    in >> magic >> version;
+    if (in.status() != QDataStream::Ok || magic != CACHE_MAGIC || version != CACHE_VERSION) {
+        return false;
+    }
+
+    quint64 clock = 0;
+    QList<QByteArray> keys;
+    QList<quint64> lastUsed;
+    QList<QList<QByteArray>> blobs;
+    QHash<QByteArray, qint64> sizes;
+    in >> clock >> keys >> lastUsed >> blobs >> sizes;
+    if (in.status() != QDataStream::Ok
+        || lastUsed.size() != keys.size() || blobs.size() != keys.size()) {
+        return false;
+    }
+
+    for (qsizetype i = 0; i < keys.size(); ++i) {
+        const bool complete = std::all_of(blobs[i].cbegin(), blobs[i].cend(),
+                                          [&sizes](const QByteArray& hash) { return sizes.contains(hash); });
+        if (!complete) continue;
+
+        for (const QByteArray& hash : std::as_const(blobs[i])) {
+            if (m_blobRefs[hash]++ == 0) {
+                m_blobSizes.insert(hash, sizes.value(hash));
+                m_totalBytes += sizes.value(hash);
+            }
+        }
+        m_entries.insert(keys[i], {blobs[i], lastUsed[i]});
+    }
+    m_clock = clock;
+    return true;
+}
+
+bool ResponseCache::save() {
+    m_saveTimer->stop();
+
+    QSaveFile file(m_directory + "/index.bin");
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    QList<QByteArray> keys;
+    QList<quint64> lastUsed;
+    QList<QList<QByteArray>> blobs;
+    for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it) {
+        keys.append(it.key());
+        lastUsed.append(it->lastUsed);
+        blobs.append(it->blobs);
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_5);
+    out << CACHE_MAGIC << CACHE_VERSION << m_clock << keys << lastUsed << blobs << m_blobSizes;
+
+    const bool saved = out.status() == QDataStream::Ok && file.commit();
+    if (saved) {
+        m_dirty = false;
+    }
+    return saved;
+}
+
+void ResponseCache::scheduleSave() {
+    m_dirty = true;
+    if (!m_saveTimer->isActive()) {
+        m_saveTimer->start();
+    }
+}
+
+} // namespace codex::api
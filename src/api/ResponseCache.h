@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QObject>
+#include <QString>
+
+class QTimer;
+
+namespace codex::api {
+
+// Responses of earlier generations, kept on disk across runs so that the same
+// prompt with the same model and parameters is not paid for twice. A response
+// is one or more blobs of raw bytes (a JSON body, an audio file, one PNG per
+// image sample); blobs are stored once per content hash, shared by every
+// entry that returned the same bytes. Past the size limit from Config, the
+// least recently used entries go first. LLM scene enrichments are not kept
+// here: EnrichmentCacheRepository stores them parsed. Lives on the GUI thread.
+class ResponseCache : public QObject {
+    Q_OBJECT
+
+public:
+    static ResponseCache& instance();
+
+    // Entry key. parameters holds everything besides the prompt that changes
+    // the output (sample count, voice settings...), never credentials.
+    static QByteArray key(const QString& provider, const QString& model,
+                          const QJsonObject& parameters, const QString& prompt);
+
+    // Blobs of the entry, empty when absent or when the cache is off
+    QList<QByteArray> lookup(const QByteArray& key);
+
+    // Replaces the entry, then evicts down to the size limit
+    void store(const QByteArray& key, const QList<QByteArray>& blobs);
+
+    int entryCount() const { return int(m_entries.size()); }
+    qint64 totalBytes() const { return m_totalBytes; }
+
+private:
+    struct Entry {
+        QList<QByteArray> blobs;    // Content hashes, in response order
+        quint64 lastUsed = 0;
+    };
+
+    ResponseCache();
+
+    QString blobPath(const QByteArray& hash) const;
+    bool writeBlob(const QByteArray& hash, const QByteArray& data);
+    void release(const Entry& entry);
+    void evict(qint64 maxBytes);
+
+    bool load();
+    bool save();
+    void scheduleSave();
+
+    QString m_directory;
+    QHash<QByteArray, Entry> m_entries;
+    QHash<QByteArray, qint64> m_blobSizes;  // Content hash -> size on disk
+    QHash<QByteArray, int> m_blobRefs;      // Content hash -> entries using it
+    qint64 m_totalBytes = 0;
+    quint64 m_clock = 0;                    // Use counter, orders the entries
+    bool m_dirty = false;
+    QTimer* m_saveTimer;
+};
+
+} // namespace codex::api
@@ -0,0 +1,255 @@
+#include "SharedRequest.h"
+#include "NetworkTransport.h"
+#include "RateLimiter.h"
+#include "utils/Logger.h"
+
+#include <QCryptographicHash>
+#include <QHash>
+
+#include <algorithm>
+#include <cstring>
+
+namespace codex::api {
+
+namespace {
+
+// Shared requests that a new caller may still join, by request hash
+QHash<QByteArray, SharedRequest*>& joinableRequests() {
+    static QHash<QByteArray, SharedRequest*> requests;
+    return requests;
+}
+
+} // namespace
+
+// SharedReply
+
+SharedReply::SharedReply(SharedRequest* source, const QNetworkRequest& request)
+    : m_source(source)
+{
+    setRequest(request);
+    setUrl(request.url());
+    setOperation(QNetworkAccessManager::PostOperation);
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+SharedReply::~SharedReply() {
+    if (m_source) {
+        m_source->removeSubscriber(this);
+    }
+}
+
+void SharedReply::abort() {
+    if (isFinished()) return;
+
+    if (m_source) {
+        m_source->removeSubscriber(this);
+        m_source = nullptr;
+    }
+
+    setError(QNetworkReply::OperationCanceledError, "Operation canceled");
+    setFinished(true);
+    emit errorOccurred(QNetworkReply::OperationCanceledError);
+    emit finished();
+}
+
+qint64 SharedReply::bytesAvailable() const {
+    return QNetworkReply::bytesAvailable() + (m_buffer.size() - m_offset);
+}
+
+qint64 SharedReply::readData(char* data, qint64 maxSize) {
+    const qint64 count = qMin(maxSize, qint64(m_buffer.size() - m_offset));
+    if (count <= 0) {
+        return isFinished() ? -1 : 0;
+    }
+
+    std::memcpy(data, m_buffer.constData() + m_offset, size_t(count));
+    m_offset += count;
+    if (m_offset == m_buffer.size()) {
+        m_buffer.clear();
+        m_offset = 0;
+    }
+    return count;
+}
+
+void SharedReply::copyMetaData(QNetworkReply* from) {
+    for (auto attribute : {QNetworkRequest::HttpStatusCodeAttribute,
+                           QNetworkRequest::HttpReasonPhraseAttribute,
+                           QNetworkRequest::Http2WasUsedAttribute}) {
+        setAttribute(attribute, from->attribute(attribute));
+    }
+    for (const auto& header : from->rawHeaderPairs()) {
+        setRawHeader(header.first, header.second);
+    }
+    emit metaDataChanged();
+}
+
+void SharedReply::appendData(const QByteArray& chunk) {
+    if (chunk.isEmpty()) return;
+
+    m_buffer += chunk;
+    emit readyRead();
+}
+
+void SharedReply::finishFrom(QNetworkReply* from) {
+    m_source = nullptr;
+    copyMetaData(from);
+
+    if (from->error() != QNetworkReply::NoError) {
+        setError(from->error(), from->errorString());
+        emit errorOccurred(from->error());
+    }
+    setFinished(true);
+    emit readChannelFinished();
+    emit finished();
+}
+
+// SharedRequest
+
+SharedRequest::SharedRequest(const QByteArray& hash, const QNetworkRequest& request,
+                             const QByteArray& body, const QString& quotaKey)
+    : m_hash(hash)
+    , m_request(request)
+    , m_body(body)
+    , m_quotaKey(quotaKey)
+{
+    joinableRequests().insert(m_hash, this);
+}
+
+SharedRequest::~SharedRequest() {
+    closeToJoiners();
+
+    // Every caller gave up before the end
+    if (m_reply) {
+        m_reply->disconnect(this);
+        m_reply->abort();
+        m_reply->deleteLater();
+    }
+}
+
+QByteArray SharedRequest::requestHash(const QNetworkRequest& request, const QByteArray& body) {
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(request.url().toEncoded());
+
+    // Headers carry the credentials and the API version
+    QList<QByteArray> headers = request.rawHeaderList();
+    std::sort(headers.begin(), headers.end());
+    for (const QByteArray& name : headers) {
+        hash.addData(name);
+        hash.addData(":");
+        hash.addData(request.rawHeader(name));
+        hash.addData("\n");
+    }
+
+    hash.addData(body);
+    return hash.result();
+}
+
+QNetworkReply* SharedRequest::subscribe(const QNetworkRequest& request, const QByteArray& body,
+                                        const QString& quotaKey, const RequestTicket& ticket) {
+    const QByteArray hash = requestHash(request, body);
+
+    SharedRequest* shared = joinableRequests().value(hash);
+    if (shared) {
+        LOG_INFO(QString("SharedRequest: %1 request already in flight, %2 callers share it")
+                 .arg(quotaKey).arg(shared->subscriberCount() + 1));
+    } else {
+        shared = new SharedRequest(hash, request, body, quotaKey);
+
+        // Dropped from the queue if every caller gives up while it waits
+        RequestQueue::instance().submit(quotaKey, ticket, shared, [shared]() { return shared->start(); });
+    }
+
+    return shared->addSubscriber();
+}
+
+SharedReply* SharedRequest::addSubscriber() {
+    auto* reply = new SharedReply(this, m_request);
+    m_subscribers.append(reply);
+
+    if (m_reply) {
+        reply->m_networkReply = m_reply;
+        reply->copyMetaData(m_reply);
+    }
+    return reply;
+}
+
+void SharedRequest::removeSubscriber(SharedReply* reply) {
+    m_subscribers.removeAll(reply);
+    m_subscribers.removeAll(nullptr);
+
+    if (m_subscribers.isEmpty()) {
+        closeToJoiners();
+        deleteLater();
+    }
+}
+
+void SharedRequest::closeToJoiners() {
+    if (!m_joinable) return;
+
+    m_joinable = false;
+    auto& requests = joinableRequests();
+    if (requests.value(m_hash) == this) {
+        requests.remove(m_hash);
+    }
+}
+
+QNetworkReply* SharedRequest::start() {
+    m_reply = NetworkTransport::instance().post(m_request, m_body);
+
+    connect(m_reply, &QNetworkReply::metaDataChanged, this, &SharedRequest::onMetaDataChanged);
+    connect(m_reply, &QNetworkReply::readyRead, this, &SharedRequest::onReadyRead);
+    connect(m_reply, &QNetworkReply::downloadProgress, this, &SharedRequest::onDownloadProgress);
+    connect(m_reply, &QNetworkReply::finished, this, &SharedRequest::onFinished);
+
+    for (const auto& subscriber : std::as_const(m_subscribers)) {
+        if (subscriber) subscriber->m_networkReply = m_reply;
+    }
+    return m_reply;
+}
+
+void SharedRequest::onMetaDataChanged() {
+    for (const auto& subscriber : std::as_const(m_subscribers)) {
+        if (subscriber) subscriber->copyMetaData(m_reply);
+    }
+}
+
+void SharedRequest::onReadyRead() {
+    // Chunks are handed out as they arrive and not kept: too late to join
+    closeToJoiners();
+
+    const QByteArray chunk = m_reply->readAll();
+    const QList<QPointer<SharedReply>> subscribers = m_subscribers;
+    for (const auto& subscriber : subscribers) {
+        if (subscriber) subscriber->appendData(chunk);
+    }
+}
+
+void SharedRequest::onDownloadProgress(qint64 received, qint64 total) {
+    const QList<QPointer<SharedReply>> subscribers = m_subscribers;
+    for (const auto& subscriber : subscribers) {
+        if (subscriber) emit subscriber->downloadProgress(received, total);
+    }
+}
+
+void SharedRequest::onFinished() {
+    closeToJoiners();
+    onReadyRead();
+
+    if (m_reply->error() == QNetworkReply::NoError) {
+        RateLimiter::instance().reportSuccess(m_quotaKey);
+    }
+
+    // The subscribers' handlers run now, before the network reply goes away
+    const QList<QPointer<SharedReply>> subscribers = m_subscribers;
+    m_subscribers.clear();
+    for (const auto& subscriber : subscribers) {
+        if (subscriber) subscriber->finishFrom(m_reply);
+    }
+
+    m_reply->disconnect(this);
+    m_reply->deleteLater();
+    m_reply = nullptr;
+    deleteLater();
+}
+
+} // namespace codex::api
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "RequestQueue.h"
+
+#include <QByteArray>
+#include <QList>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QObject>
+#include <QPointer>
+
+namespace codex::api {
+
+class SharedRequest;
+
+// What one caller of a shared request reads: the chunks of the network reply
+// as they arrive, its headers, attributes and error. Deleted by the caller
+// like any reply.
+class SharedReply : public QNetworkReply {
+    Q_OBJECT
+
+public:
+    ~SharedReply() override;
+
+    // The network reply behind it, null until the request leaves the queue
+    QNetworkReply* networkReply() const { return m_networkReply; }
+
+    void abort() override;
+    qint64 bytesAvailable() const override;
+    bool isSequential() const override { return true; }
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) override;
+
+private:
+    friend class SharedRequest;
+
+    SharedReply(SharedRequest* source, const QNetworkRequest& request);
+
+    void copyMetaData(QNetworkReply* from);
+    void appendData(const QByteArray& chunk);
+    void finishFrom(QNetworkReply* from);
+
+    QPointer<SharedRequest> m_source;
+    QPointer<QNetworkReply> m_networkReply;
+    QByteArray m_buffer;
+    qsizetype m_offset = 0;
+};
+
+// One generation POST for every caller that sends exactly the same request
+// (URL, headers and body) while it is queued or waiting for the server.
+// Once the body starts streaming, a new identical request gets its own
+// network request: the bytes already forwarded are not kept for latecomers.
+class SharedRequest : public QObject {
+    Q_OBJECT
+
+public:
+    // Reply for this caller, sharing the request in progress when there is one
+    static QNetworkReply* subscribe(const QNetworkRequest& request, const QByteArray& body,
+                                    const QString& quotaKey, const RequestTicket& ticket);
+
+    int subscriberCount() const { return int(m_subscribers.size()); }
+
+private:
+    friend class SharedReply;
+
+    SharedRequest(const QByteArray& hash, const QNetworkRequest& request,
+                  const QByteArray& body, const QString& quotaKey);
+    ~SharedRequest() override;
+
+    static QByteArray requestHash(const QNetworkRequest& request, const QByteArray& body);
+
+    SharedReply* addSubscriber();
+    void removeSubscriber(SharedReply* reply);
+    QNetworkReply* start();
+    void closeToJoiners();
+
+    void onMetaDataChanged();
+    void onReadyRead();
+    void onDownloadProgress(qint64 received, qint64 total);
+    void onFinished();
+
+    QByteArray m_hash;
+    QNetworkRequest m_request;
+    QByteArray m_body;
+    QString m_quotaKey;
+    QNetworkReply* m_reply = nullptr;
+    QList<QPointer<SharedReply>> m_subscribers;
+    bool m_joinable = true;
+};
+
+} // namespace codex::api
@@ -1,4 +1,5 @@
 #include "VeoClient.h"
+#include "MediaReplyParser.h"
 #include "utils/Logger.h"
 
 #include <QJsonDocument>
@@ -14,6 +15,12 @@ VeoClient::VeoClient(QObject* parent)
     m_baseUrl = "https://generativelanguage.googleapis.com/v1beta/models";
 }
 
+QStringList VeoClient::videoFields() {
+    // Inline video payloads: generatedVideos[0].video.videoBytes (or video.video)
+    // and video.bytesBase64Encoded in completed operations
+    return {"videoBytes", "video", "bytesBase64Encoded"};
+}
+
 bool VeoClient::isConfigured() const {
     return !m_apiKey.isEmpty();
 }
@@ -74,25 +81,31 @@ void VeoClient::generateVideo(const VideoGenerationParams& params) {
              .arg(params.durationSeconds)
              .arg(params.prompt.left(100)));
 
-    QNetworkReply* reply = m_networkManager->post(request, QJsonDocument(body).toJson());
-    connect(reply, &QNetworkReply::finished, this, [this, reply, params]() {
-        onGenerateReplyFinished(reply, params.prompt);
+    sendPost(request, QJsonDocument(body).toJson(), [this, params](QNetworkReply* reply) {
+        auto* parser = new MediaReplyParser(reply, videoFields(), true);
+        connect(reply, &QNetworkReply::finished, this, [this, reply, parser, params]() {
+            onGenerateReplyFinished(reply, parser, params.prompt);
+        });
     });
 }
 
-void VeoClient::onGenerateReplyFinished(QNetworkReply* reply, const QString& originalPrompt) {
+QString VeoClient::quotaKey() const {
+    return QString("%1/%2").arg(m_provider == GoogleAIProvider::VertexAI ? "vertex" : "aistudio", m_model);
+}
+
+void VeoClient::onGenerateReplyFinished(QNetworkReply* reply, MediaReplyParser* parser, const QString& originalPrompt) {
+    parser->finish();
+
     if (reply->error() != QNetworkReply::NoError) {
         emit requestFinished();
-        handleNetworkError(reply);
+        handleNetworkError(reply, parser->skeleton());
         reply->deleteLater();
         return;
     }
 
-    QByteArray data = reply->readAll();
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    QJsonObject response = doc.object();
+    QJsonObject response = parser->document();
 
-    LOG_DEBUG(QString("Veo response: %1").arg(QString::fromUtf8(data.left(500))));
+    LOG_DEBUG(QString("Veo response: %1").arg(QString::fromUtf8(parser->skeleton().left(500))));
 
     // Veo returns an operation name for async processing
     QString operationName = response["name"].toString();
@@ -108,21 +121,16 @@ void VeoClient::onGenerateReplyFinished(QNetworkReply* reply, const QString& ori
         });
     } else {
         // Check if video is returned directly
+        // (generatedVideos[0].video.videoBytes, or the alternate video.video field)
         QJsonArray generatedVideos = response["generatedVideos"].toArray();
         if (!generatedVideos.isEmpty()) {
-            QJsonObject video = generatedVideos[0].toObject()["video"].toObject();
-            QString base64Data = video["videoBytes"].toString();
-            if (base64Data.isEmpty()) {
-                // Try alternate field name
-                base64Data = video["video"].toString();
-            }
+            QByteArray videoData = parser->takeMedia().value(0);
 
-            if (!base64Data.isEmpty()) {
-                QByteArray videoData = QByteArray::fromBase64(base64Data.toUtf8());
+            if (!videoData.isEmpty()) {
                 emit requestFinished();
                 emit generationProgress(100);
                 emit videoGenerated(videoData, originalPrompt);
-                LOG_INFO("Video received directly (no polling needed)");
+                LOG_INFO(QString("Video received directly (no polling needed, %1 bytes)").arg(videoData.size()));
             } else {
                 emit requestFinished();
                 emit errorOccurred("Video data empty in response");
@@ -160,23 +168,26 @@ void VeoClient::pollOperation(const QString& operationName, const QString& origi
     request.setUrl(QUrl(url));
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
 
-    QNetworkReply* reply = m_networkManager->get(request);
-    connect(reply, &QNetworkReply::finished, this, [this, reply, originalPrompt]() {
-        onPollReplyFinished(reply, originalPrompt);
+    sendGet(request, [this, originalPrompt](QNetworkReply* reply) {
+        auto* parser = new MediaReplyParser(reply, videoFields(), true);
+        connect(reply, &QNetworkReply::finished, this, [this, reply, parser, originalPrompt]() {
+            onPollReplyFinished(reply, parser, originalPrompt);
+        });
     });
 }
 
-void VeoClient::onPollReplyFinished(QNetworkReply* reply, const QString& originalPrompt) {
+void VeoClient::onPollReplyFinished(QNetworkReply* reply, MediaReplyParser* parser, const QString& originalPrompt) {
+    parser->finish();
+
     if (reply->error() != QNetworkReply::NoError) {
         emit requestFinished();
-        handleNetworkError(reply);
+        handleNetworkError(reply, parser->skeleton());
         reply->deleteLater();
         return;
     }
 
-    QByteArray data = reply->readAll();
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    QJsonObject response = doc.object();
+    const QByteArray& data = parser->skeleton();
+    QJsonObject response = parser->document();
 
     bool done = response["done"].toBool();
     QString operationName = response["name"].toString();
@@ -184,7 +195,6 @@ void VeoClient::onPollReplyFinished(QNetworkReply* reply, const QString& origina
     if (done) {
         // Operation completed - try multiple response formats
         QJsonObject result = response["response"].toObject();
-        QString base64Data;
         QString videoUri;
 
         // Try Gemini API format: generateVideoResponse.generatedSamples[0].video.uri
@@ -193,24 +203,21 @@ void VeoClient::onPollReplyFinished(QNetworkReply* reply, const QString& origina
         if (!generatedSamples.isEmpty()) {
             QJsonObject video = generatedSamples[0].toObject()["video"].toObject();
             videoUri = video["uri"].toString();
-            if (videoUri.isEmpty()) {
-                base64Data = video["bytesBase64Encoded"].toString();
-            }
         }
 
-        // Try Vertex AI format: predictions[0].video.bytesBase64Encoded
-        if (base64Data.isEmpty() && videoUri.isEmpty()) {
+        // Try Vertex AI format: predictions[0].video.uri
+        if (videoUri.isEmpty()) {
             QJsonArray predictions = result["predictions"].toArray();
             if (!predictions.isEmpty()) {
                 QJsonObject prediction = predictions[0].toObject();
                 QJsonObject video = prediction["video"].toObject();
                 videoUri = video["uri"].toString();
-                if (videoUri.isEmpty()) {
-                    base64Data = video["bytesBase64Encoded"].toString();
-                }
             }
         }
 
+        // Inline video.bytesBase64Encoded was decoded while the reply streamed in
+        QByteArray videoData = parser->takeMedia().value(0);
+
         // If we have a URI, download the video
         if (!videoUri.isEmpty()) {
             LOG_INFO(QString("Downloading video from URI: %1").arg(videoUri));
@@ -225,26 +232,26 @@ void VeoClient::onPollReplyFinished(QNetworkReply* reply, const QString& origina
             QNetworkRequest downloadRequest;
             downloadRequest.setUrl(QUrl(downloadUrl));
 
-            QNetworkReply* downloadReply = m_networkManager->get(downloadRequest);
-            connect(downloadReply, &QNetworkReply::finished, this, [this, downloadReply, originalPrompt]() {
-                if (downloadReply->error() != QNetworkReply::NoError) {
-                    emit requestFinished();
-                    handleNetworkError(downloadReply);
-                } else {
-                    QByteArray videoData = downloadReply->readAll();
-                    emit requestFinished();
-                    emit generationProgress(100);
-                    emit videoGenerated(videoData, originalPrompt);
-                    LOG_INFO(QString("Video downloaded successfully (%1 bytes)").arg(videoData.size()));
-                }
-                downloadReply->deleteLater();
+            sendGet(downloadRequest, [this, originalPrompt](QNetworkReply* downloadReply) {
+                connect(downloadReply, &QNetworkReply::finished, this, [this, downloadReply, originalPrompt]() {
+                    if (downloadReply->error() != QNetworkReply::NoError) {
+                        emit requestFinished();
+                        handleNetworkError(downloadReply);
+                    } else {
+                        QByteArray videoData = downloadReply->readAll();
+                        emit requestFinished();
+                        emit generationProgress(100);
+                        emit videoGenerated(videoData, originalPrompt);
+                        LOG_INFO(QString("Video downloaded successfully (%1 bytes)").arg(videoData.size()));
+                    }
+                    downloadReply->deleteLater();
+                });
             });
             reply->deleteLater();
             return;  // Exit early, download callback will handle the rest
         }
 
-        if (!base64Data.isEmpty()) {
-            QByteArray videoData = QByteArray::fromBase64(base64Data.toUtf8());
+        if (!videoData.isEmpty()) {
             emit requestFinished();
             emit generationProgress(100);
             emit videoGenerated(videoData, originalPrompt);
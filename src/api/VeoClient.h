@@ -2,9 +2,12 @@
 
 #include "ApiClient.h"
 #include <QByteArray>
+#include <QStringList>
 
 namespace codex::api {
 
+class MediaReplyParser;
+
 struct VideoGenerationParams {
     QString prompt;
     QString aspectRatio = "16:9";
@@ -39,11 +42,13 @@ signals:
     void generationProgress(int percent);
     void operationPending(const QString& operationId);
 
-private slots:
-    void onGenerateReplyFinished(QNetworkReply* reply, const QString& originalPrompt);
-    void onPollReplyFinished(QNetworkReply* reply, const QString& originalPrompt);
+protected:
+    QString quotaKey() const override;
 
 private:
+    static QStringList videoFields();
+    void onGenerateReplyFinished(QNetworkReply* reply, MediaReplyParser* parser, const QString& originalPrompt);
+    void onPollReplyFinished(QNetworkReply* reply, MediaReplyParser* parser, const QString& originalPrompt);
     void pollOperation(const QString& operationName, const QString& originalPrompt);
 
     QString m_model = "veo-3.1-generate-preview";
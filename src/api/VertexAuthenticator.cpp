@@ -13,7 +13,6 @@ namespace codex::api {
 VertexAuthenticator::VertexAuthenticator(QObject* parent)
     : QObject(parent)
 {
-    m_networkManager = new QNetworkAccessManager(this);
 }
 
 bool VertexAuthenticator::loadServiceAccount(const QString& jsonFilePath) {
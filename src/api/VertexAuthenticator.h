@@ -3,7 +3,6 @@
 #include <QObject>
 #include <QString>
 #include <QJsonObject>
-#include <QNetworkAccessManager>
 #include <QDateTime>
 
 namespace codex::api {
@@ -41,8 +40,6 @@ private:
     QString createJWT();
     void requestAccessToken(const QString& jwt);
 
-    QNetworkAccessManager* m_networkManager = nullptr;
-
     // Service account credentials
     QString m_clientEmail;
     QString m_privateKey;
@@ -5,131 +5,213 @@
 #include "core/services/TextParser.h"
 #include "core/services/PromptBuilder.h"
 #include "core/services/MythicClassifier.h"
+#include "db/repositories/EnrichmentCacheRepository.h"
 #include "utils/SecureStorage.h"
 #include "utils/Config.h"
 #include "utils/Logger.h"
 
 #include <QJsonArray>
 #include <QJsonDocument>
+#include <QTimer>
 
 namespace codex::core {
 
 PipelineController::PipelineController(QObject* parent)
     : QObject(parent)
 {
-    // Create API clients
-    m_claudeClient = new codex::api::ClaudeClient(this);
-    m_geminiClient = new codex::api::GeminiClient(this);
-    m_imagenClient = new codex::api::ImagenClient(this);
     m_textParser = new TextParser();
     m_promptBuilder = new PromptBuilder();
     m_mythicClassifier = new MythicClassifier();
 
+    // API clients are created per job (see createJobClients)
+    auto& config = codex::utils::Config::instance();
+    LOG_INFO("Gemini LLM: Using AI Studio endpoint (free tier)");
+    LOG_INFO(QString("Gemini model: %1").arg(config.geminiModel()));
+    LOG_INFO(QString("Imagen: Using %1 endpoint")
+             .arg(config.googleAiProvider() == "vertex" ? "Vertex AI" : "AI Studio"));
+
+    LOG_INFO("PipelineController initialized");
+}
+
+PipelineController::~PipelineController() {
+    qDeleteAll(m_jobs);
+    m_jobs.clear();
+    qDeleteAll(m_batches);
+    m_batches.clear();
+
+    delete m_textParser;
+    delete m_promptBuilder;
+    delete m_mythicClassifier;
+}
+
+PipelineState PipelineController::state(int jobId) const {
+    PipelineJob* job = findJob(jobId);
+    return job ? job->state : PipelineState::Idle;
+}
+
+bool PipelineController::isRunning(int jobId) const {
+    return m_jobs.contains(jobId);
+}
+
+bool PipelineController::isRunning() const {
+    return !m_jobs.isEmpty();
+}
+
+PipelineJob* PipelineController::findJob(int jobId) const {
+    return m_jobs.value(jobId, nullptr);
+}
+
+void PipelineController::createJobClients(PipelineJob* job) {
     // Load API keys and configure providers
     auto& storage = codex::utils::SecureStorage::instance();
     auto& config = codex::utils::Config::instance();
+    const int jobId = job->id;
 
-    m_claudeClient->setApiKey(storage.getApiKey(storage.SERVICE_CLAUDE));
+    job->claudeClient = new codex::api::ClaudeClient(this);
+    job->claudeClient->setApiKey(storage.getApiKey(storage.SERVICE_CLAUDE));
 
     // Configure Gemini (for prompt enrichment) - uses AI Studio (separate key)
-    m_geminiClient->setProvider(codex::api::GoogleAIProvider::AIStudio);
-    m_geminiClient->setApiKey(storage.getApiKey(storage.SERVICE_AISTUDIO));  // AI Studio key (free tier)
-    m_geminiClient->setModel(config.geminiModel());
-    LOG_INFO("Gemini LLM: Using AI Studio endpoint (free tier)");
-    LOG_INFO(QString("Gemini model: %1").arg(config.geminiModel()));
+    job->geminiClient = new codex::api::GeminiClient(this);
+    job->geminiClient->setProvider(codex::api::GoogleAIProvider::AIStudio);
+    job->geminiClient->setApiKey(storage.getApiKey(storage.SERVICE_AISTUDIO));  // AI Studio key (free tier)
+    job->geminiClient->setModel(config.geminiModel());
 
     // Configure Google AI provider for images/videos (Vertex AI by default)
-    QString googleProvider = config.googleAiProvider();
-    if (googleProvider == "vertex") {
-        m_imagenClient->setProvider(codex::api::GoogleAIProvider::VertexAI);
-        LOG_INFO("Imagen: Using Vertex AI endpoint");
+    job->imagenClient = new codex::api::ImagenClient(this);
+    if (config.googleAiProvider() == "vertex") {
+        job->imagenClient->setProvider(codex::api::GoogleAIProvider::VertexAI);
     } else {
-        m_imagenClient->setProvider(codex::api::GoogleAIProvider::AIStudio);
-        LOG_INFO("Imagen: Using AI Studio endpoint");
+        job->imagenClient->setProvider(codex::api::GoogleAIProvider::AIStudio);
     }
-    m_imagenClient->setApiKey(storage.getApiKey(storage.SERVICE_IMAGEN));
+    job->imagenClient->setApiKey(storage.getApiKey(storage.SERVICE_IMAGEN));
+
+    job->claudeClient->setTicket(job->ticket);
+    job->geminiClient->setTicket(job->ticket);
+    job->imagenClient->setTicket(job->ticket);
+    job->claudeClient->setCacheBypass(job->freshSample);
+    job->geminiClient->setCacheBypass(job->freshSample);
+    job->imagenClient->setCacheBypass(job->freshSample);
 
     // Connect Claude signals (fallback)
-    connect(m_claudeClient, &codex::api::ClaudeClient::enrichmentCompleted,
-            this, &PipelineController::onClaudeEnrichmentCompleted);
-    connect(m_claudeClient, &codex::api::ClaudeClient::errorOccurred,
-            this, &PipelineController::onClaudeError);
+    connect(job->claudeClient, &codex::api::ClaudeClient::enrichmentCompleted,
+            this, [this, jobId](const QJsonObject& response) { onClaudeEnrichmentCompleted(jobId, response); });
+    connect(job->claudeClient, &codex::api::ClaudeClient::errorOccurred,
+            this, [this, jobId](const QString& error) { onClaudeError(jobId, error); });
 
     // Connect Gemini signals
-    connect(m_geminiClient, &codex::api::GeminiClient::enrichmentCompleted,
-            this, &PipelineController::onGeminiEnrichmentCompleted);
-    connect(m_geminiClient, &codex::api::GeminiClient::errorOccurred,
-            this, &PipelineController::onGeminiError);
+    connect(job->geminiClient, &codex::api::GeminiClient::enrichmentCompleted,
+            this, [this, jobId](const QJsonObject& response) { onGeminiEnrichmentCompleted(jobId, response); });
+    connect(job->geminiClient, &codex::api::GeminiClient::errorOccurred,
+            this, [this, jobId](const QString& error) { onGeminiError(jobId, error); });
 
     // Connect Imagen signals
-    connect(m_imagenClient, &codex::api::ImagenClient::imageGenerated,
-            this, &PipelineController::onImagenImageGenerated);
-    connect(m_imagenClient, &codex::api::ImagenClient::errorOccurred,
-            this, &PipelineController::onImagenError);
-    connect(m_imagenClient, &codex::api::ImagenClient::generationProgress,
-            this, &PipelineController::onImagenProgress);
-
-    LOG_INFO("PipelineController initialized");
+    connect(job->imagenClient, &codex::api::ImagenClient::imagesGenerated,
+            this, [this, jobId](const QList<QPixmap>& images, const QString& prompt) { onImagenImagesGenerated(jobId, images, prompt); });
+    connect(job->imagenClient, &codex::api::ImagenClient::errorOccurred,
+            this, [this, jobId](const QString& error) { onImagenError(jobId, error); });
+    connect(job->imagenClient, &codex::api::ImagenClient::generationProgress,
+            this, [this, jobId](int percent) { onImagenProgress(jobId, percent); });
+
+    // Transient errors are retried by the client itself; only report the wait
+    connect(job->imagenClient, &codex::api::ImagenClient::retryScheduled,
+            this, [this, jobId](int attempt, int delayMs) {
+        emit progressUpdated(jobId, 60, QString("Quota Imagen atteint, nouvel essai %1 dans %2 s")
+                                         .arg(attempt).arg((delayMs + 999) / 1000));
+    });
 }
 
-PipelineController::~PipelineController() {
-    delete m_textParser;
-    delete m_promptBuilder;
-    delete m_mythicClassifier;
-}
+void PipelineController::releaseJob(int jobId) {
+    PipelineJob* job = m_jobs.take(jobId);
+    if (!job) return;
 
-bool PipelineController::isRunning() const {
-    return m_state != PipelineState::Idle &&
-           m_state != PipelineState::Completed &&
-           m_state != PipelineState::Failed &&
-           m_state != PipelineState::Cancelled;
+    // Deleting the clients aborts any reply still pending for this job
+    if (job->claudeClient) job->claudeClient->deleteLater();
+    if (job->geminiClient) job->geminiClient->deleteLater();
+    if (job->imagenClient) job->imagenClient->deleteLater();
+    delete job;
 }
 
-void PipelineController::startGeneration(const QString& passageText,
-                                          const QString& treatiseCode,
-                                          const QString& category) {
-    if (isRunning()) {
-        LOG_WARN("Pipeline already running, ignoring start request");
-        return;
-    }
-
-    // Reset state
-    m_cancelled = false;
-    m_lastResult = PipelineResult();
-    m_currentPassage = passageText;
-    m_currentTreatiseCode = treatiseCode;
-
+QString PipelineController::resolveCategory(const QString& treatiseCode, const QString& category) const {
     // Auto-classify if no category provided
     if (category.isEmpty() && !treatiseCode.isEmpty()) {
         MythicCategory mythicCat = m_mythicClassifier->classifyTreatise(treatiseCode);
-        m_currentCategory = m_mythicClassifier->categoryName(mythicCat);
-    } else {
-        m_currentCategory = category.isEmpty() ? "Gnose" : category;
+        return m_mythicClassifier->categoryName(mythicCat);
     }
+    return category.isEmpty() ? "Gnose" : category;
+}
 
-    LOG_INFO(QString("Starting pipeline for passage: %1 chars, treatise: %2, category: %3")
-             .arg(passageText.length()).arg(treatiseCode).arg(m_currentCategory));
-
-    // Step 1: Analyze passage
-    setState(PipelineState::AnalyzingText, "Analyse du passage...");
-    emit progressUpdated(5, "Analyse du texte");
+int PipelineController::startGeneration(const QString& passageText,
+                                         const QString& treatiseCode,
+                                         const QString& category,
+                                         const SceneEnrichment& enrichment,
+                                         int sampleCount,
+                                         const codex::api::RequestTicket& ticket,
+                                         bool freshSample) {
+    auto* job = new PipelineJob();
+    job->id = m_nextJobId++;
+    job->passage = passageText;
+    job->treatiseCode = treatiseCode;
+    job->category = resolveCategory(treatiseCode, category);
+    job->sampleCount = qBound(1, sampleCount, codex::api::ImagenClient::MAX_SAMPLES);
+    job->ticket = ticket;
+    job->freshSample = freshSample;
+
+    // Enrichment computed ahead of time (batch request)
+    if (enrichment.isValid()) {
+        job->enrichedScene = enrichment.scene;
+        job->enrichedEmotion = enrichment.emotion.isEmpty() ? QString("mystique") : enrichment.emotion;
+        job->visualKeywords = enrichment.visualElements;
+    }
 
-    analyzePassage();
+    m_jobs.insert(job->id, job);
+    createJobClients(job);
+
+    LOG_INFO(QString("Starting pipeline job %1 for passage: %2 chars, treatise: %3, category: %4 (%5 in flight)")
+             .arg(job->id).arg(passageText.length()).arg(treatiseCode).arg(job->category)
+             .arg(m_jobs.size()));
+
+    // Deferred so the caller can register the job id before any signal for it
+    const int jobId = job->id;
+    QTimer::singleShot(0, this, [this, jobId]() {
+        PipelineJob* job = findJob(jobId);
+        if (!job) return;   // Cancelled before it started
+
+        // Step 1: Analyze passage
+        setState(job, PipelineState::AnalyzingText, "Analyse du passage...");
+        emit progressUpdated(jobId, 5, "Analyse du texte");
+        analyzePassage(jobId);
+    });
+    return jobId;
 }
 
-void PipelineController::cancel() {
-    if (!isRunning()) return;
+void PipelineController::cancelAll() {
+    const QList<int> ids = m_jobs.keys();
+    for (int jobId : ids) {
+        PipelineJob* job = findJob(jobId);
+        if (!job) continue;
 
-    m_cancelled = true;
-    setState(PipelineState::Cancelled, "Generation annulee");
-    emit progressUpdated(0, "Annule");
+        setState(job, PipelineState::Cancelled, "Generation annulee");
+        releaseJob(jobId);
+        emit progressUpdated(jobId, 0, "Annule");
 
-    LOG_INFO("Pipeline cancelled by user");
+        LOG_INFO(QString("Pipeline job %1 cancelled by user").arg(jobId));
+    }
+
+    const QList<int> batchIds = m_batches.keys();
+    for (int batchId : batchIds) {
+        PipelineBatch* batch = m_batches.take(batchId);
+        if (batch->claudeClient) batch->claudeClient->deleteLater();
+        if (batch->geminiClient) batch->geminiClient->deleteLater();
+        delete batch;
+
+        emit batchEnrichmentCancelled(batchId);
+        LOG_INFO(QString("Batch enrichment %1 cancelled").arg(batchId));
+    }
 }
 
-void PipelineController::setState(PipelineState state, const QString& message) {
-    m_state = state;
-    emit stateChanged(state, message);
+void PipelineController::setState(PipelineJob* job, PipelineState state, const QString& message) {
+    job->state = state;
+    emit stateChanged(job->id, state, message);
 
     QString stateStr;
     switch (state) {
@@ -141,130 +223,199 @@ void PipelineController::setState(PipelineState state, const QString& message) {
         case PipelineState::Failed: stateStr = "Failed"; break;
         case PipelineState::Cancelled: stateStr = "Cancelled"; break;
     }
-    LOG_INFO(QString("Pipeline state: %1 - %2").arg(stateStr, message));
+    LOG_INFO(QString("Pipeline job %1 state: %2 - %3").arg(job->id).arg(stateStr, message));
 }
 
-void PipelineController::analyzePassage() {
-    if (m_cancelled) return;
+void PipelineController::analyzePassage(int jobId) {
+    PipelineJob* job = findJob(jobId);
+    if (!job) return;
 
     // Detect gnostic entities in the passage
-    m_detectedEntities = m_textParser->detectGnosticEntities(m_currentPassage);
+    job->detectedEntities = m_textParser->detectGnosticEntities(job->passage);
 
-    LOG_INFO(QString("Detected entities: %1").arg(m_detectedEntities.join(", ")));
+    LOG_INFO(QString("Detected entities: %1").arg(job->detectedEntities.join(", ")));
 
-    emit progressUpdated(10, "Entites detectees");
+    emit progressUpdated(jobId, 10, "Entites detectees");
+
+    // Already enriched by a batch request: skip straight to Imagen
+    if (!job->enrichedScene.isEmpty()) {
+        if (job->visualKeywords.isEmpty()) {
+            job->visualKeywords = job->detectedEntities;
+        }
+        emit progressUpdated(jobId, 50, "Enrichissement de la planche");
+        generateImage(jobId);
+        return;
+    }
 
     // Step 2: Enrich with Claude
-    enrichWithClaude();
+    enrichWithClaude(jobId);
+}
+
+void PipelineController::applyDirectFallback(PipelineJob* job) {
+    // Use passage directly when no enrichment is available
+    job->enrichedScene = job->passage.left(500);
+    job->enrichedEmotion = "mystique";
+    job->visualKeywords = job->detectedEntities;
 }
 
-void PipelineController::enrichWithClaude() {
-    if (m_cancelled) return;
+void PipelineController::enrichWithClaude(int jobId) {
+    PipelineJob* job = findJob(jobId);
+    if (!job) return;
 
     auto& config = codex::utils::Config::instance();
     QString llmProvider = config.llmProvider();
 
     // Use Gemini if configured (default)
     if (llmProvider == "gemini") {
-        if (!m_geminiClient->isConfigured()) {
+        if (!job->geminiClient->isConfigured()) {
             LOG_WARN("Gemini API not configured, using direct Imagen prompt");
-            m_enrichedScene = m_currentPassage.left(500);
-            m_enrichedEmotion = "mystique";
-            m_visualKeywords = m_detectedEntities;
-            emit progressUpdated(50, "Enrichissement ignore (pas de cle Gemini)");
-            generateImage();
+            applyDirectFallback(job);
+            emit progressUpdated(jobId, 50, "Enrichissement ignore (pas de cle Gemini)");
+            generateImage(jobId);
             return;
         }
 
-        setState(PipelineState::EnrichingWithClaude, "Enrichissement avec Gemini 3 Pro...");
-        emit progressUpdated(20, "Appel Gemini API");
-
         QString geminiPrompt = m_promptBuilder->buildClaudePrompt(
-            m_currentPassage,
-            m_detectedEntities,
-            m_currentCategory
+            job->passage,
+            job->detectedEntities,
+            job->category
         );
 
-        m_geminiClient->enrichPassage(geminiPrompt);
+        job->enrichmentProvider = "gemini";
+        job->enrichmentModel = job->geminiClient->model();
+        job->enrichmentCacheKey = codex::db::EnrichmentCacheRepository::makeKey(
+            job->enrichmentProvider, job->enrichmentModel, geminiPrompt);
+        if (!job->freshSample && applyCachedEnrichment(job)) return;
+
+        setState(job, PipelineState::EnrichingWithClaude, "Enrichissement avec Gemini 3 Pro...");
+        emit progressUpdated(jobId, 20, "Appel Gemini API");
+
+        job->geminiClient->enrichPassage(geminiPrompt);
         return;
     }
 
     // Fallback to Claude
-    if (!m_claudeClient->isConfigured()) {
+    if (!job->claudeClient->isConfigured()) {
         LOG_WARN("Claude API not configured, using direct Imagen prompt");
-        m_enrichedScene = m_currentPassage.left(500);
-        m_enrichedEmotion = "mystique";
-        m_visualKeywords = m_detectedEntities;
+        applyDirectFallback(job);
 
-        emit progressUpdated(50, "Enrichissement ignore (pas de cle Claude)");
-        generateImage();
+        emit progressUpdated(jobId, 50, "Enrichissement ignore (pas de cle Claude)");
+        generateImage(jobId);
         return;
     }
 
-    setState(PipelineState::EnrichingWithClaude, "Enrichissement avec Claude...");
-    emit progressUpdated(20, "Appel Claude API");
-
     QString claudePrompt = m_promptBuilder->buildClaudePrompt(
-        m_currentPassage,
-        m_detectedEntities,
-        m_currentCategory
+        job->passage,
+        job->detectedEntities,
+        job->category
     );
 
-    m_claudeClient->enrichPassage(claudePrompt);
+    job->enrichmentProvider = "claude";
+    job->enrichmentModel = job->claudeClient->model();
+    job->enrichmentCacheKey = codex::db::EnrichmentCacheRepository::makeKey(
+        job->enrichmentProvider, job->enrichmentModel, claudePrompt);
+    if (!job->freshSample && applyCachedEnrichment(job)) return;
+
+    setState(job, PipelineState::EnrichingWithClaude, "Enrichissement avec Claude...");
+    emit progressUpdated(jobId, 20, "Appel Claude API");
+
+    job->claudeClient->enrichPassage(claudePrompt);
+}
+
+bool PipelineController::applyCachedEnrichment(PipelineJob* job) {
+    codex::db::EnrichmentCacheRepository cache;
+    auto cached = cache.findByKey(job->enrichmentCacheKey);
+    if (!cached) return false;
+
+    LOG_INFO(QString("Enrichment cache hit (job %1, %2)").arg(job->id).arg(job->enrichmentCacheKey.left(12)));
+
+    job->enrichedScene = cached->scene;
+    job->enrichedEmotion = cached->emotion.isEmpty() ? QString("mystique") : cached->emotion;
+    job->visualKeywords = cached->visualElements;
+    if (job->visualKeywords.isEmpty()) {
+        job->visualKeywords = job->detectedEntities;
+    }
+
+    emit progressUpdated(job->id, 50, "Enrichissement (cache)");
+    generateImage(job->id);
+    return true;
 }
 
-void PipelineController::onClaudeEnrichmentCompleted(const QJsonObject& response) {
-    if (m_cancelled) return;
+void PipelineController::storeEnrichment(const QString& cacheKey, const QString& provider,
+                                         const QString& model, const SceneEnrichment& enrichment) {
+    if (cacheKey.isEmpty() || !enrichment.isValid()) return;
 
-    LOG_INFO("Claude enrichment completed");
-    m_lastResult.claudeResponse = response;
+    codex::db::CachedEnrichment entry;
+    entry.cacheKey = cacheKey;
+    entry.provider = provider;
+    entry.model = model;
+    entry.scene = enrichment.scene;
+    entry.emotion = enrichment.emotion;
+    entry.visualElements = enrichment.visualElements;
+
+    codex::db::EnrichmentCacheRepository cache;
+    cache.store(entry);
+}
+
+void PipelineController::onClaudeEnrichmentCompleted(int jobId, const QJsonObject& response) {
+    PipelineJob* job = findJob(jobId);
+    if (!job) return;
+
+    LOG_INFO(QString("Claude enrichment completed (job %1)").arg(jobId));
+    job->result.claudeResponse = response;
 
     // Parse Claude response
-    m_enrichedScene = response["scene"].toString();
-    if (m_enrichedScene.isEmpty()) {
-        m_enrichedScene = response["text"].toString();
+    job->enrichedScene = response["scene"].toString();
+    if (job->enrichedScene.isEmpty()) {
+        job->enrichedScene = response["text"].toString();
     }
 
-    m_enrichedEmotion = response["emotion"].toString();
-    if (m_enrichedEmotion.isEmpty()) {
-        m_enrichedEmotion = "mystique";
+    job->enrichedEmotion = response["emotion"].toString();
+    if (job->enrichedEmotion.isEmpty()) {
+        job->enrichedEmotion = "mystique";
     }
 
     // Get visual elements
     QJsonArray visualElements = response["visual_elements"].toArray();
-    m_visualKeywords.clear();
+    job->visualKeywords.clear();
     for (const auto& elem : visualElements) {
-        m_visualKeywords.append(elem.toString());
+        job->visualKeywords.append(elem.toString());
+    }
+    if (job->visualKeywords.isEmpty()) {
+        job->visualKeywords = job->detectedEntities;
     }
-    if (m_visualKeywords.isEmpty()) {
-        m_visualKeywords = m_detectedEntities;
+
+    // Only structured answers are worth caching
+    if (response.contains("scene")) {
+        storeEnrichment(job->enrichmentCacheKey, job->enrichmentProvider, job->enrichmentModel,
+                        SceneEnrichment{job->enrichedScene, job->enrichedEmotion, job->visualKeywords});
     }
 
-    emit progressUpdated(50, "Enrichissement termine");
+    emit progressUpdated(jobId, 50, "Enrichissement termine");
 
     // Step 3: Generate image
-    generateImage();
+    generateImage(jobId);
 }
 
-void PipelineController::onClaudeError(const QString& error) {
-    if (m_cancelled) return;
+void PipelineController::onClaudeError(int jobId, const QString& error) {
+    PipelineJob* job = findJob(jobId);
+    if (!job) return;
 
     LOG_WARN(QString("Claude error: %1 - falling back to direct generation").arg(error));
 
     // Fallback: use passage directly
-    m_enrichedScene = m_currentPassage.left(500);
-    m_enrichedEmotion = "mystique";
-    m_visualKeywords = m_detectedEntities;
+    applyDirectFallback(job);
 
-    emit progressUpdated(50, "Enrichissement echoue, generation directe");
-    generateImage();
+    emit progressUpdated(jobId, 50, "Enrichissement echoue, generation directe");
+    generateImage(jobId);
 }
 
-void PipelineController::onGeminiEnrichmentCompleted(const QJsonObject& response) {
-    if (m_cancelled) return;
+void PipelineController::onGeminiEnrichmentCompleted(int jobId, const QJsonObject& response) {
+    PipelineJob* job = findJob(jobId);
+    if (!job) return;
 
-    LOG_INFO("Gemini enrichment completed");
-    m_lastResult.claudeResponse = response;  // Reuse same field for response
+    LOG_INFO(QString("Gemini enrichment completed (job %1)").arg(jobId));
+    job->result.claudeResponse = response;  // Reuse same field for response
 
     // Parse Gemini response - it returns text directly
     QString text = response["text"].toString();
@@ -277,66 +428,227 @@ void PipelineController::onGeminiEnrichmentCompleted(const QJsonObject& response
             QJsonDocument doc = QJsonDocument::fromJson(jsonStr.toUtf8());
             if (!doc.isNull()) {
                 QJsonObject parsed = doc.object();
-                m_enrichedScene = parsed["scene"].toString();
-                m_enrichedEmotion = parsed["emotion"].toString();
+                job->enrichedScene = parsed["scene"].toString();
+                job->enrichedEmotion = parsed["emotion"].toString();
                 QJsonArray visualElements = parsed["visual_elements"].toArray();
-                m_visualKeywords.clear();
+                job->visualKeywords.clear();
                 for (const auto& elem : visualElements) {
-                    m_visualKeywords.append(elem.toString());
+                    job->visualKeywords.append(elem.toString());
                 }
+
+                // Only structured answers are worth caching
+                storeEnrichment(job->enrichmentCacheKey, job->enrichmentProvider, job->enrichmentModel,
+                                SceneEnrichment{job->enrichedScene, job->enrichedEmotion, job->visualKeywords});
             }
         }
 
         // If parsing failed or no structured data, use text directly
-        if (m_enrichedScene.isEmpty()) {
-            m_enrichedScene = text.left(1000);
+        if (job->enrichedScene.isEmpty()) {
+            job->enrichedScene = text.left(1000);
         }
-        if (m_enrichedEmotion.isEmpty()) {
-            m_enrichedEmotion = "mystique";
+        if (job->enrichedEmotion.isEmpty()) {
+            job->enrichedEmotion = "mystique";
         }
-        if (m_visualKeywords.isEmpty()) {
-            m_visualKeywords = m_detectedEntities;
+        if (job->visualKeywords.isEmpty()) {
+            job->visualKeywords = job->detectedEntities;
         }
     } else {
-        m_enrichedScene = m_currentPassage.left(500);
-        m_enrichedEmotion = "mystique";
-        m_visualKeywords = m_detectedEntities;
+        applyDirectFallback(job);
     }
 
-    emit progressUpdated(50, "Enrichissement Gemini termine");
+    emit progressUpdated(jobId, 50, "Enrichissement Gemini termine");
 
     // Step 3: Generate image
-    generateImage();
+    generateImage(jobId);
 }
 
-void PipelineController::onGeminiError(const QString& error) {
-    if (m_cancelled) return;
+void PipelineController::onGeminiError(int jobId, const QString& error) {
+    PipelineJob* job = findJob(jobId);
+    if (!job) return;
 
     LOG_WARN(QString("Gemini error: %1 - falling back to direct generation").arg(error));
 
     // Fallback: use passage directly
-    m_enrichedScene = m_currentPassage.left(500);
-    m_enrichedEmotion = "mystique";
-    m_visualKeywords = m_detectedEntities;
+    applyDirectFallback(job);
 
-    emit progressUpdated(50, "Enrichissement Gemini echoue, generation directe");
-    generateImage();
+    emit progressUpdated(jobId, 50, "Enrichissement Gemini echoue, generation directe");
+    generateImage(jobId);
 }
 
-void PipelineController::generateImage() {
-    if (m_cancelled) return;
+int PipelineController::enrichBatch(const QStringList& segments,
+                                     const QString& treatiseCode,
+                                     const QString& category,
+                                     const codex::api::RequestTicket& ticket,
+                                     bool freshSample) {
+    auto* batch = new PipelineBatch();
+    batch->id = m_nextJobId++;
+    batch->segments = segments;
+    batch->category = resolveCategory(treatiseCode, category);
+    batch->scenes.resize(segments.size());
+    for (const QString& segment : segments) {
+        batch->detectedEntities.append(m_textParser->detectGnosticEntities(segment));
+    }
+    m_batches.insert(batch->id, batch);
+
+    const int batchId = batch->id;
+    auto& storage = codex::utils::SecureStorage::instance();
+    auto& config = codex::utils::Config::instance();
+
+    // One scene per segment: scale the output budget with the plate size
+    const int maxTokens = qBound(2048, 1024 + 400 * static_cast<int>(segments.size()), 16384);
+
+    if (config.llmProvider() == "gemini") {
+        batch->geminiClient = new codex::api::GeminiClient(this);
+        batch->geminiClient->setProvider(codex::api::GoogleAIProvider::AIStudio);
+        batch->geminiClient->setApiKey(storage.getApiKey(storage.SERVICE_AISTUDIO));
+        batch->geminiClient->setModel(config.geminiModel());
+        batch->geminiClient->setMaxTokens(maxTokens);
+        batch->geminiClient->setTicket(ticket);
+        batch->geminiClient->setCacheBypass(freshSample);
+        batch->provider = "gemini";
+        batch->model = batch->geminiClient->model();
+    } else {
+        batch->claudeClient = new codex::api::ClaudeClient(this);
+        batch->claudeClient->setApiKey(storage.getApiKey(storage.SERVICE_CLAUDE));
+        batch->claudeClient->setMaxTokens(maxTokens);
+        batch->claudeClient->setTicket(ticket);
+        batch->claudeClient->setCacheBypass(freshSample);
+        batch->provider = "claude";
+        batch->model = batch->claudeClient->model();
+    }
+
+    // Segments enriched before (alone or in a batch) come from the cache,
+    // keyed exactly like a single-passage request. A fresh sample keeps the
+    // keys so the new scenes replace the cached ones.
+    codex::db::EnrichmentCacheRepository cache;
+    for (int i = 0; i < segments.size(); ++i) {
+        QString key = codex::db::EnrichmentCacheRepository::makeKey(
+            batch->provider, batch->model,
+            m_promptBuilder->buildClaudePrompt(segments[i], batch->detectedEntities[i], batch->category));
+        batch->cacheKeys.append(key);
+
+        const auto cached = freshSample ? std::nullopt : cache.findByKey(key);
+        if (cached) {
+            batch->scenes[i] = SceneEnrichment{cached->scene, cached->emotion, cached->visualElements};
+        } else {
+            batch->pendingIndexes.append(i);
+        }
+    }
+
+    LOG_INFO(QString("Batch enrichment %1: %2 segments (%3 cached), category: %4")
+             .arg(batchId).arg(segments.size())
+             .arg(segments.size() - batch->pendingIndexes.size())
+             .arg(batch->category));
+
+    // Everything cached, or no LLM configured (jobs then use their usual
+    // direct fallback). Deferred so the caller can register the batch id first.
+    const bool configured = batch->geminiClient ? batch->geminiClient->isConfigured()
+                                                : batch->claudeClient->isConfigured();
+    if (batch->pendingIndexes.isEmpty() || !configured) {
+        if (!configured) {
+            LOG_WARN("Batch enrichment: LLM not configured, skipping");
+        }
+        QTimer::singleShot(0, this, [this, batchId]() { finishBatch(batchId); });
+        return batchId;
+    }
+
+    QStringList pendingSegments;
+    QList<QStringList> pendingEntities;
+    for (int index : std::as_const(batch->pendingIndexes)) {
+        pendingSegments.append(segments[index]);
+        pendingEntities.append(batch->detectedEntities[index]);
+    }
+    QString prompt = m_promptBuilder->buildBatchClaudePrompt(
+        pendingSegments, pendingEntities, batch->category);
+
+    auto onError = [this, batchId](const QString& error) {
+        LOG_WARN(QString("Batch enrichment %1 failed: %2 - falling back to per-segment").arg(batchId).arg(error));
+        finishBatch(batchId);
+    };
+
+    if (batch->geminiClient) {
+        connect(batch->geminiClient, &codex::api::GeminiClient::enrichmentCompleted,
+                this, [this, batchId](const QJsonObject& response) { onBatchEnrichmentCompleted(batchId, response); });
+        connect(batch->geminiClient, &codex::api::GeminiClient::errorOccurred, this, onError);
+        batch->geminiClient->enrichPassage(prompt);
+    } else {
+        connect(batch->claudeClient, &codex::api::ClaudeClient::enrichmentCompleted,
+                this, [this, batchId](const QJsonObject& response) { onBatchEnrichmentCompleted(batchId, response); });
+        connect(batch->claudeClient, &codex::api::ClaudeClient::errorOccurred, this, onError);
+        batch->claudeClient->enrichPassage(prompt);
+    }
+    return batchId;
+}
+
+void PipelineController::onBatchEnrichmentCompleted(int batchId, const QJsonObject& response) {
+    PipelineBatch* batch = m_batches.value(batchId, nullptr);
+    if (!batch) return;
+
+    // Both clients return the raw model text under "text"; extract the JSON array
+    QString text = response["text"].toString();
+    int start = text.indexOf('[');
+    int end = text.lastIndexOf(']');
+    QJsonArray items;
+    if (start >= 0 && end > start) {
+        items = QJsonDocument::fromJson(text.mid(start, end - start + 1).toUtf8()).array();
+    }
+
+    // Indexes in the answer refer to the pending segments sent in the prompt
+    int parsed = 0;
+    for (int i = 0; i < items.size(); ++i) {
+        QJsonObject item = items[i].toObject();
+        int pending = item["index"].toInt(i + 1) - 1;
+        if (pending < 0 || pending >= batch->pendingIndexes.size()) continue;
+        int index = batch->pendingIndexes[pending];
+
+        SceneEnrichment scene;
+        scene.scene = item["scene"].toString();
+        scene.emotion = item["emotion"].toString();
+        for (const auto& elem : item["visual_elements"].toArray()) {
+            scene.visualElements.append(elem.toString());
+        }
+        if (!scene.isValid()) continue;
+
+        batch->scenes[index] = scene;
+        storeEnrichment(batch->cacheKeys[index], batch->provider, batch->model, scene);
+        parsed++;
+    }
+
+    LOG_INFO(QString("Batch enrichment %1 completed: %2/%3 scenes parsed")
+             .arg(batchId).arg(parsed).arg(batch->pendingIndexes.size()));
+
+    finishBatch(batchId);
+}
+
+void PipelineController::finishBatch(int batchId) {
+    PipelineBatch* batch = m_batches.take(batchId);
+    if (!batch) return;
+
+    if (batch->claudeClient) batch->claudeClient->deleteLater();
+    if (batch->geminiClient) batch->geminiClient->deleteLater();
+
+    // One entry per segment, invalid where nothing was produced
+    QVector<SceneEnrichment> scenes = batch->scenes;
+    delete batch;
+
+    emit batchEnrichmentCompleted(batchId, scenes);
+}
+
+void PipelineController::generateImage(int jobId) {
+    PipelineJob* job = findJob(jobId);
+    if (!job) return;
 
     // Check if Imagen is configured
-    if (!m_imagenClient->isConfigured()) {
-        finishWithError("Cle API Imagen non configuree. Veuillez configurer votre cle dans les parametres.");
+    if (!job->imagenClient->isConfigured()) {
+        finishWithError(jobId, "Cle API Imagen non configuree. Veuillez configurer votre cle dans les parametres.");
         return;
     }
 
-    setState(PipelineState::GeneratingImage, "Generation de l'image...");
-    emit progressUpdated(60, "Appel Imagen API");
+    setState(job, PipelineState::GeneratingImage, "Generation de l'image...");
+    emit progressUpdated(jobId, 60, "Appel Imagen API");
 
     // Get category style from MythicClassifier
-    MythicCategory mythicCat = m_mythicClassifier->classifyTreatise(m_currentTreatiseCode);
+    MythicCategory mythicCat = m_mythicClassifier->classifyTreatise(job->treatiseCode);
     CategoryStyle style = m_mythicClassifier->getStyleForCategory(mythicCat);
 
     // Build palette from category or use default
@@ -350,7 +662,7 @@ void PipelineController::generateImage() {
     }
 
     // Merge visual keywords from category with detected entities
-    QStringList allVisualKeywords = m_visualKeywords;
+    QStringList allVisualKeywords = job->visualKeywords;
     for (const QString& kw : style.visualKeywords) {
         if (!allVisualKeywords.contains(kw)) {
             allVisualKeywords.append(kw);
@@ -358,76 +670,92 @@ void PipelineController::generateImage() {
     }
 
     // Add lighting style to emotion/mood
-    QString enrichedEmotion = m_enrichedEmotion;
+    QString enrichedEmotion = job->enrichedEmotion;
     if (!style.lightingStyle.isEmpty()) {
         enrichedEmotion += ", " + style.lightingStyle;
     }
 
     QString imagenPrompt = m_promptBuilder->buildImagenPrompt(
-        m_enrichedScene,
+        job->enrichedScene,
         enrichedEmotion,
         allVisualKeywords,
         palette
     );
 
-    m_lastResult.imagenPrompt = imagenPrompt;
+    job->result.imagenPrompt = imagenPrompt;
     LOG_INFO(QString("Imagen prompt (category: %1): %2").arg(style.name).arg(imagenPrompt.left(200)));
 
     // Generate image
     codex::api::ImageGenerationParams params;
     params.prompt = imagenPrompt;
     params.aspectRatio = "16:9";
-    params.numberOfImages = 1;
+    params.numberOfImages = job->sampleCount;
 
-    m_imagenClient->generateImage(params);
+    job->imagenClient->generateImage(params);
 }
 
-void PipelineController::onImagenProgress(int percent) {
-    if (m_cancelled) return;
+void PipelineController::onImagenProgress(int jobId, int percent) {
+    if (!findJob(jobId)) return;
 
     // Map Imagen progress (0-100) to overall progress (60-95)
     int overallProgress = 60 + (percent * 35 / 100);
-    emit progressUpdated(overallProgress, QString("Generation: %1%").arg(percent));
+    emit progressUpdated(jobId, overallProgress, QString("Generation: %1%").arg(percent));
 }
 
-void PipelineController::onImagenImageGenerated(const QPixmap& image, const QString& prompt) {
-    if (m_cancelled) return;
+void PipelineController::onImagenImagesGenerated(int jobId, const QList<QPixmap>& images, const QString& prompt) {
+    PipelineJob* job = findJob(jobId);
+    if (!job) return;
 
-    LOG_INFO(QString("Image generated: %1x%2").arg(image.width()).arg(image.height()));
-    m_lastResult.enrichedPrompt = prompt;
+    LOG_INFO(QString("Images generated (job %1): %2 of %3 requested, %4x%5")
+             .arg(jobId).arg(images.size()).arg(job->sampleCount)
+             .arg(images.first().width()).arg(images.first().height()));
+    job->result.enrichedPrompt = prompt;
 
-    finishWithSuccess(image);
+    finishWithSuccess(jobId, images);
 }
 
-void PipelineController::onImagenError(const QString& error) {
-    if (m_cancelled) return;
+void PipelineController::onImagenError(int jobId, const QString& error) {
+    if (!findJob(jobId)) return;
 
-    finishWithError(QString("Erreur Imagen: %1").arg(error));
+    finishWithError(jobId, QString("Erreur Imagen: %1").arg(error));
 }
 
-void PipelineController::finishWithError(const QString& error) {
-    m_lastResult.success = false;
-    m_lastResult.errorMessage = error;
+void PipelineController::finishWithError(int jobId, const QString& error) {
+    PipelineJob* job = findJob(jobId);
+    if (!job) return;
+
+    job->result.success = false;
+    job->result.errorMessage = error;
+    m_lastResult = job->result;
 
-    setState(PipelineState::Failed, error);
-    emit progressUpdated(0, "Echec");
-    emit generationFailed(error);
+    setState(job, PipelineState::Failed, error);
+    releaseJob(jobId);
 
-    LOG_ERROR(QString("Pipeline failed: %1").arg(error));
+    emit progressUpdated(jobId, 0, "Echec");
+    emit generationFailed(jobId, error);
+
+    LOG_ERROR(QString("Pipeline job %1 failed: %2").arg(jobId).arg(error));
 }
 
-void PipelineController::finishWithSuccess(const QPixmap& image) {
-    m_lastResult.success = true;
-    m_lastResult.generatedImage = image;
+void PipelineController::finishWithSuccess(int jobId, const QList<QPixmap>& images) {
+    PipelineJob* job = findJob(jobId);
+    if (!job) return;
+
+    const QPixmap image = images.first();
+    job->result.success = true;
+    job->result.generatedImage = image;
+    job->result.variants = images;
+    m_lastResult = job->result;
+
+    setState(job, PipelineState::Completed, "Generation terminee");
+    releaseJob(jobId);
 
-    setState(PipelineState::Completed, "Generation terminee");
-    emit progressUpdated(100, "Termine");
+    emit progressUpdated(jobId, 100, "Termine");
 
-    LOG_INFO(QString("PipelineController %1 emitting generationCompleted, image %2x%3")
-             .arg(reinterpret_cast<quintptr>(this))
-             .arg(image.width()).arg(image.height()));
+    LOG_INFO(QString("PipelineController job %1 emitting generationCompleted, image %2x%3")
+             .arg(jobId).arg(image.width()).arg(image.height()));
 
-    emit generationCompleted(image, m_lastResult.imagenPrompt);
+    emit generationCompleted(jobId, image, m_lastResult.imagenPrompt, images);
 
     LOG_INFO("Pipeline completed successfully");
 }
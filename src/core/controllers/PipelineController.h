@@ -1,9 +1,14 @@
 #pragma once
 
+#include "api/RequestQueue.h"
+
 #include <QObject>
 #include <QPixmap>
 #include <QString>
 #include <QJsonObject>
+#include <QHash>
+#include <QPointer>
+#include <QVector>
 
 namespace codex::api {
 class ClaudeClient;
@@ -34,11 +39,67 @@ struct PipelineResult {
     bool success = false;
     QString errorMessage;
     QPixmap generatedImage;
+    QList<QPixmap> variants;    // every sample returned, generatedImage is the first
     QString enrichedPrompt;
     QString imagenPrompt;
     QJsonObject claudeResponse;
 };
 
+// Scene enrichment produced by the LLM for one passage or plate segment
+struct SceneEnrichment {
+    QString scene;
+    QString emotion;
+    QStringList visualElements;
+
+    bool isValid() const { return !scene.isEmpty(); }
+};
+
+// Context of a single pipeline job. Each job owns its state machine and its
+// API clients so that several jobs can be in flight without cross-talk.
+struct PipelineJob {
+    int id = 0;
+    PipelineState state = PipelineState::Idle;
+    PipelineResult result;
+
+    QString passage;
+    QString treatiseCode;
+    QString category;
+    int sampleCount = 1;
+    codex::api::RequestTicket ticket;
+    bool freshSample = false;   // New enrichment and images, skipping the caches
+    QStringList detectedEntities;
+    QString enrichedScene;
+    QString enrichedEmotion;
+    QStringList visualKeywords;
+
+    // Enrichment cache entry for this job's LLM request
+    QString enrichmentCacheKey;
+    QString enrichmentProvider;
+    QString enrichmentModel;
+
+    QPointer<codex::api::ClaudeClient> claudeClient;
+    QPointer<codex::api::GeminiClient> geminiClient;
+    QPointer<codex::api::ImagenClient> imagenClient;
+};
+
+// Context of a batch enrichment: one LLM request covering every segment of a plate
+struct PipelineBatch {
+    int id = 0;
+    QStringList segments;
+    QString category;
+    QList<QStringList> detectedEntities;
+
+    // Cached scenes are filled in up front; only pendingIndexes go to the LLM
+    QVector<SceneEnrichment> scenes;
+    QStringList cacheKeys;
+    QList<int> pendingIndexes;
+    QString provider;
+    QString model;
+
+    QPointer<codex::api::ClaudeClient> claudeClient;
+    QPointer<codex::api::GeminiClient> geminiClient;
+};
+
 class PipelineController : public QObject {
     Q_OBJECT
 
@@ -46,65 +107,94 @@ public:
     explicit PipelineController(QObject* parent = nullptr);
     ~PipelineController();
 
-    // Start the generation pipeline
-    void startGeneration(const QString& passageText,
-                         const QString& treatiseCode = QString(),
-                         const QString& category = QString());
-
-    // Cancel ongoing generation
-    void cancel();
-
-    // Get current state
-    PipelineState state() const { return m_state; }
+    // Start a generation job, returns its id. Jobs run concurrently and
+    // every signal below carries the id of the job it belongs to.
+    // A valid enrichment skips the LLM step and goes straight to Imagen.
+    // sampleCount (1-4) asks Imagen for several variants of the same scene
+    // in one request; all of them are reported by generationCompleted.
+    // ticket places the job's requests in the RequestQueue. freshSample asks
+    // the LLM and Imagen again even when the enrichment or the images are cached.
+    int startGeneration(const QString& passageText,
+                        const QString& treatiseCode = QString(),
+                        const QString& category = QString(),
+                        const SceneEnrichment& enrichment = SceneEnrichment(),
+                        int sampleCount = 1,
+                        const codex::api::RequestTicket& ticket = codex::api::RequestTicket(),
+                        bool freshSample = false);
+
+    // Enrich all segments of a plate with a single LLM request. Emits
+    // batchEnrichmentCompleted with one entry per segment; entries the LLM
+    // did not provide are left invalid so the caller can enrich them per job.
+    // Segments found in the enrichment cache are not sent to the LLM again,
+    // unless freshSample asks for new scenes as in startGeneration.
+    int enrichBatch(const QStringList& segments,
+                    const QString& treatiseCode = QString(),
+                    const QString& category = QString(),
+                    const codex::api::RequestTicket& ticket = codex::api::RequestTicket(),
+                    bool freshSample = false);
+
+    // Cancel every job and pending batch in flight
+    void cancelAll();
+
+    // Job state (Idle for unknown or already finished jobs)
+    PipelineState state(int jobId) const;
+    bool isRunning(int jobId) const;
     bool isRunning() const;
+    int activeJobCount() const { return m_jobs.size(); }
 
-    // Get last result
+    // Get result of the last finished job
     PipelineResult lastResult() const { return m_lastResult; }
 
 signals:
-    void stateChanged(PipelineState state, const QString& message);
-    void progressUpdated(int percent, const QString& step);
-    void generationCompleted(const QPixmap& image, const QString& prompt);
-    void generationFailed(const QString& error);
-
-private slots:
-    void onClaudeEnrichmentCompleted(const QJsonObject& response);
-    void onClaudeError(const QString& error);
-    void onGeminiEnrichmentCompleted(const QJsonObject& response);
-    void onGeminiError(const QString& error);
-    void onImagenImageGenerated(const QPixmap& image, const QString& prompt);
-    void onImagenError(const QString& error);
-    void onImagenProgress(int percent);
+    void stateChanged(int jobId, PipelineState state, const QString& message);
+    void progressUpdated(int jobId, int percent, const QString& step);
+    // image is the first sample, variants holds every sample (including image)
+    void generationCompleted(int jobId, const QPixmap& image, const QString& prompt,
+                             const QList<QPixmap>& variants);
+    void generationFailed(int jobId, const QString& error);
+    void batchEnrichmentCompleted(int batchId, const QVector<codex::core::SceneEnrichment>& scenes);
+    // Pending batch dropped by cancelAll; batchEnrichmentCompleted never follows
+    void batchEnrichmentCancelled(int batchId);
 
 private:
-    void setState(PipelineState state, const QString& message = QString());
-    void analyzePassage();
-    void enrichWithClaude();
-    void generateImage();
-    void finishWithError(const QString& error);
-    void finishWithSuccess(const QPixmap& image);
-
-    // Components
-    codex::api::ClaudeClient* m_claudeClient = nullptr;
-    codex::api::GeminiClient* m_geminiClient = nullptr;
-    codex::api::ImagenClient* m_imagenClient = nullptr;
+    PipelineJob* findJob(int jobId) const;
+    void createJobClients(PipelineJob* job);
+    void releaseJob(int jobId);
+
+    void setState(PipelineJob* job, PipelineState state, const QString& message = QString());
+    void analyzePassage(int jobId);
+    void enrichWithClaude(int jobId);
+    void generateImage(int jobId);
+    void applyDirectFallback(PipelineJob* job);
+    bool applyCachedEnrichment(PipelineJob* job);
+    void storeEnrichment(const QString& cacheKey, const QString& provider,
+                         const QString& model, const SceneEnrichment& enrichment);
+    void finishWithError(int jobId, const QString& error);
+    void finishWithSuccess(int jobId, const QList<QPixmap>& images);
+
+    void onClaudeEnrichmentCompleted(int jobId, const QJsonObject& response);
+    void onClaudeError(int jobId, const QString& error);
+    void onGeminiEnrichmentCompleted(int jobId, const QJsonObject& response);
+    void onGeminiError(int jobId, const QString& error);
+    void onImagenImagesGenerated(int jobId, const QList<QPixmap>& images, const QString& prompt);
+    void onImagenError(int jobId, const QString& error);
+    void onImagenProgress(int jobId, int percent);
+
+    QString resolveCategory(const QString& treatiseCode, const QString& category) const;
+    void onBatchEnrichmentCompleted(int batchId, const QJsonObject& response);
+    void finishBatch(int batchId);
+
+    // Shared, stateless components
     TextParser* m_textParser = nullptr;
     PromptBuilder* m_promptBuilder = nullptr;
     MythicClassifier* m_mythicClassifier = nullptr;
 
-    // State
-    PipelineState m_state = PipelineState::Idle;
+    // Jobs in flight, keyed by job id
+    QHash<int, PipelineJob*> m_jobs;
+    QHash<int, PipelineBatch*> m_batches;
+    int m_nextJobId = 1;
+
     PipelineResult m_lastResult;
-    bool m_cancelled = false;
-
-    // Current generation context
-    QString m_currentPassage;
-    QString m_currentTreatiseCode;
-    QString m_currentCategory;
-    QStringList m_detectedEntities;
-    QString m_enrichedScene;
-    QString m_enrichedEmotion;
-    QStringList m_visualKeywords;
 };
 
 } // namespace codex::core
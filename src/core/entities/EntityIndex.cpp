@@ -0,0 +1,167 @@
+#include "EntityIndex.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace codex::core {
+
+void EntityIndex::reset(const QStringList& entityNames, const QStringList& treatiseCodes) {
+    m_entityNames = entityNames;
+    m_treatiseCodes = treatiseCodes;
+    m_postings = QVector<PostingList>(entityNames.size());
+    m_counts = QVector<QVector<int>>(entityNames.size(), QVector<int>(treatiseCodes.size(), 0));
+    m_totalPostings = 0;
+}
+
+void EntityIndex::addPage(int treatise, int page, qsizetype pageOffset, const QVector<EntityMatch>& matches) {
+    for (const EntityMatch& match : matches) {
+        const int entity = m_entityNames.indexOf(match.name);
+        if (entity < 0) continue;
+
+        PostingList& list = m_postings[entity];
+        for (const EntityOccurrence& occurrence : match.occurrences) {
+            list.treatises.append(quint16(treatise));
+            list.pages.append(quint16(page));
+            list.offsets.append(quint32(pageOffset + occurrence.position));
+            list.lengths.append(quint16(occurrence.length));
+        }
+
+        if (treatise >= 0 && treatise < m_treatiseCodes.size()) {
+            m_counts[entity][treatise] += match.count();
+        }
+        m_totalPostings += match.count();
+    }
+}
+
+void EntityIndex::finish() {
+    for (PostingList& list : m_postings) {
+        if (!std::is_sorted(list.offsets.cbegin(), list.offsets.cend())) {
+            QVector<int> order(list.offsets.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), [&list](int a, int b) {
+                return list.offsets[a] < list.offsets[b];
+            });
+
+            PostingList sorted;
+            for (int i : order) {
+                sorted.treatises.append(list.treatises[i]);
+                sorted.pages.append(list.pages[i]);
+                sorted.offsets.append(list.offsets[i]);
+                sorted.lengths.append(list.lengths[i]);
+            }
+            list = sorted;
+        }
+
+        list.treatises.squeeze();
+        list.pages.squeeze();
+        list.offsets.squeeze();
+        list.lengths.squeeze();
+    }
+}
+
+int EntityIndex::occurrenceCount(int entity) const {
+    if (entity < 0 || entity >= m_postings.size()) return 0;
+    return m_postings[entity].offsets.size();
+}
+
+int EntityIndex::occurrenceCount(int entity, int treatise) const {
+    if (entity < 0 || entity >= m_counts.size()) return 0;
+    return m_counts[entity].value(treatise);
+}
+
+QVector<EntityPosting> EntityIndex::postings(int entity) const {
+    QVector<EntityPosting> result;
+    if (entity < 0 || entity >= m_postings.size()) return result;
+
+    const PostingList& list = m_postings[entity];
+    result.reserve(list.offsets.size());
+    for (qsizetype i = 0; i < list.offsets.size(); ++i) {
+        result.append({list.treatises[i], list.pages[i], list.offsets[i], list.lengths[i]});
+    }
+    return result;
+}
+
+QVector<int> EntityIndex::treatisesMentioning(const QVector<int>& entities) const {
+    QVector<int> treatises;
+    if (entities.isEmpty()) return treatises;
+
+    for (int treatise = 0; treatise < m_treatiseCodes.size(); ++treatise) {
+        const bool all = std::all_of(entities.cbegin(), entities.cend(), [&](int entity) {
+            return occurrenceCount(entity, treatise) > 0;
+        });
+        if (all) treatises.append(treatise);
+    }
+    return treatises;
+}
+
+qsizetype EntityIndex::nearest(const PostingList& list, int treatise, qsizetype offset, int maxDistance) const {
+    // Treatises cover contiguous page ranges: the nearest posting on each side
+    // is the only candidate, anything further lies outside the window
+    const auto it = std::lower_bound(list.offsets.cbegin(), list.offsets.cend(), quint32(offset));
+    const qsizetype right = it - list.offsets.cbegin();
+
+    qsizetype best = -1;
+    qsizetype bestDistance = maxDistance + 1;
+    for (qsizetype i : {right - 1, right}) {
+        if (i < 0 || i >= list.offsets.size() || list.treatises[i] != treatise) continue;
+
+        const qsizetype distance = qAbs(qsizetype(list.offsets[i]) - offset);
+        if (distance < bestDistance) {
+            best = i;
+            bestDistance = distance;
+        }
+    }
+    return best;
+}
+
+QVector<EntityPassage> EntityIndex::findNear(const QVector<int>& entities, int maxDistance, int limit) const {
+    QVector<EntityPassage> passages;
+
+    QVector<int> ids;
+    for (int entity : entities) {
+        if (entity < 0 || entity >= m_postings.size() || m_postings[entity].offsets.isEmpty()) {
+            return passages;
+        }
+        if (!ids.contains(entity)) ids.append(entity);
+    }
+    if (ids.isEmpty()) return passages;
+
+    // Anchor on the rarest entity
+    const int anchor = *std::min_element(ids.cbegin(), ids.cend(), [this](int a, int b) {
+        return m_postings[a].offsets.size() < m_postings[b].offsets.size();
+    });
+    const PostingList& anchors = m_postings[anchor];
+
+    qsizetype lastEnd = -1;
+    for (qsizetype i = 0; i < anchors.offsets.size(); ++i) {
+        const int treatise = anchors.treatises[i];
+        const qsizetype offset = anchors.offsets[i];
+        if (offset < lastEnd) continue;
+
+        EntityPassage passage{treatise, anchors.pages[i], offset, offset + anchors.lengths[i]};
+        bool complete = true;
+
+        for (int entity : ids) {
+            if (entity == anchor) continue;
+
+            const PostingList& list = m_postings[entity];
+            const qsizetype j = nearest(list, treatise, offset, maxDistance);
+            if (j < 0) {
+                complete = false;
+                break;
+            }
+            passage.start = qMin(passage.start, qsizetype(list.offsets[j]));
+            passage.end = qMax(passage.end, qsizetype(list.offsets[j]) + list.lengths[j]);
+        }
+
+        if (!complete) continue;
+
+        passages.append(passage);
+        lastEnd = passage.end;
+        if (limit > 0 && passages.size() >= limit) break;
+    }
+
+    return passages;
+}
+
+} // namespace codex::core
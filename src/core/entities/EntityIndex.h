@@ -0,0 +1,76 @@
+#pragma once
+
+#include "EntityMatcher.h"
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+namespace codex::core {
+
+// Position of one entity occurrence in the Codex
+struct EntityPosting {
+    int treatise = -1;          // index in the table of contents
+    int page = 0;               // file page
+    qsizetype offset = 0;       // in the parser's raw content
+    int length = 0;
+};
+
+// Passage where all queried entities occur close together
+struct EntityPassage {
+    int treatise = -1;
+    int page = 0;               // page of the anchor occurrence
+    qsizetype start = 0;        // raw content range covering the occurrences
+    qsizetype end = 0;
+};
+
+// Corpus-wide index of entity occurrences, built once when the Codex is loaded.
+// Postings are kept per entity in parallel arrays sorted by offset, so counts,
+// treatise filters and proximity queries never rescan the text.
+class EntityIndex {
+public:
+    void reset(const QStringList& entityNames, const QStringList& treatiseCodes);
+
+    // Occurrences found in one page of a treatise
+    void addPage(int treatise, int page, qsizetype pageOffset, const QVector<EntityMatch>& matches);
+
+    // Sorts postings if pages were not added in text order and releases spare capacity
+    void finish();
+
+    bool isEmpty() const { return m_totalPostings == 0; }
+    int postingCount() const { return m_totalPostings; }
+
+    int entityCount() const { return m_entityNames.size(); }
+    QString entityName(int entity) const { return m_entityNames.value(entity); }
+    QString treatiseCode(int treatise) const { return m_treatiseCodes.value(treatise); }
+
+    int occurrenceCount(int entity) const;
+    int occurrenceCount(int entity, int treatise) const;
+    QVector<EntityPosting> postings(int entity) const;
+
+    // Treatises in which every entity occurs
+    QVector<int> treatisesMentioning(const QVector<int>& entities) const;
+
+    // Passages where every entity occurs within maxDistance characters of an
+    // occurrence of the rarest one, in text order and without overlaps
+    QVector<EntityPassage> findNear(const QVector<int>& entities, int maxDistance, int limit = 100) const;
+
+private:
+    struct PostingList {
+        QVector<quint16> treatises;
+        QVector<quint16> pages;
+        QVector<quint32> offsets;
+        QVector<quint16> lengths;
+    };
+
+    // Posting of the entity nearest to offset within the same treatise, -1 if none
+    qsizetype nearest(const PostingList& list, int treatise, qsizetype offset, int maxDistance) const;
+
+    QStringList m_entityNames;
+    QStringList m_treatiseCodes;
+    QVector<PostingList> m_postings;
+    QVector<QVector<int>> m_counts;     // entity -> occurrences per treatise
+    int m_totalPostings = 0;
+};
+
+} // namespace codex::core
@@ -0,0 +1,212 @@
+#include "EntityMatcher.h"
+
+#include <QQueue>
+
+#include <algorithm>
+#include <array>
+
+namespace codex::core {
+
+namespace {
+
+QChar foldUncached(QChar c) {
+    if (c.isSpace()) return u' ';
+
+    switch (c.unicode()) {
+    case 0x2018: case 0x2019: case 0x02BC:      // typographic apostrophes
+        return u'\'';
+    case 0x2010: case 0x2011: case 0x2012: case 0x2013: case 0x2014: case 0x2015:
+        return u'-';
+    default:
+        break;
+    }
+
+    c = c.toLower();
+    if (c.decompositionTag() == QChar::Canonical) {
+        const QString base = c.decomposition();
+        if (!base.isEmpty() && !base.at(0).isSurrogate()) c = base.at(0);
+    }
+    return c;
+}
+
+} // namespace
+
+QChar EntityMatcher::fold(QChar c) {
+    // Latin-1 and Latin Extended cover nearly all of the texts
+    static const auto table = []() {
+        std::array<char16_t, 0x250> folded{};
+        for (char16_t u = 0; u < folded.size(); ++u) {
+            folded[u] = foldUncached(QChar(u)).unicode();
+        }
+        return folded;
+    }();
+
+    if (c.unicode() < table.size()) return QChar(table[c.unicode()]);
+    if (c.isSurrogate()) return c;
+    return foldUncached(c);
+}
+
+QString EntityMatcher::fold(QStringView text) {
+    QString folded(text.size(), Qt::Uninitialized);
+    for (qsizetype i = 0; i < text.size(); ++i) {
+        folded[i] = fold(text[i]);
+    }
+    return folded;
+}
+
+int EntityMatcher::entityId(QStringView term) const {
+    const QString folded = fold(term.trimmed());
+    if (folded.isEmpty() || m_nodes.isEmpty()) return -1;
+
+    const auto name = m_nameIds.constFind(folded);
+    if (name != m_nameIds.constEnd()) return name.value();
+
+    // Whole keyword: walk the trie
+    int node = 0;
+    for (QChar c : folded) {
+        node = child(node, c.unicode());
+        if (node < 0) return -1;
+    }
+    const auto& keywords = m_nodes[node].keywords;
+    return keywords.isEmpty() ? -1 : m_keywordEntity[keywords.first()];
+}
+
+int EntityMatcher::child(int node, char16_t c) const {
+    for (const auto& edge : m_nodes[node].next) {
+        if (edge.first == c) return edge.second;
+    }
+    return -1;
+}
+
+void EntityMatcher::build(const QMap<QString, QStringList>& keywordsByEntity) {
+    m_nodes.clear();
+    m_nodes.append(Node());
+    m_keywordEntity.clear();
+    m_keywordLengths.clear();
+    m_entityNames = keywordsByEntity.keys();
+    m_nameIds.clear();
+    for (int i = 0; i < m_entityNames.size(); ++i) {
+        m_nameIds.insert(fold(m_entityNames[i]), i);
+    }
+
+    // Trie of folded keywords
+    int entity = 0;
+    for (auto it = keywordsByEntity.constBegin(); it != keywordsByEntity.constEnd(); ++it, ++entity) {
+        for (const QString& keyword : it.value()) {
+            const QString trimmed = keyword.trimmed();
+            if (trimmed.isEmpty()) continue;
+
+            int node = 0;
+            for (QChar c : trimmed) {
+                const char16_t folded = fold(c).unicode();
+                int next = child(node, folded);
+                if (next < 0) {
+                    next = m_nodes.size();
+                    m_nodes.append(Node());
+                    m_nodes[node].next.append({folded, next});
+                }
+                node = next;
+            }
+
+            m_nodes[node].keywords.append(m_keywordEntity.size());
+            m_keywordEntity.append(entity);
+            m_keywordLengths.append(trimmed.size());
+        }
+    }
+
+    // Failure and output links, breadth first
+    QQueue<int> queue;
+    for (const auto& edge : m_nodes[0].next) {
+        queue.enqueue(edge.second);
+    }
+
+    while (!queue.isEmpty()) {
+        const int node = queue.dequeue();
+        for (const auto& edge : m_nodes[node].next) {
+            const int target = edge.second;
+
+            int fail = m_nodes[node].fail;
+            int next = child(fail, edge.first);
+            while (next < 0 && fail != 0) {
+                fail = m_nodes[fail].fail;
+                next = child(fail, edge.first);
+            }
+            m_nodes[target].fail = (next >= 0 && next != target) ? next : 0;
+
+            const Node& failNode = m_nodes[m_nodes[target].fail];
+            m_nodes[target].output = failNode.keywords.isEmpty() ? failNode.output : m_nodes[target].fail;
+
+            queue.enqueue(target);
+        }
+    }
+}
+
+QVector<EntityMatch> EntityMatcher::match(QStringView text) const {
+    struct Hit {
+        qsizetype position;
+        qsizetype length;
+        int entity;
+    };
+    QVector<Hit> hits;
+    if (m_nodes.isEmpty()) return {};
+
+    int state = 0;
+    for (qsizetype i = 0; i < text.size(); ++i) {
+        const char16_t c = fold(text[i]).unicode();
+
+        int next = child(state, c);
+        while (next < 0 && state != 0) {
+            state = m_nodes[state].fail;
+            next = child(state, c);
+        }
+        state = next < 0 ? 0 : next;
+
+        int node = m_nodes[state].keywords.isEmpty() ? m_nodes[state].output : state;
+        for (; node > 0; node = m_nodes[node].output) {
+            for (int keyword : m_nodes[node].keywords) {
+                const qsizetype length = m_keywordLengths[keyword];
+                const qsizetype start = i + 1 - length;
+
+                // Whole words only
+                if (start > 0 && isWordChar(text[start - 1])) continue;
+                if (i + 1 < text.size() && isWordChar(text[i + 1])) continue;
+
+                hits.append({start, length, m_keywordEntity[keyword]});
+            }
+        }
+    }
+
+    // Leftmost-longest per entity: "pistis sophia" counts once, not twice
+    std::sort(hits.begin(), hits.end(), [](const Hit& a, const Hit& b) {
+        if (a.entity != b.entity) return a.entity < b.entity;
+        if (a.position != b.position) return a.position < b.position;
+        return a.length > b.length;
+    });
+
+    QVector<EntityMatch> matches;
+    int entity = -1;
+    qsizetype entityEnd = 0;
+    for (const Hit& hit : hits) {
+        if (hit.entity != entity) {
+            entity = hit.entity;
+            entityEnd = 0;
+            matches.append({m_entityNames[entity], {}});
+        }
+        if (hit.position < entityEnd) continue;
+
+        matches.last().occurrences.append({hit.position, hit.length});
+        entityEnd = hit.position + hit.length;
+    }
+
+    return matches;
+}
+
+QStringList EntityMatcher::detect(QStringView text) const {
+    QStringList names;
+    for (const EntityMatch& found : match(text)) {
+        names.append(found.name);
+    }
+    return names;
+}
+
+} // namespace codex::core
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <QVarLengthArray>
+#include <QVector>
+
+namespace codex::core {
+
+// One keyword occurrence, in positions of the analysed text
+struct EntityOccurrence {
+    qsizetype position = 0;
+    qsizetype length = 0;
+};
+
+struct EntityMatch {
+    QString name;
+    QVector<EntityOccurrence> occurrences;     // in text order, non-overlapping
+
+    int count() const { return occurrences.size(); }
+};
+
+// Aho-Corasick automaton over the keywords of every entity.
+// Built once from the keyword table, it finds all entities in a single pass
+// over the text. Matching ignores case and accents ("plerome" finds
+// "Plérôme") and only accepts whole words or phrases.
+class EntityMatcher {
+public:
+    // Entity name -> keywords
+    void build(const QMap<QString, QStringList>& keywordsByEntity);
+
+    bool isEmpty() const { return m_keywordLengths.isEmpty(); }
+
+    QStringList entityNames() const { return m_entityNames; }
+
+    // Entity named or keyed by the term ("demiurge", "Yaldabaoth"), -1 if none
+    int entityId(QStringView term) const;
+
+    // Entities found in the text with all their occurrences, in entity order
+    QVector<EntityMatch> match(QStringView text) const;
+
+    // Names only, in entity order
+    QStringList detect(QStringView text) const;
+
+    // Lowercase, accents removed, typographic apostrophes and dashes unified.
+    // One UTF-16 unit in, one out, so folded positions are text positions.
+    static QChar fold(QChar c);
+    static QString fold(QStringView text);
+
+    // Letters and digits glue words together; combining marks belong to their
+    // letter. Word boundaries of the matcher and of the search index.
+    static bool isWordChar(QChar c) { return c.isLetterOrNumber() || c.isMark(); }
+
+private:
+    struct Node {
+        QVarLengthArray<QPair<char16_t, int>, 2> next;
+        QVarLengthArray<int, 1> keywords;   // keywords ending at this node
+        int fail = 0;
+        int output = -1;                    // nearest fail-chain node ending a keyword
+    };
+
+    int child(int node, char16_t c) const;
+
+    QVector<Node> m_nodes;
+    QVector<int> m_keywordEntity;       // keyword -> entity index
+    QVector<int> m_keywordLengths;
+    QStringList m_entityNames;
+    QHash<QString, int> m_nameIds;      // folded entity name -> entity index
+};
+
+} // namespace codex::core
@@ -234,9 +234,18 @@ void GnosticEntities::initializeDefaultEntities() {
         {"#000080", "#191970", "#00008B"}
     };
 
+    rebuildMatcher();
     LOG_INFO(QString("Initialized %1 gnostic entities").arg(m_entities.size()));
 }
 
+void GnosticEntities::rebuildMatcher() {
+    QMap<QString, QStringList> keywords;
+    for (auto it = m_entities.constBegin(); it != m_entities.constEnd(); ++it) {
+        keywords[it.key()] = it->keywords;
+    }
+    m_matcher.build(keywords);
+}
+
 bool GnosticEntities::loadFromFile(const QString& filePath) {
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly)) {
@@ -268,27 +277,18 @@ bool GnosticEntities::loadFromFile(const QString& filePath) {
         m_entities[entity.name] = entity;
         loadedCount++;
     }
+    rebuildMatcher();
 
     LOG_INFO(QString("Loaded %1 entities from file: %2").arg(loadedCount).arg(filePath));
     return true;
 }
 
 QStringList GnosticEntities::detect(const QString& text) const {
-    QStringList detected;
-    QString lowerText = text.toLower();
-
-    for (auto it = m_entities.constBegin(); it != m_entities.constEnd(); ++it) {
-        for (const QString& keyword : it->keywords) {
-            if (lowerText.contains(keyword.toLower())) {
-                if (!detected.contains(it.key())) {
-                    detected.append(it.key());
-                }
-                break;
-            }
-        }
-    }
+    return m_matcher.detect(text);
+}
 
-    return detected;
+QVector<EntityMatch> GnosticEntities::match(const QString& text) const {
+    return m_matcher.match(text);
 }
 
 GnosticEntity GnosticEntities::getEntity(const QString& name) const {
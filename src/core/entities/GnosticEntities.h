@@ -1,5 +1,7 @@
 #pragma once
 
+#include "EntityMatcher.h"
+
 #include <QString>
 #include <QMap>
 #include <QStringList>
@@ -23,14 +25,19 @@ public:
 
     QStringList detect(const QString& text) const;
 
+    // Detected entities with keyword counts and positions
+    QVector<EntityMatch> match(const QString& text) const;
+
     GnosticEntity getEntity(const QString& name) const;
     QStringList getAllEntityNames() const;
 
 private:
     GnosticEntities();
     void initializeDefaultEntities();
+    void rebuildMatcher();
 
     QMap<QString, GnosticEntity> m_entities;
+    EntityMatcher m_matcher;        // compiled from the keywords of m_entities
 };
 
 } // namespace codex::core
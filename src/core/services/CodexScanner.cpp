@@ -0,0 +1,315 @@
+#include "CodexScanner.h"
+
+namespace codex::core {
+
+namespace {
+
+bool isAsciiDigit(QChar c) {
+    return c >= u'0' && c <= u'9';
+}
+
+bool isRoman(QChar c) {
+    return c == u'I' || c == u'V' || c == u'X';
+}
+
+// Majuscules admises dans un titre (NH X, Y) : A-Z et ÀÂÄÉÈÊËÏÎÔÙÛÜÇ
+bool isTitleUpper(QChar c) {
+    if (c >= u'A' && c <= u'Z') return true;
+    switch (c.unicode()) {
+    case 0x00C0: case 0x00C2: case 0x00C4: case 0x00C9: case 0x00C8:
+    case 0x00CA: case 0x00CB: case 0x00CF: case 0x00CE: case 0x00D4:
+    case 0x00D9: case 0x00DB: case 0x00DC: case 0x00C7:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool isTitleChar(QChar c) {
+    return isTitleUpper(c) || c.isSpace() || c == u'\'' || c == u'-';
+}
+
+// Avance sur les espaces ; retourne false s'il n'y en avait aucun
+bool skipSpaces(QStringView text, qsizetype& pos) {
+    const qsizetype start = pos;
+    while (pos < text.size() && text[pos].isSpace()) ++pos;
+    return pos > start;
+}
+
+// Avance sur les chiffres ; retourne false s'il n'y en avait aucun
+bool skipDigits(QStringView text, qsizetype& pos) {
+    const qsizetype start = pos;
+    while (pos < text.size() && isAsciiDigit(text[pos])) ++pos;
+    return pos > start;
+}
+
+// "## Page N" puis des espaces contenant au moins un saut de ligne.
+// end pointe après le dernier saut de ligne, comme "## Page (\d+)\s*\n"
+bool matchPageMarker(QStringView text, qsizetype pos, int& number, qsizetype& end) {
+    constexpr QStringView marker = u"## Page ";
+    if (!text.sliced(pos).startsWith(marker)) return false;
+
+    qsizetype p = pos + marker.size();
+    const qsizetype digitsStart = p;
+    if (!skipDigits(text, p)) return false;
+    number = text.sliced(digitsStart, p - digitsStart).toInt();
+
+    qsizetype lastNewline = -1;
+    for (; p < text.size() && text[p].isSpace(); ++p) {
+        if (text[p] == u'\n') lastNewline = p;
+    }
+    if (lastNewline < 0) return false;
+
+    end = lastNewline + 1;
+    return true;
+}
+
+// Ligne "1" suivie d'une ligne "Codex I-1" (début du premier traité)
+bool matchCodexStart(QStringView page, qsizetype line) {
+    if (page[line] != u'1') return false;
+
+    qsizetype p = line + 1;
+    if (!skipSpaces(page, p) || page[p - 1] != u'\n') return false;
+    if (!page.sliced(p).startsWith(u"Codex")) return false;
+    p += 5;
+    return skipSpaces(page, p) && page.sliced(p).startsWith(u"I-1");
+}
+
+// "<TITRE> (NH X, Y)" en début de ligne ; le titre peut continuer sur les
+// lignes suivantes. En cas d'échec, end marque la fin des caractères de titre :
+// aucun début de ligne avant cette position ne peut réussir.
+bool matchTitleHeader(QStringView page, qsizetype line, CodexTitleHeader& header, qsizetype& end) {
+    const qsizetype n = page.size();
+    qsizetype p = line;
+    end = line;
+
+    if (p < n && page[p] == u'<') ++p;
+    if (p >= n || !isTitleUpper(page[p])) return false;
+
+    const qsizetype titleStart = p++;
+    while (p < n && isTitleChar(page[p])) ++p;
+    const qsizetype titleEnd = p;
+    end = titleEnd;
+    if (titleEnd == titleStart + 1) return false;
+
+    if (p < n && page[p] == u'>') ++p;
+    skipSpaces(page, p);
+    if (!page.sliced(p).startsWith(u"(NH")) return false;
+    p += 3;
+    if (!skipSpaces(page, p)) return false;
+
+    const qsizetype codexStart = p;
+    while (p < n && isRoman(page[p])) ++p;
+    if (p == codexStart) return false;
+    const QStringView codex = page.sliced(codexStart, p - codexStart);
+
+    if (p < n && page[p] == u',') ++p;
+    skipSpaces(page, p);
+
+    const qsizetype numberStart = p;
+    if (!skipDigits(page, p)) return false;
+    const QStringView number = page.sliced(numberStart, p - numberStart);
+    if (p >= n || page[p] != u')') return false;
+
+    header.code = codex.toString() + u'-' + number.toString();
+    header.title = page.sliced(titleStart, titleEnd - titleStart).trimmed().toString();
+    end = p + 1;
+    return true;
+}
+
+// Parcourt une page (déjà rognée) ligne par ligne
+void scanPage(QStringView page, int pageNumber, bool& codexStart, QVector<CodexTitleHeader>& headers) {
+    qsizetype resume = 0;       // les titres ne se chevauchent pas
+    qsizetype line = 0;
+
+    while (line < page.size()) {
+        if (!codexStart) {
+            codexStart = matchCodexStart(page, line);
+        }
+
+        if (line >= resume) {
+            CodexTitleHeader header;
+            qsizetype end = 0;
+            if (matchTitleHeader(page, line, header, end)) {
+                header.page = pageNumber;
+                headers.append(header);
+            }
+            resume = end;
+        }
+
+        const qsizetype next = page.indexOf(u'\n', line);
+        if (next < 0) break;
+        line = next + 1;
+    }
+}
+
+// Ligne de points d'une entrée de sommaire, à partir de pos :
+// espaces, au moins deux points (séparés ou non par des espaces), numéro de page
+bool matchDotLeader(QStringView text, qsizetype pos, qsizetype& numberStart, qsizetype& numberEnd) {
+    const qsizetype n = text.size();
+    skipSpaces(text, pos);
+    if (pos >= n || text[pos] != u'.') return false;
+
+    int dots = 0;
+    for (; pos < n && (text[pos] == u'.' || text[pos].isSpace()); ++pos) {
+        if (text[pos] == u'.') ++dots;
+    }
+    if (dots < 2) return false;
+
+    numberStart = pos;
+    if (!skipDigits(text, pos)) return false;
+    numberEnd = pos;
+    return true;
+}
+
+// Entrée "CODE PAGES Titre . . . . N" commençant à pos
+bool matchTocEntry(QStringView toc, qsizetype pos, TreatiseInfo& info, qsizetype& end) {
+    const qsizetype n = toc.size();
+    qsizetype p = pos;
+
+    // Code : "I-1", "8502-1" ou "X" seul
+    if (isRoman(toc[p])) {
+        while (p < n && isRoman(toc[p])) ++p;
+        if (p + 1 < n && toc[p] == u'-' && isAsciiDigit(toc[p + 1])) {
+            ++p;
+            skipDigits(toc, p);
+        } else if (toc[pos] == u'X') {
+            p = pos + 1;
+        } else {
+            return false;
+        }
+    } else if (toc.sliced(pos).startsWith(u"8502-")) {
+        p += 5;
+        if (!skipDigits(toc, p)) return false;
+    } else {
+        return false;
+    }
+    const QStringView code = toc.sliced(pos, p - pos);
+    if (!skipSpaces(toc, p)) return false;
+
+    // Pages du manuscrit : "1-16", "12*-40*" ou "A-B"
+    const qsizetype pagesStart = p;
+    if (toc.sliced(p).startsWith(u"A-B")) {
+        p += 3;
+    } else {
+        if (!skipDigits(toc, p)) return false;
+        if (p < n && toc[p] == u'*') ++p;
+        if (p >= n || toc[p] != u'-') return false;
+        ++p;
+        if (!skipDigits(toc, p)) return false;
+        if (p < n && toc[p] == u'*') ++p;
+    }
+    const QStringView pages = toc.sliced(pagesStart, p - pagesStart);
+    if (!skipSpaces(toc, p)) return false;
+
+    // Titre le plus court, sur une seule ligne, suivi des points et du numéro
+    const qsizetype titleStart = p;
+    qsizetype numberStart = 0, numberEnd = 0;
+    for (qsizetype titleEnd = titleStart + 1; titleEnd <= n && toc[titleEnd - 1] != u'\n'; ++titleEnd) {
+        if (matchDotLeader(toc, titleEnd, numberStart, numberEnd)) {
+            info.code = code.toString();
+            info.pages = pages.toString();
+            info.title = toc.sliced(titleStart, titleEnd - titleStart).trimmed().toString();
+            info.startPage = toc.sliced(numberStart, numberEnd - numberStart).toInt();
+            end = numberEnd;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+CodexScan CodexScanner::scan(QStringView content) {
+    CodexScan result;
+    QVector<bool> codexStart;
+    QVector<QVector<CodexTitleHeader>> headersByPage;
+
+    qsizetype pageStart = -1;       // Contenu de la page courante
+    int pageNumber = 0;
+    qsizetype lastSeparator = -1;   // Dernier "---" de la page courante
+
+    auto closePage = [&](qsizetype end) {
+        QStringView page = content.sliced(pageStart, end - pageStart).trimmed();
+        if (page.endsWith(u"---")) {
+            page.chop(3);
+            page = page.trimmed();
+        }
+
+        if (result.pages.size() <= pageNumber) {
+            result.pages.resize(pageNumber + 1);
+            codexStart.resize(pageNumber + 1);
+            headersByPage.resize(pageNumber + 1);
+        }
+        result.pages[pageNumber] = {page.data() - content.data(), page.size()};
+
+        // Une page répétée remplace la précédente
+        bool start = false;
+        QVector<CodexTitleHeader> headers;
+        scanPage(page, pageNumber, start, headers);
+        codexStart[pageNumber] = start;
+        headersByPage[pageNumber] = std::move(headers);
+    };
+
+    const qsizetype n = content.size();
+    qsizetype i = 0;
+    while (i < n) {
+        const QChar c = content[i];
+
+        if (c == u'-') {
+            const qsizetype runStart = i;
+            while (i < n && content[i] == u'-') ++i;
+            if (i - runStart >= 3) lastSeparator = i - 3;
+            continue;
+        }
+
+        int number = 0;
+        qsizetype markerEnd = 0;
+        if (c == u'#' && matchPageMarker(content, i, number, markerEnd)) {
+            // La page précédente s'arrête à son dernier séparateur
+            if (pageStart >= 0) {
+                closePage(lastSeparator >= 0 ? lastSeparator : i);
+            }
+            pageStart = markerEnd;
+            pageNumber = number;
+            lastSeparator = -1;
+            i = markerEnd;
+            continue;
+        }
+
+        ++i;
+    }
+
+    if (pageStart >= 0) {
+        closePage(n);
+    }
+
+    for (int page = 0; page < headersByPage.size(); ++page) {
+        if (result.codexStartPage < 0 && codexStart[page]) {
+            result.codexStartPage = page;
+        }
+        result.titleHeaders += headersByPage[page];
+    }
+
+    return result;
+}
+
+QVector<TreatiseInfo> CodexScanner::scanTableOfContents(QStringView toc) {
+    QVector<TreatiseInfo> entries;
+
+    qsizetype i = 0;
+    while (i < toc.size()) {
+        TreatiseInfo info;
+        qsizetype end = 0;
+        if (matchTocEntry(toc, i, info, end)) {
+            entries.append(info);
+            i = end;
+        } else {
+            ++i;
+        }
+    }
+
+    return entries;
+}
+
+} // namespace codex::core
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "TextParser.h"
+
+#include <QString>
+#include <QStringView>
+#include <QVector>
+
+namespace codex::core {
+
+// Résultat de la passe unique sur le fichier Codex
+struct CodexScan {
+    QVector<PageSpan> pages;                    // Indexées par numéro de page
+    QVector<CodexTitleHeader> titleHeaders;     // Dans l'ordre des pages
+    int codexStartPage = -1;                    // Page qui commence par "1" / "Codex I-1"
+};
+
+// Analyseur écrit à la main du fichier Codex normalisé, sans QRegularExpression.
+// Une seule passe linéaire repère les marqueurs "## Page N" et les séparateurs
+// "---" ; chaque page refermée est parcourue une fois pour le début du Codex I
+// et les titres (NH X, Y). Les résultats reproduisent ceux des anciennes regex.
+class CodexScanner {
+public:
+    static CodexScan scan(QStringView content);
+
+    // Entrées "I-1 A-B Titre . . . . 1" du texte des pages de la table des matières
+    static QVector<TreatiseInfo> scanTableOfContents(QStringView toc);
+};
+
+} // namespace codex::core
@@ -0,0 +1,204 @@
+#include "NarrationCache.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+
+namespace codex::core {
+
+namespace {
+
+// Fichier du cache : à incrémenter dès que les règles ou le format changent
+constexpr quint32 NARRATION_MAGIC = 0x43444E52;    // "CDNR"
+constexpr quint32 NARRATION_VERSION = 3;
+
+// Traité nettoyé, positions d'origine déjà réduites en plages
+struct CleanedTreatise {
+    QString text;
+    QVector<quint32> runText;       // début de chaque plage dans text
+    QVector<quint32> runSource;
+
+    // Ajoute un texte rendu par le flux et l'origine de chacun de ses caractères
+    void append(const QString& cleaned, const QVector<qsizetype>& offsets) {
+        for (qsizetype i = 0; i < cleaned.size(); ++i) {
+            const qsizetype position = text.size() + i;
+            const qsizetype source = offsets[i];
+            if (runText.isEmpty() || source != runSource.last() + (position - runText.last())) {
+                runText.append(quint32(position));
+                runSource.append(quint32(source));
+            }
+        }
+        text += cleaned;
+    }
+};
+
+} // namespace
+
+void NarrationCache::clear() {
+    m_text.clear();
+    m_treatiseBegin.clear();
+    m_treatiseRunBegin.clear();
+    m_runText.clear();
+    m_runSource.clear();
+}
+
+void NarrationCache::build(const QVector<NarrationSource>& treatises, const NarrationCleaner& cleaner) {
+    clear();
+
+    // Même texte que ParsedTreatise::fullText(), nettoyé page par page : seul
+    // le paragraphe en cours est gardé brut. La ligne vide entre deux pages
+    // est rattachée à la fin de la page qui précède
+    auto cleanTreatise = [&cleaner](const NarrationSource& source) {
+        CleanedTreatise result;
+        NarrationStream stream(cleaner);
+        QVector<qsizetype> offsets;
+
+        for (qsizetype p = 0; p < source.pages.size(); ++p) {
+            if (p > 0) {
+                const qsizetype pageEnd = source.offsets[p - 1] + source.pages[p - 1].size();
+                result.append(stream.append(u"\n\n", pageEnd, offsets), offsets);
+                offsets.clear();
+            }
+            result.append(stream.append(source.pages[p], source.offsets[p], offsets), offsets);
+            offsets.clear();
+        }
+        result.append(stream.finish(offsets), offsets);
+        return result;
+    };
+
+    // Nettoyage des traités en parallèle, assemblage dans l'ordre
+    const QVector<CleanedTreatise> cleaned =
+        QtConcurrent::blockingMapped<QVector<CleanedTreatise>>(treatises, cleanTreatise);
+
+    for (const CleanedTreatise& treatise : cleaned) {
+        const quint32 textBegin = quint32(m_text.size());
+        m_treatiseBegin.append(textBegin);
+        m_treatiseRunBegin.append(quint32(m_runText.size()));
+
+        for (quint32 position : treatise.runText) {
+            m_runText.append(textBegin + position);
+        }
+        m_runSource.append(treatise.runSource);
+        m_text += treatise.text;
+    }
+    m_treatiseBegin.append(quint32(m_text.size()));
+    m_treatiseRunBegin.append(quint32(m_runText.size()));
+}
+
+bool NarrationCache::load(const QString& path, const QByteArray& key) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_5);
+
+    quint32 magic = 0, version = 0;
+    QByteArray storedKey;
+    in >> magic >> version >> storedKey;
+    if (in.status() != QDataStream::Ok || magic != NARRATION_MAGIC || version != NARRATION_VERSION
+        || storedKey != key) {
+        return false;
+    }
+
+    NarrationCache cache;
+    in >> cache.m_text >> cache.m_treatiseBegin >> cache.m_treatiseRunBegin
+       >> cache.m_runText >> cache.m_runSource;
+    if (in.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    // Tailles cohérentes entre les tableaux à plat
+    auto closes = [](const QVector<quint32>& begins, qsizetype total) {
+        return !begins.isEmpty() && begins.first() == 0 && begins.last() == quint32(total)
+            && std::is_sorted(begins.cbegin(), begins.cend());
+    };
+    if (!closes(cache.m_treatiseBegin, cache.m_text.size())
+        || !closes(cache.m_treatiseRunBegin, cache.m_runText.size())
+        || cache.m_treatiseRunBegin.size() != cache.m_treatiseBegin.size()
+        || cache.m_runSource.size() != cache.m_runText.size()) {
+        return false;
+    }
+
+    *this = std::move(cache);
+    return true;
+}
+
+bool NarrationCache::save(const QString& path, const QByteArray& key) const {
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_5);
+
+    out << NARRATION_MAGIC << NARRATION_VERSION << key
+        << m_text << m_treatiseBegin << m_treatiseRunBegin
+        << m_runText << m_runSource;
+
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+QStringView NarrationCache::treatiseText(int treatise) const {
+    if (treatise < 0 || treatise >= treatiseCount()) return QStringView();
+
+    const qsizetype begin = m_treatiseBegin[treatise];
+    return QStringView(m_text).mid(begin, m_treatiseBegin[treatise + 1] - begin);
+}
+
+NarrationText NarrationCache::treatise(int treatise) const {
+    NarrationText result;
+    if (treatise < 0 || treatise >= treatiseCount()) return result;
+
+    const qsizetype begin = m_treatiseBegin[treatise];
+    const qsizetype end = m_treatiseBegin[treatise + 1];
+    result.text = m_text.mid(begin, end - begin);
+    result.sourceOffsets.reserve(end - begin);
+
+    for (quint32 run = m_treatiseRunBegin[treatise]; run < m_treatiseRunBegin[treatise + 1]; ++run) {
+        const qsizetype runEnd = run + 1 < m_treatiseRunBegin[treatise + 1] ? m_runText[run + 1] : end;
+        for (qsizetype i = m_runText[run]; i < runEnd; ++i) {
+            result.sourceOffsets.append(m_runSource[run] + (i - m_runText[run]));
+        }
+    }
+
+    return result;
+}
+
+QString NarrationCache::text(int treatise, qsizetype start, qsizetype end) const {
+    if (treatise < 0 || treatise >= treatiseCount() || end <= start) return QString();
+
+    const qsizetype first = cleanPosition(treatise, start);
+    const qsizetype last = cleanPosition(treatise, end);
+    return m_text.mid(first, last - first).trimmed();
+}
+
+qsizetype NarrationCache::cleanPosition(int treatise, qsizetype offset) const {
+    const auto runsBegin = m_runSource.cbegin() + m_treatiseRunBegin[treatise];
+    const auto runsEnd = m_runSource.cbegin() + m_treatiseRunBegin[treatise + 1];
+    const qsizetype treatiseEnd = m_treatiseBegin[treatise + 1];
+
+    // Origines croissantes : première plage qui commence à offset ou après
+    const auto it = std::lower_bound(runsBegin, runsEnd, offset,
+                                     [](quint32 source, qsizetype value) { return source < value; });
+    const qsizetype run = it - m_runSource.cbegin();
+    const qsizetype next = it != runsEnd ? qsizetype(m_runText[run]) : treatiseEnd;
+
+    // offset peut tomber au milieu de la plage précédente
+    if (it != runsBegin) {
+        const qsizetype previous = run - 1;
+        const qsizetype length = next - m_runText[previous];
+        if (offset < m_runSource[previous] + length) {
+            return m_runText[previous] + (offset - m_runSource[previous]);
+        }
+    }
+
+    return next;
+}
+
+} // namespace codex::core
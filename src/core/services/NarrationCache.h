@@ -0,0 +1,63 @@
+#pragma once
+
+#include "core/services/NarrationCleaner.h"
+
+#include <QByteArray>
+#include <QString>
+#include <QStringView>
+#include <QVector>
+
+namespace codex::core {
+
+// Traité à nettoyer : pages non vides, vues dans le contenu brut du parser
+struct NarrationSource {
+    QVector<QStringView> pages;
+    QVector<qsizetype> offsets;     // position de chaque page dans le contenu brut
+};
+
+// Texte nettoyé d'un traité et position d'origine de chaque caractère
+struct NarrationText {
+    QString text;
+    QVector<qsizetype> sourceOffsets;   // dans le contenu brut, croissantes
+};
+
+// Texte de narration précalculé de tous les traités, pour un jeu de réglages
+// du NarrationCleaner. Les positions d'origine sont gardées par plages de
+// caractères recopiés d'un bloc : une sélection du contenu brut est reliée à
+// son texte nettoyé par une recherche dichotomique, sans relancer le nettoyage.
+// Le cache est sauvegardé à côté du fichier Codex, un fichier par réglages.
+class NarrationCache {
+public:
+    void build(const QVector<NarrationSource>& treatises, const NarrationCleaner& cleaner);
+    void clear();
+
+    // key identifie le contenu et les réglages ; un fichier écrit pour une autre clé est ignoré
+    bool load(const QString& path, const QByteArray& key);
+    bool save(const QString& path, const QByteArray& key) const;
+
+    bool isEmpty() const { return m_treatiseBegin.isEmpty(); }
+    int treatiseCount() const { return qMax(0, int(m_treatiseBegin.size()) - 1); }
+    qsizetype textLength() const { return m_text.size(); }
+    int runCount() const { return int(m_runText.size()); }
+
+    // Texte nettoyé d'un traité, sans copie
+    QStringView treatiseText(int treatise) const;
+
+    // Texte nettoyé d'un traité avec la position d'origine de chaque caractère
+    NarrationText treatise(int treatise) const;
+
+    // Texte nettoyé issu de [start, end) du contenu brut, dans ce traité
+    QString text(int treatise, qsizetype start, qsizetype end) const;
+
+private:
+    // Premier caractère nettoyé du traité dont l'origine est >= offset
+    qsizetype cleanPosition(int treatise, qsizetype offset) const;
+
+    QString m_text;                         // Traités nettoyés, bout à bout
+    QVector<quint32> m_treatiseBegin;       // traité -> début dans m_text (taille : traités + 1)
+    QVector<quint32> m_treatiseRunBegin;    // traité -> première plage (taille : traités + 1)
+    QVector<quint32> m_runText;             // début de chaque plage dans m_text
+    QVector<quint32> m_runSource;           // origine de son premier caractère, les suivants se suivent
+};
+
+} // namespace codex::core
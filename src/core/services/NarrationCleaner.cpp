@@ -1,305 +1,624 @@
 #include "NarrationCleaner.h"
 
-namespace codex::core {
-
-NarrationCleaner::NarrationCleaner() {
-    // Expressions régulières pré-compilées pour performance
+#include <QHash>
+#include <QMutex>
+#include <QRegularExpression>
 
-    // ## Page 1, ## Page 2, etc.
-    m_pageHeaderRegex = QRegularExpression(R"(^##\s*Page\s*\d+\s*$)",
-        QRegularExpression::MultilineOption);
+#include <algorithm>
+#include <initializer_list>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
 
-    // (NH I, 1), (NH II, 3), etc.
-    m_codexRefRegex = QRegularExpression(R"(\s*\(NH\s+[IVX]+,?\s*\d+\))");
+namespace codex::core {
 
-    // Traduction de ..., traduit par ...
-    m_translatorRegex = QRegularExpression(
-        R"(^(Traduction\s+de\s+[^\n]+|Traduit\s+par\s+[^\n]+)$)",
-        QRegularExpression::MultilineOption | QRegularExpression::CaseInsensitiveOption);
+namespace {
 
-    // (Lacune de...), (lacune...), (Peut-être lacune...)
-    m_lacunaRegex = QRegularExpression(
-        R"(\(Lacune[^)]*\)|\(lacune[^)]*\)|\(Peut-être lacune[^)]*\))",
-        QRegularExpression::CaseInsensitiveOption);
+// \s des expressions régulières (PCRE sans propriétés Unicode)
+bool isRegexSpace(QChar c) {
+    return c == u' ' || c == u'\t' || c == u'\n' || c == u'\v' || c == u'\f' || c == u'\r';
+}
 
-    // Lacunes avec points dans les crochets: [ . . . . ] ou [........]
-    m_lacunaBracketsRegex = QRegularExpression(R"(\[[\s.]+\])");
+// Texte rendu par une passe. Si offsets est fourni (position d'origine de
+// chaque caractère de l'entrée), il est remplacé par celles du texte rendu :
+// un caractère recopié garde son origine, un texte inséré prend celle de la
+// position où il remplace l'entrée
+class TextBuilder {
+public:
+    TextBuilder(QStringView input, QVector<qsizetype>* offsets)
+        : m_input(input), m_offsets(offsets) {
+        m_text.reserve(input.size());
+        if (m_offsets) m_newOffsets.reserve(input.size());
+    }
 
-    // Points espacés isolés: . . . . ou .....
-    m_dotsSpacedRegex = QRegularExpression(R"(\.\s+\.\s+\.[\s.]*)");
-    m_dotsManyRegex = QRegularExpression(R"(\.{4,})");
+    // Recopie input[from, to)
+    void copy(qsizetype from, qsizetype to) {
+        if (to <= from) return;
+        m_text += m_input.mid(from, to - from);
+        if (m_offsets) {
+            const qsizetype size = m_newOffsets.size();
+            m_newOffsets.resize(size + to - from);
+            std::copy(m_offsets->cbegin() + from, m_offsets->cbegin() + to, m_newOffsets.begin() + size);
+        }
+    }
 
-    // Numéros de lignes isolés sur leur propre ligne
-    m_lineNumberRegex = QRegularExpression(R"(^\s*\d{1,3}\s*$)",
-        QRegularExpression::MultilineOption);
+    // Ajoute un texte qui remplace l'entrée à partir de at
+    void insert(QStringView text, qsizetype at) {
+        m_text += text;
+        if (m_offsets) {
+            const qsizetype origin = at < m_input.size() ? m_offsets->at(at)
+                                   : m_offsets->isEmpty() ? 0 : m_offsets->last() + 1;
+            m_newOffsets.insert(m_newOffsets.size(), text.size(), origin);
+        }
+    }
 
-    // Numéros de versets inline: "texte 10 Texte" -> "texte Texte"
-    // Capture: espace + 1-2 chiffres + espace + lettre majuscule ou guillemet
-    m_verseNumberInlineRegex = QRegularExpression(R"((\s)(\d{1,2})(\s)([A-Za-zÀ-ÿ«"]))");
+    QString finish(bool trim = false) {
+        qsizetype begin = 0;
+        qsizetype end = m_text.size();
+        if (trim) {
+            while (begin < end && m_text[begin].isSpace()) ++begin;
+            while (end > begin && m_text[end - 1].isSpace()) --end;
+        }
 
-    // [texte restauré] -> texte restauré (garde le contenu, enlève les crochets)
-    m_bracketRegex = QRegularExpression(R"(\[([^\]]{1,60})\])");
+        if (m_offsets) {
+            *m_offsets = m_newOffsets.mid(begin, end - begin);
+        }
+        return begin == 0 && end == m_text.size() ? m_text : m_text.mid(begin, end - begin);
+    }
 
-    // (Décoration : ...), (Note*), (Note :...)
-    m_decorationRegex = QRegularExpression(R"(\(Décoration\s*:[^)]*\))");
-    m_noteRegex = QRegularExpression(R"(\(Note\s*\*?\s*:?[^)]*\)|\*(?=\s|$))");
+private:
+    QStringView m_input;
+    QVector<qsizetype>* m_offsets;
+    QString m_text;
+    QVector<qsizetype> m_newOffsets;
+};
+
+// Équivalent de QString::replace(regex, "\\1\\2...") : chaque correspondance est
+// remplacée par les groupes indiqués, dans l'ordre
+QString replaceCaptures(const QString& text, const QRegularExpression& regex,
+                        std::initializer_list<int> groups, QVector<qsizetype>* offsets) {
+    QRegularExpressionMatchIterator it = regex.globalMatch(text);
+    if (!it.hasNext()) return text;
+
+    TextBuilder builder(text, offsets);
+    qsizetype last = 0;
+    while (it.hasNext()) {
+        const QRegularExpressionMatch match = it.next();
+        builder.copy(last, match.capturedStart());
+        for (int group : groups) {
+            builder.copy(match.capturedStart(group), match.capturedEnd(group));
+        }
+        last = match.capturedEnd();
+    }
+    builder.copy(last, text.size());
+    return builder.finish();
+}
 
-    // Titres de traités en majuscules avec référence (NH X, Y)
-    m_treatiseTitleRegex = QRegularExpression(
-        R"(^[A-ZÉÈÊËÀÂÄÔÖÛÜÙÏÎÇ'\s\-<>]+\s*\(NH\s+[IVX]+,?\s*\d+\)\s*$)",
-        QRegularExpression::MultilineOption);
+// Règle élémentaire : motif et texte de remplacement (sans référence arrière)
+struct Rule {
+    QString pattern;
+    QString replacement;
+};
+
+/**
+ * Plusieurs règles compilées en une seule alternative : une seule passe sur le
+ * texte et un seul tampon de sortie, au lieu d'une copie du texte par règle.
+ * À chaque position, la première règle dans l'ordre d'origine l'emporte. Seules
+ * des règles dont les remplacements ne créent pas de correspondance pour une
+ * règle suivante peuvent être regroupées.
+ */
+class FusedRule {
+public:
+    FusedRule() = default;
+
+    explicit FusedRule(const std::vector<Rule>& rules) {
+        QStringList alternatives;
+        int group = 1;
+        for (const Rule& rule : rules) {
+            alternatives.append("(" + rule.pattern + ")");
+            m_groups.append(group);
+            m_replacements.append(rule.replacement);
+            group += 1 + QRegularExpression(rule.pattern).captureCount();
+        }
 
-    // Pipes | (changement de page dans le manuscrit)
-    m_pipeRegex = QRegularExpression(R"(\s*\|\s*)");
+        if (!alternatives.isEmpty()) {
+            m_regex = QRegularExpression(alternatives.join(u'|'), QRegularExpression::MultilineOption);
+            m_regex.optimize();
+        }
+    }
 
-    // Chevrons <texte> -> texte
-    m_chevronRegex = QRegularExpression(R"(<([^<>]+)>)");
+    QString apply(const QString& text, QVector<qsizetype>* offsets) const {
+        if (m_groups.isEmpty()) return text;
+
+        QRegularExpressionMatchIterator it = m_regex.globalMatch(text);
+        if (!it.hasNext()) return text;
+
+        TextBuilder builder(text, offsets);
+        qsizetype last = 0;
+        while (it.hasNext()) {
+            const QRegularExpressionMatch match = it.next();
+            builder.copy(last, match.capturedStart());
+            for (int i = 0; i < m_groups.size(); ++i) {
+                if (match.capturedStart(m_groups[i]) >= 0) {
+                    builder.insert(m_replacements[i], match.capturedStart());
+                    break;
+                }
+            }
+            last = match.capturedEnd();
+        }
+        builder.copy(last, text.size());
+        return builder.finish();
+    }
 
-    // Espaces cassés dans les mots: "T able" -> "Table", "V érité" -> "Vérité"
-    m_brokenWordRegex = QRegularExpression(R"(\b([A-ZÉÈÊËÀÂÄÔÖÛÜÙÏÎÇ])\s+([a-zéèêëàâäôöûüùïîç]))");
+private:
+    QRegularExpression m_regex;
+    QVector<int> m_groups;          // groupe de capture de chaque règle
+    QStringList m_replacements;
+};
+
+QRegularExpression compiled(const QString& pattern,
+                            QRegularExpression::PatternOptions options = QRegularExpression::NoPatternOption) {
+    QRegularExpression regex(pattern, options);
+    regex.optimize();
+    return regex;
 }
 
-QString NarrationCleaner::clean(const QString& text) const {
-    QString result = text;
-
-    // 1. Supprimer les séparateurs markdown et headers de page
-    if (m_removePageHeaders) {
-        result = removePageHeaders(result);
+// Options qui changent les règles compilées
+enum RuleOption : quint32 {
+    PageHeaders = 1 << 0,
+    TreatiseTitles = 1 << 1,
+    CodexReferences = 1 << 2,
+    TranslatorNotes = 1 << 3,
+    LacunaIndicators = 1 << 4,
+};
+
+} // namespace
+
+struct NarrationCleaner::Rules {
+    explicit Rules(quint32 options);
+
+    // Passes fusionnées, dans l'ordre d'application
+    FusedRule markers;          // en-têtes "## Page N", séparateurs ---
+    FusedRule annotations;      // titres (NH X, Y), références, traducteur, lacunes
+    FusedRule spacedDots;       // ". . ." -> "... "
+    FusedRule decorations;      // "....", décorations
+    FusedRule notes;            // notes et astérisques
+    FusedRule symbolLines;      // lignes de symboles seuls
+
+    // Règles avec références arrière ou appliquées en plusieurs passes
+    QRegularExpression bracket;
+    QRegularExpression chevron;
+    QRegularExpression lineNumber;
+    QRegularExpression verseNumberInline;
+    QRegularExpression endLineNumbers;
+    QRegularExpression brokenWord;
+};
+
+NarrationCleaner::Rules::Rules(quint32 options) {
+    std::vector<Rule> markerRules;
+    if (options & PageHeaders) {
+        // ## Page 1, ## Page 2, etc.
+        markerRules.push_back({R"(^##\s*Page\s*\d+\s*$)", {}});
     }
-    result = removeSeparators(result);
-
-    // 2. Supprimer les pipes (changement de page manuscrit)
-    if (m_removePipes) {
-        result = removePipes(result);
+    // Séparateurs markdown ---
+    markerRules.push_back({R"(^-{3,}$)", {}});
+    markers = FusedRule(markerRules);
+
+    std::vector<Rule> annotationRules;
+    if (options & TreatiseTitles) {
+        // Titres de traités en majuscules avec référence (NH X, Y)
+        annotationRules.push_back({R"(^[A-ZÉÈÊËÀÂÄÔÖÛÜÙÏÎÇ'\s\-<>]+\s*\(NH\s+[IVX]+,?\s*\d+\)\s*$)", {}});
     }
-
-    // 3. Supprimer les titres de traités avec référence NH
-    if (m_removeTreatiseTitles) {
-        result = removeTreatiseTitles(result);
+    if (options & CodexReferences) {
+        // (NH I, 1), (NH II, 3), etc.
+        annotationRules.push_back({R"(\s*\(NH\s+[IVX]+,?\s*\d+\))", {}});
     }
-
-    // 4. Supprimer les références codex
-    if (m_removeCodexRefs) {
-        result = removeCodexReferences(result);
+    if (options & TranslatorNotes) {
+        // Traduction de ..., traduit par ...
+        annotationRules.push_back({R"((?i:^(?:Traduction\s+de\s+[^\n]+|Traduit\s+par\s+[^\n]+)$))", {}});
     }
-
-    // 5. Supprimer les notes de traducteur
-    if (m_removeTranslatorNotes) {
-        result = removeTranslatorNotes(result);
+    if (options & LacunaIndicators) {
+        // (Lacune de...), (lacune...), (Peut-être lacune...)
+        annotationRules.push_back({R"((?i:\(Lacune[^)]*\)|\(lacune[^)]*\)|\(Peut-être lacune[^)]*\)))", {}});
+        // Lacunes avec points dans les crochets: [ . . . . ] ou [........]
+        annotationRules.push_back({R"(\[[\s.]+\])", {}});
     }
-
-    // 6. Supprimer les indicateurs de lacune
-    if (m_removeLacunaIndicators) {
-        result = removeLacunaIndicators(result);
+    annotations = FusedRule(annotationRules);
+
+    // Les points espacés s'appliquent au texte sans crochets de lacune, et
+    // leur "... " peut prolonger un point qui précède : passes séparées
+    std::vector<Rule> decorationRules;
+    if (options & LacunaIndicators) {
+        spacedDots = FusedRule({{R"(\.\s+\.\s+\.[\s.]*)", "... "}});
+        decorationRules.push_back({R"(\.{4,})", "..."});
     }
+    // (Décoration : ...)
+    decorationRules.push_back({R"(\(Décoration\s*:[^)]*\))", {}});
+    decorations = FusedRule(decorationRules);
 
-    // 7. Supprimer décorations et notes
-    result = removeDecorations(result);
+    // (Note*), (Note :...) : passe à part, retirer une décoration peut créer
+    // une note ("texte*(Décoration : x) suite", "(Note (Décoration : x))")
+    notes = FusedRule({{R"(\(Note\s*\*?\s*:?[^)]*\)|\*(?=\s|$))", {}}});
 
-    // 8. Supprimer les crochets (garde le contenu)
-    if (m_removeBrackets) {
-        result = removeBrackets(result);
-    }
+    // Après les notes : une ligne "* †" ne devient une ligne de symboles qu'une fois "*" retiré
+    symbolLines = FusedRule({{R"(^[\s\+\*\#\-\=\†]+$)", {}}});
 
-    // 9. Supprimer les chevrons (garde le contenu)
-    result = removeChevrons(result);
+    // [texte restauré] -> texte restauré (garde le contenu, enlève les crochets)
+    bracket = compiled(R"(\[([^\]]{1,60})\])");
 
-    // 10. Supprimer les numéros de versets inline
-    if (m_removeLineNumbers) {
-        result = removeLineNumbers(result);
-    }
+    // Chevrons <texte> -> texte
+    chevron = compiled(R"(<([^<>]+)>)");
 
-    // 11. Corriger les espaces cassés dans les mots
-    if (m_fixBrokenWords) {
-        result = fixBrokenWords(result);
-    }
+    // Numéros de lignes isolés sur leur propre ligne
+    lineNumber = compiled(R"(^\s*\d{1,3}\s*$)", QRegularExpression::MultilineOption);
 
-    // 12. Supprimer les titres répétés en majuscules
-    if (m_removeRepeatedTitles) {
-        result = removeRepeatedTitles(result);
-    }
+    // Numéros de versets inline: "texte 10 Texte" -> "texte Texte"
+    // Capture: espace + 1-2 chiffres + espace + lettre majuscule ou guillemet
+    verseNumberInline = compiled(R"((\s)(\d{1,2})(\s)([A-Za-zÀ-ÿ«"]))");
 
-    // 13. Normaliser les espaces en dernier
-    result = normalizeWhitespace(result);
+    // Numéros en fin de ligne
+    endLineNumbers = compiled(R"(\s+\d{1,2}\s*$)", QRegularExpression::MultilineOption);
 
-    return result;
+    // Espaces cassés dans les mots: "T able" -> "Table", "V érité" -> "Vérité"
+    brokenWord = compiled(R"(\b([A-ZÉÈÊËÀÂÄÔÖÛÜÙÏÎÇ])\s+([a-zéèêëàâäôöûüùïîç]))");
 }
 
-QString NarrationCleaner::removePageHeaders(const QString& text) const {
-    QString result = text;
-    result.remove(m_pageHeaderRegex);
-    return result;
+const NarrationCleaner::Rules& NarrationCleaner::rules() const {
+    quint32 options = 0;
+    if (m_removePageHeaders) options |= PageHeaders;
+    if (m_removeTreatiseTitles) options |= TreatiseTitles;
+    if (m_removeCodexRefs) options |= CodexReferences;
+    if (m_removeTranslatorNotes) options |= TranslatorNotes;
+    if (m_removeLacunaIndicators) options |= LacunaIndicators;
+
+    // Une compilation par combinaison d'options utilisée, pour tout le processus
+    static QMutex mutex;
+    static QHash<quint32, std::shared_ptr<const Rules>> cache;
+
+    QMutexLocker locker(&mutex);
+    std::shared_ptr<const Rules>& entry = cache[options];
+    if (!entry) {
+        entry = std::make_shared<const Rules>(options);
+    }
+    return *entry;
 }
 
-QString NarrationCleaner::removeCodexReferences(const QString& text) const {
-    QString result = text;
-    result.remove(m_codexRefRegex);
-    return result;
+QString NarrationCleaner::clean(const QString& text) const {
+    QSet<QString> seenTitles;
+    return cleanBlock(text, seenTitles);
 }
 
-QString NarrationCleaner::removeTranslatorNotes(const QString& text) const {
-    QString result = text;
-    result.remove(m_translatorRegex);
-    return result;
-}
+QString NarrationCleaner::clean(const QString& text, QVector<qsizetype>& offsets) const {
+    if (offsets.size() != text.size()) {
+        offsets.resize(text.size());
+        std::iota(offsets.begin(), offsets.end(), qsizetype(0));
+    }
 
-QString NarrationCleaner::removeLacunaIndicators(const QString& text) const {
-    QString result = text;
+    QSet<QString> seenTitles;
+    return cleanBlock(text, seenTitles, &offsets);
+}
 
-    // Supprimer (Lacune de...) et variantes
-    result.remove(m_lacunaRegex);
+quint32 NarrationCleaner::settingsKey() const {
+    const bool flags[] = {
+        m_removePageHeaders, m_removeCodexRefs, m_removeTranslatorNotes, m_removeLacunaIndicators,
+        m_removeLineNumbers, m_removeBrackets, m_removeTreatiseTitles, m_removePipes,
+        m_fixBrokenWords, m_removeRepeatedTitles,
+    };
 
-    // Supprimer les crochets avec points [ . . . . ]
-    result.remove(m_lacunaBracketsRegex);
+    quint32 key = 0;
+    for (bool flag : flags) {
+        key = (key << 1) | (flag ? 1 : 0);
+    }
+    return key;
+}
 
-    // Remplacer les points espacés par "..."
-    result.replace(m_dotsSpacedRegex, "... ");
+QString NarrationCleaner::cleanBlock(const QString& text, QSet<QString>& seenTitles,
+                                     QVector<qsizetype>* offsets) const {
+    const Rules& r = rules();
 
-    // Remplacer les points multiples par "..."
-    result.replace(m_dotsManyRegex, "...");
+    // 1. Supprimer les headers de page et les séparateurs markdown
+    QString result = r.markers.apply(text, offsets);
 
-    return result;
-}
+    // 2. Supprimer les pipes (changement de page manuscrit)
+    if (m_removePipes) {
+        result = replacePipes(result, offsets);
+    }
 
-QString NarrationCleaner::removeLineNumbers(const QString& text) const {
-    QString result = text;
+    // 3-6. Titres (NH X, Y), références codex, notes de traducteur, lacunes
+    result = r.annotations.apply(result, offsets);
+    result = r.spacedDots.apply(result, offsets);
 
-    // Supprimer les numéros isolés sur leur propre ligne
-    result.remove(m_lineNumberRegex);
+    // 7. Supprimer décorations et notes, puis les lignes de symboles restantes
+    result = r.decorations.apply(result, offsets);
+    result = r.notes.apply(result, offsets);
+    result = r.symbolLines.apply(result, offsets);
 
-    // Supprimer les numéros de versets inline (plusieurs passes)
-    for (int i = 0; i < 3; ++i) {
-        QString newResult = result;
-        newResult.replace(m_verseNumberInlineRegex, "\\1\\4");
-        if (newResult == result) break;
-        result = newResult;
+    // 8. Supprimer les crochets (plusieurs passes pour les crochets imbriqués)
+    if (m_removeBrackets) {
+        for (int i = 0; i < 3; ++i) {
+            QString newResult = replaceCaptures(result, r.bracket, {1}, offsets);
+            if (newResult == result) break;
+            result = newResult;
+        }
     }
 
-    // Supprimer les numéros en fin de ligne
-    QRegularExpression endLineNumbers(R"(\s+\d{1,2}\s*$)", QRegularExpression::MultilineOption);
-    result.remove(endLineNumbers);
+    // 9. Supprimer les chevrons (garde le contenu)
+    result = replaceCaptures(result, r.chevron, {1}, offsets);
 
-    return result;
-}
+    // 10. Supprimer les numéros de lignes et de versets inline
+    if (m_removeLineNumbers) {
+        result = replaceCaptures(result, r.lineNumber, {}, offsets);
 
-QString NarrationCleaner::removeBrackets(const QString& text) const {
-    QString result = text;
+        for (int i = 0; i < 3; ++i) {
+            QString newResult = replaceCaptures(result, r.verseNumberInline, {1, 4}, offsets);
+            if (newResult == result) break;
+            result = newResult;
+        }
 
-    // Plusieurs passes pour les crochets imbriqués
-    for (int i = 0; i < 3; ++i) {
-        QString newResult = result;
-        newResult.replace(m_bracketRegex, "\\1");
-        if (newResult == result) break;
-        result = newResult;
+        result = replaceCaptures(result, r.endLineNumbers, {}, offsets);
     }
 
-    return result;
-}
+    // 11. Corriger les espaces cassés dans les mots
+    if (m_fixBrokenWords) {
+        result = replaceCaptures(result, r.brokenWord, {1, 2}, offsets);
+    }
 
-QString NarrationCleaner::removeTreatiseTitles(const QString& text) const {
-    QString result = text;
-    result.remove(m_treatiseTitleRegex);
-    return result;
+    // 12-13. Titres répétés et espaces, en une passe sur les lignes
+    return finishLines(result, seenTitles, offsets);
 }
 
-QString NarrationCleaner::removeDecorations(const QString& text) const {
-    QString result = text;
-    result.remove(m_decorationRegex);
-    result.remove(m_noteRegex);
-
-    // Supprimer les lignes avec uniquement des symboles
-    QRegularExpression symbolLines(R"(^[\s\+\*\#\-\=\†]+$)", QRegularExpression::MultilineOption);
-    result.remove(symbolLines);
+QString NarrationCleaner::replacePipes(const QString& text, QVector<qsizetype>* offsets) {
+    // Équivalent de "\s*\|\s*" -> " "
+    qsizetype pipe = text.indexOf(u'|');
+    if (pipe < 0) return text;
+
+    TextBuilder builder(text, offsets);
+    qsizetype copied = 0;
+    while (pipe >= 0) {
+        qsizetype start = pipe;
+        while (start > copied && isRegexSpace(text[start - 1])) --start;
+        qsizetype end = pipe + 1;
+        while (end < text.size() && isRegexSpace(text[end])) ++end;
+
+        builder.copy(copied, start);
+        builder.insert(u" ", start);
+        copied = end;
+        pipe = text.indexOf(u'|', end);
+    }
+    builder.copy(copied, text.size());
 
-    return result;
+    return builder.finish();
 }
 
-QString NarrationCleaner::removeSeparators(const QString& text) const {
-    QString result = text;
+QString NarrationCleaner::finishLines(QStringView text, QSet<QString>& seenTitles,
+                                      QVector<qsizetype>* offsets) const {
+    // Mêmes résultats que les passes successives :
+    // - lignes en majuscules déjà vues supprimées
+    // - "[ \t]+" -> " " et espaces retirés en début/fin de ligne
+    // - plusieurs lignes vides -> une seule
+    // - trim global
+    TextBuilder builder(text, offsets);
+    bool firstLine = true;
+
+    auto isBlank = [](QChar c) { return c == u' ' || c == u'\t'; };
+
+    // Ligne commençant à start dans text
+    auto appendLine = [&](qsizetype start, QStringView line) {
+        if (!firstLine) builder.copy(start - 1, start);     // '\n' de la ligne précédente
+        firstLine = false;
+
+        const qsizetype n = line.size();
+        qsizetype i = 0;
+        while (i < n && isBlank(line[i])) ++i;
+        while (i < n) {
+            qsizetype wordEnd = i;
+            while (wordEnd < n && !isBlank(line[wordEnd])) ++wordEnd;
+            builder.copy(start + i, start + wordEnd);
+
+            qsizetype next = wordEnd;
+            while (next < n && isBlank(line[next])) ++next;
+            if (next < n) {
+                if (next - wordEnd == 1 && line[wordEnd] == u' ') {
+                    builder.copy(start + wordEnd, start + next);
+                } else {
+                    builder.insert(u" ", start + wordEnd);
+                }
+            }
+            i = next;
+        }
+    };
+
+    // Lignes blanches en attente : une seule est gardée telle quelle, plusieurs
+    // deviennent une ligne vide
+    int blankLines = 0;
+    qsizetype lastBlankStart = 0;
+    QStringView lastBlank;
+    auto flushBlankLines = [&]() {
+        if (blankLines == 1) {
+            appendLine(lastBlankStart, lastBlank);
+        } else if (blankLines > 1) {
+            appendLine(lastBlankStart, QStringView());
+        }
+        blankLines = 0;
+    };
+
+    qsizetype lineStart = 0;
+    bool lastLine = false;
+    while (!lastLine) {
+        qsizetype lineEnd = text.indexOf(u'\n', lineStart);
+        if (lineEnd < 0) {
+            lineEnd = text.size();
+            lastLine = true;
+        }
+        const qsizetype start = lineStart;
+        const QStringView line = text.mid(start, lineEnd - start);
+        lineStart = lineEnd + 1;
+
+        // Titres répétés (tout en majuscules, > 5 caractères)
+        const QStringView stripped = line.trimmed();
+        if (m_removeRepeatedTitles && stripped.size() > 5) {
+            bool isUpperCase = true;
+            for (QChar c : stripped) {
+                if (c.isLetter() && !c.isUpper()) {
+                    isUpperCase = false;
+                    break;
+                }
+            }
 
-    // Supprimer les séparateurs markdown ---
-    QRegularExpression separators(R"(^-{3,}$)", QRegularExpression::MultilineOption);
-    result.remove(separators);
+            if (isUpperCase) {
+                const QString normalized = stripped.left(30).toString();
+                if (seenTitles.contains(normalized)) {
+                    continue; // Skip répétition
+                }
+                seenTitles.insert(normalized);
+            }
+        }
 
-    return result;
-}
+        bool blank = true;
+        for (QChar c : line) {
+            if (!isRegexSpace(c)) {
+                blank = false;
+                break;
+            }
+        }
+        if (blank) {
+            ++blankLines;
+            lastBlankStart = start;
+            lastBlank = line;
+            continue;
+        }
+
+        flushBlankLines();
+        appendLine(start, line);
+    }
+    flushBlankLines();
 
-QString NarrationCleaner::removePipes(const QString& text) const {
-    QString result = text;
-    result.replace(m_pipeRegex, " ");
-    return result;
+    return builder.finish(true);
 }
 
-QString NarrationCleaner::removeChevrons(const QString& text) const {
-    QString result = text;
-    result.replace(m_chevronRegex, "\\1");
-    return result;
+NarrationStream::NarrationStream(const NarrationCleaner& cleaner)
+    : m_cleaner(cleaner) {
 }
 
-QString NarrationCleaner::fixBrokenWords(const QString& text) const {
-    QString result = text;
-    // Corriger "T able" -> "Table", "V érité" -> "Vérité"
-    result.replace(m_brokenWordRegex, "\\1\\2");
-    return result;
+QString NarrationStream::append(QStringView chunk) {
+    m_pending += chunk;
+    return takeBlock(nullptr);
 }
 
-QString NarrationCleaner::removeRepeatedTitles(const QString& text) const {
-    // Supprimer les lignes en majuscules qui se répètent
-    QStringList lines = text.split('\n');
-    QStringList cleanedLines;
-    QSet<QString> seenTitles;
+QString NarrationStream::append(QStringView chunk, qsizetype origin, QVector<qsizetype>& offsets) {
+    m_pending += chunk;
+    const qsizetype size = m_pendingOffsets.size();
+    m_pendingOffsets.resize(size + chunk.size());
+    std::iota(m_pendingOffsets.begin() + size, m_pendingOffsets.end(), origin);
+    return takeBlock(&offsets);
+}
 
-    for (const QString& line : lines) {
-        QString stripped = line.trimmed();
+QString NarrationStream::finish() {
+    const QString output = emitBlock(m_pending, {}, nullptr);
+    reset();
+    return output;
+}
 
-        // Ignorer les lignes vides
-        if (stripped.isEmpty()) {
-            cleanedLines.append(line);
-            continue;
-        }
+QString NarrationStream::finish(QVector<qsizetype>& offsets) {
+    const QString output = emitBlock(m_pending, m_pendingOffsets, &offsets);
+    reset();
+    return output;
+}
 
-        // Détecter les titres (tout en majuscules, > 5 caractères)
-        bool isUpperCase = true;
-        for (const QChar& c : stripped) {
-            if (c.isLetter() && !c.isUpper()) {
-                isUpperCase = false;
-                break;
-            }
-        }
+void NarrationStream::reset() {
+    m_pending.clear();
+    m_pendingOffsets.clear();
+    m_seenTitles.clear();
+    m_hasOutput = false;
+    m_searchFrom = 0;
+}
 
-        if (isUpperCase && stripped.length() > 5) {
-            QString normalized = stripped.left(30);
-            if (seenTitles.contains(normalized)) {
-                continue; // Skip répétition
-            }
-            seenTitles.insert(normalized);
+QString NarrationStream::takeBlock(QVector<qsizetype>* offsets) {
+    const qsizetype cut = findCut();
+
+    QString block;
+    QVector<qsizetype> blockOffsets;
+    if (cut > 0) {
+        block = m_pending.left(cut);
+        m_pending.remove(0, cut);
+        if (offsets) {
+            blockOffsets = m_pendingOffsets.mid(0, cut);
+            m_pendingOffsets.remove(0, cut);
         }
-
-        cleanedLines.append(line);
     }
 
-    return cleanedLines.join('\n');
-}
+    // Les coupures examinées restent refusées, sauf dans les blancs de la fin
+    // où la suite du texte manquait encore : la recherche suivante s'arrête là
+    qsizetype end = m_pending.size() - 1;
+    while (end > 0 && isRegexSpace(m_pending[end - 1])) --end;
+    m_searchFrom = qMax<qsizetype>(0, end - 1);
 
-QString NarrationCleaner::normalizeWhitespace(const QString& text) const {
-    QString result = text;
+    if (cut <= 0) return QString();
+    return emitBlock(block, std::move(blockOffsets), offsets);
+}
 
-    // Remplacer les espaces multiples par un seul
-    QRegularExpression multipleSpaces(R"([ \t]+)");
-    result.replace(multipleSpaces, " ");
+QString NarrationStream::emitBlock(const QString& block, QVector<qsizetype> blockOffsets,
+                                   QVector<qsizetype>* offsets) {
+    // Un bloc commence à la ligne vide de la coupure : le séparateur en prend l'origine
+    const qsizetype cutOrigin = blockOffsets.isEmpty() ? 0 : blockOffsets.first();
 
-    // Remplacer les lignes vides multiples par une seule
-    QRegularExpression multipleNewlines(R"(\n\s*\n\s*\n+)");
-    result.replace(multipleNewlines, "\n\n");
+    const QString cleaned = m_cleaner.cleanBlock(block, m_seenTitles, offsets ? &blockOffsets : nullptr);
+    if (cleaned.isEmpty()) return QString();
 
-    // Supprimer les espaces en début/fin de ligne
-    QRegularExpression lineEdgeSpaces(R"(^[ \t]+|[ \t]+$)", QRegularExpression::MultilineOption);
-    result.remove(lineEdgeSpaces);
+    // Les blocs sont séparés par une ligne vide, comme dans le texte entier
+    const QString output = m_hasOutput ? "\n\n" + cleaned : cleaned;
+    if (offsets) {
+        if (m_hasOutput) offsets->insert(offsets->size(), 2, cutOrigin);
+        offsets->append(blockOffsets);
+    }
+    m_hasOutput = true;
+    return output;
+}
 
-    // Trim global
-    result = result.trimmed();
+qsizetype NarrationStream::findCut() const {
+    // Dernière ligne vide où aucune règle ne peut chevaucher la coupure :
+    // - avant : fin de mot ou de phrase, pas de points de lacune ". . .",
+    //   ni de pipe, crochet, parenthèse ou chevron laissé ouvert
+    // - après : un mot qui commence par une majuscule suivie d'une minuscule,
+    //   donc ni titre, ni numéro, ni marqueur de page, ni pipe
+    const QString& text = m_pending;
+    const qsizetype n = text.size();
+
+    for (qsizetype cut = n - 1; cut > qMax<qsizetype>(m_searchFrom, 0); --cut) {
+        if (text[cut] != u'\n') continue;
+
+        qsizetype k = cut + 1;
+        while (k < n && (text[k] == u' ' || text[k] == u'\t')) ++k;
+        if (k >= n || text[k] != u'\n') continue;
+
+        qsizetype before = cut - 1;
+        while (before >= 0 && isRegexSpace(text[before])) --before;
+        qsizetype after = k;
+        while (after < n && isRegexSpace(text[after])) ++after;
+        if (before < 0 || after + 1 >= n) continue;
+
+        const QChar previous = text[before];
+        if (!previous.isLetter() && !QStringView(u".!?;:,\u00BB\u201D\u2019\")").contains(previous)) continue;
+        if (previous == u'.' && (before == 0 || isRegexSpace(text[before - 1]) || text[before - 1] == u'.')) continue;
+
+        if (text[after].category() != QChar::Letter_Uppercase
+            || text[after + 1].category() != QChar::Letter_Lowercase) continue;
+
+        bool closed = true;
+        for (const auto& [open, close] : {std::pair{u'[', u']'}, std::pair{u'(', u')'}, std::pair{u'<', u'>'}}) {
+            const qsizetype opened = text.lastIndexOf(QChar(open), cut);
+            if (opened < 0) continue;
+            const qsizetype closer = text.indexOf(QChar(close), opened);
+            if (closer < 0 || closer >= cut) {
+                closed = false;
+                break;
+            }
+        }
+        if (closed) return cut;
+    }
 
-    return result;
+    return -1;
 }
 
 } // namespace codex::core
@@ -2,8 +2,9 @@
 
 #include <QString>
 #include <QStringList>
-#include <QRegularExpression>
+#include <QStringView>
 #include <QSet>
+#include <QVector>
 
 namespace codex::core {
 
@@ -19,10 +20,14 @@ namespace codex::core {
  * - Lacunes avec points espacés [ . . . ]
  * - Titres répétés en majuscules
  * - Espaces cassés dans les mots (T able -> Table)
+ *
+ * Les règles sont compilées une seule fois par processus et partagées entre
+ * les threads : un NarrationCleaner ne contient que ses options et se crée
+ * sans coût. Les règles indépendantes sont fusionnées en une seule passe.
  */
 class NarrationCleaner {
 public:
-    NarrationCleaner();
+    NarrationCleaner() = default;
 
     /**
      * @brief Nettoie le texte pour la narration
@@ -31,6 +36,26 @@ public:
      */
     QString clean(const QString& text) const;
 
+    /**
+     * @brief Nettoie le texte en suivant l'origine de chaque caractère
+     * @param offsets Position d'origine de chaque caractère de text (identité si
+     *        la taille ne correspond pas) ; remplacée par celle de chaque
+     *        caractère du texte nettoyé, toujours croissante
+     */
+    QString clean(const QString& text, QVector<qsizetype>& offsets) const;
+
+    /**
+     * @brief Remplace les pipes (changement de page) et les espaces qui les entourent par une espace
+     *
+     * Pour passer à la narration un texte nettoyé avec setRemovePipes(false).
+     */
+    static QString removePipes(const QString& text) { return replacePipes(text, nullptr); }
+
+    /**
+     * @brief Identifie les réglages : deux nettoyeurs de même clé rendent le même texte
+     */
+    quint32 settingsKey() const;
+
     /**
      * @brief Active/désactive des règles de nettoyage spécifiques
      */
@@ -46,20 +71,21 @@ public:
     void setRemoveRepeatedTitles(bool remove) { m_removeRepeatedTitles = remove; }
 
 private:
-    QString removePageHeaders(const QString& text) const;
-    QString removeCodexReferences(const QString& text) const;
-    QString removeTranslatorNotes(const QString& text) const;
-    QString removeLacunaIndicators(const QString& text) const;
-    QString removeLineNumbers(const QString& text) const;
-    QString removeBrackets(const QString& text) const;
-    QString removeTreatiseTitles(const QString& text) const;
-    QString removeDecorations(const QString& text) const;
-    QString removeSeparators(const QString& text) const;
-    QString removePipes(const QString& text) const;
-    QString removeChevrons(const QString& text) const;
-    QString fixBrokenWords(const QString& text) const;
-    QString removeRepeatedTitles(const QString& text) const;
-    QString normalizeWhitespace(const QString& text) const;
+    friend class NarrationStream;
+
+    struct Rules;
+
+    // Règles compilées pour les options actuelles (partagées, jamais libérées)
+    const Rules& rules() const;
+
+    // Nettoyage d'un bloc ; les titres déjà vus sont partagés entre les blocs d'un flux
+    // (offsets : voir clean(), nullptr si les positions ne sont pas suivies)
+    QString cleanBlock(const QString& text, QSet<QString>& seenTitles,
+                       QVector<qsizetype>* offsets = nullptr) const;
+
+    // Passes écrites à la main, sans expression régulière
+    static QString replacePipes(const QString& text, QVector<qsizetype>* offsets);
+    QString finishLines(QStringView text, QSet<QString>& seenTitles, QVector<qsizetype>* offsets) const;
 
     bool m_removePageHeaders = true;
     bool m_removeCodexRefs = true;
@@ -71,24 +97,52 @@ private:
     bool m_removePipes = true;
     bool m_fixBrokenWords = true;
     bool m_removeRepeatedTitles = true;
+};
+
+/**
+ * @brief Nettoyage par morceaux d'un long texte (traité entier)
+ *
+ * Les morceaux sont accumulés jusqu'à une ligne vide où le texte peut être
+ * coupé sans changer le résultat ; chaque bloc complet est nettoyé aussitôt.
+ * La mémoire reste bornée par la taille d'un paragraphe, et la concaténation
+ * des textes rendus est identique à NarrationCleaner::clean() sur le tout.
+ * Un flux suit l'origine des caractères ou non, sans mélanger les deux appels.
+ */
+class NarrationStream {
+public:
+    explicit NarrationStream(const NarrationCleaner& cleaner = NarrationCleaner());
+
+    /**
+     * @brief Ajoute un morceau de texte brut
+     * @return Texte nettoyé des blocs complets (vide si aucun bloc n'est complet)
+     */
+    QString append(QStringView chunk);
+
+    /**
+     * @brief Ajoute un morceau en suivant l'origine de chaque caractère
+     * @param origin Position d'origine du premier caractère de chunk, les suivants se suivent
+     * @param offsets Reçoit à la suite l'origine de chaque caractère rendu, toujours croissante
+     */
+    QString append(QStringView chunk, qsizetype origin, QVector<qsizetype>& offsets);
+
+    /**
+     * @brief Nettoie le reste du texte ; le flux peut ensuite être réutilisé
+     */
+    QString finish();
+    QString finish(QVector<qsizetype>& offsets);
+
+private:
+    qsizetype findCut() const;
+    QString takeBlock(QVector<qsizetype>* offsets);
+    QString emitBlock(const QString& block, QVector<qsizetype> blockOffsets, QVector<qsizetype>* offsets);
+    void reset();
 
-    // Expressions régulières pré-compilées
-    QRegularExpression m_pageHeaderRegex;
-    QRegularExpression m_codexRefRegex;
-    QRegularExpression m_translatorRegex;
-    QRegularExpression m_lacunaRegex;
-    QRegularExpression m_lacunaBracketsRegex;
-    QRegularExpression m_dotsSpacedRegex;
-    QRegularExpression m_dotsManyRegex;
-    QRegularExpression m_lineNumberRegex;
-    QRegularExpression m_verseNumberInlineRegex;
-    QRegularExpression m_bracketRegex;
-    QRegularExpression m_decorationRegex;
-    QRegularExpression m_noteRegex;
-    QRegularExpression m_treatiseTitleRegex;
-    QRegularExpression m_pipeRegex;
-    QRegularExpression m_chevronRegex;
-    QRegularExpression m_brokenWordRegex;
+    NarrationCleaner m_cleaner;
+    QString m_pending;
+    QVector<qsizetype> m_pendingOffsets;    // origine de chaque caractère de m_pending, si suivie
+    QSet<QString> m_seenTitles;
+    bool m_hasOutput = false;
+    qsizetype m_searchFrom = 0;     // coupures avant cette position déjà refusées
 };
 
 } // namespace codex::core
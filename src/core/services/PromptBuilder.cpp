@@ -36,6 +36,36 @@ QString PromptBuilder::buildClaudePrompt(const QString& passageText,
     return prompt;
 }
 
+QString PromptBuilder::buildBatchClaudePrompt(const QStringList& segments,
+                                              const QList<QStringList>& entitiesPerSegment,
+                                              const QString& category) {
+    QString segmentsText;
+    for (int i = 0; i < segments.size(); ++i) {
+        QStringList entities = entitiesPerSegment.value(i);
+        segmentsText += QString("SEGMENT %1 (entités: %2):\n%3\n\n")
+            .arg(i + 1)
+            .arg(entities.isEmpty() ? QString("aucune") : entities.join(", "))
+            .arg(segments[i]);
+    }
+
+    QString prompt = QString(
+        "Tu es un expert en textes gnostiques et en direction artistique visuelle.\n\n"
+        "Ce passage du Codex de Nag Hammadi est découpé en %1 segments, "
+        "un par case d'une planche de bande dessinée. "
+        "Génère une description de scène visuelle pour chaque segment, "
+        "en gardant une cohérence de style, de personnages et de lumière entre les cases.\n\n"
+        "CATÉGORIE MYTHIQUE: %2\n\n"
+        "%3"
+        "Génère UNIQUEMENT un tableau JSON de %1 objets, dans l'ordre des segments, avec:\n"
+        "- index: numéro du segment (1 à %1)\n"
+        "- scene: description de la scène visuelle (3-4 phrases)\n"
+        "- emotion: l'émotion dominante\n"
+        "- visual_elements: liste de 5-7 éléments visuels clés"
+    ).arg(segments.size()).arg(category, segmentsText);
+
+    return prompt;
+}
+
 QString PromptBuilder::buildImagenPrompt(const QString& sceneDescription,
                                          const QString& emotion,
                                          const QStringList& visualKeywords,
@@ -14,6 +14,12 @@ public:
                               const QStringList& entities,
                               const QString& category);
 
+    // Construit un prompt unique pour tous les segments d'une planche
+    // (reponse attendue: tableau JSON, un objet par segment)
+    QString buildBatchClaudePrompt(const QStringList& segments,
+                                   const QList<QStringList>& entitiesPerSegment,
+                                   const QString& category);
+
     // Assemble le prompt final pour Imagen
     QString buildImagenPrompt(const QString& sceneDescription,
                               const QString& emotion,
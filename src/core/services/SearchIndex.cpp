@@ -0,0 +1,503 @@
+#include "SearchIndex.h"
+#include "core/entities/EntityMatcher.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace codex::core {
+
+namespace {
+
+// Fichier d'index : à incrémenter dès que le découpage ou le format change
+constexpr quint32 SEARCH_MAGIC = 0x43445358;   // "CDSX"
+constexpr quint32 SEARCH_VERSION = 1;
+
+// Paramètres BM25 usuels
+constexpr double BM25_K1 = 1.2;
+constexpr double BM25_B = 0.75;
+
+// Proximité par défaut pour "..."~ sans nombre
+constexpr int DEFAULT_SLOP = 10;
+
+void appendFolded(QString& term, QChar c) {
+    if (c.isMark()) return;     // accents décomposés
+
+    const QChar folded = EntityMatcher::fold(c);
+    switch (folded.unicode()) {
+    case u'œ':
+        term += u"oe";
+        break;
+    case u'æ':
+        term += u"ae";
+        break;
+    default:
+        term += folded;
+        break;
+    }
+}
+
+// Reprise d'un mot coupé par l'extraction PDF, -1 si le mot se termine en i
+qsizetype continuation(QStringView text, qsizetype wordStart, qsizetype i) {
+    const qsizetype n = text.size();
+
+    // Capitale détachée : "V érité", "T out"
+    if (i - wordStart == 1 && text[wordStart].isUpper()) {
+        qsizetype k = i;
+        while (k < n && text[k].isSpace()) ++k;
+        if (k > i && k < n && text[k].isLower()) return k;
+    }
+
+    // Césure en fin de ligne : "Sau-\nveur", "Pen -\nsée"
+    qsizetype k = i;
+    while (k < n && text[k] == u' ') ++k;
+    if (k < n && text[k] == u'-') {
+        ++k;
+        while (k < n && text[k] == u' ') ++k;
+        if (k < n && text[k] == u'\n') {
+            ++k;
+            while (k < n && (text[k] == u' ' || text[k] == u'\t')) ++k;
+            if (k < n && text[k].isLower()) return k;
+        }
+    }
+    return -1;
+}
+
+QVector<SearchToken> tokenizePage(const SearchPage& page) {
+    return SearchIndex::tokenize(page.text);
+}
+
+} // namespace
+
+QVector<SearchToken> SearchIndex::tokenize(QStringView text) {
+    QVector<SearchToken> tokens;
+    const qsizetype n = text.size();
+
+    qsizetype i = 0;
+    while (i < n) {
+        if (!EntityMatcher::isWordChar(text[i])) {
+            ++i;
+            continue;
+        }
+
+        SearchToken token;
+        token.position = i;
+        qsizetype partStart = i;
+        for (;;) {
+            while (i < n && EntityMatcher::isWordChar(text[i])) {
+                appendFolded(token.term, text[i++]);
+            }
+            const qsizetype next = continuation(text, partStart, i);
+            if (next < 0) break;
+            partStart = i = next;
+        }
+        token.length = i - token.position;
+
+        if (!token.term.isEmpty()) tokens.append(token);
+    }
+
+    return tokens;
+}
+
+void SearchIndex::clear() {
+    m_terms.clear();
+    m_termIds.clear();
+    m_termPostingBegin.clear();
+    m_postingDocs.clear();
+    m_postingPositionBegin.clear();
+    m_positions.clear();
+    m_docTreatise.clear();
+    m_docPage.clear();
+    m_docTokenBegin.clear();
+    m_tokenOffsets.clear();
+    m_tokenLengths.clear();
+}
+
+void SearchIndex::build(const QVector<SearchPage>& pages) {
+    clear();
+
+    // Découpage des pages en parallèle ; la fusion reste séquentielle pour
+    // garder les listes triées par page puis par position
+    const QVector<QVector<SearchToken>> tokenized =
+        QtConcurrent::blockingMapped<QVector<QVector<SearchToken>>>(pages, tokenizePage);
+
+    struct TermPostings {
+        QVector<quint32> docs;
+        QVector<quint32> positionCounts;
+        QVector<quint32> positions;
+    };
+    QVector<TermPostings> postings;
+
+    m_docTokenBegin.append(0);
+    for (qsizetype doc = 0; doc < pages.size(); ++doc) {
+        const SearchPage& page = pages[doc];
+        const QVector<SearchToken>& tokens = tokenized[doc];
+        m_docTreatise.append(page.treatise);
+        m_docPage.append(page.page);
+
+        for (qsizetype position = 0; position < tokens.size(); ++position) {
+            const SearchToken& token = tokens[position];
+
+            int id = m_termIds.value(token.term, -1);
+            if (id < 0) {
+                id = m_terms.size();
+                m_terms.append(token.term);
+                m_termIds.insert(token.term, id);
+                postings.append(TermPostings());
+            }
+
+            TermPostings& list = postings[id];
+            if (list.docs.isEmpty() || list.docs.last() != quint32(doc)) {
+                list.docs.append(quint32(doc));
+                list.positionCounts.append(0);
+            }
+            ++list.positionCounts.last();
+            list.positions.append(quint32(position));
+
+            m_tokenOffsets.append(quint32(page.offset + token.position));
+            m_tokenLengths.append(quint16(qMin<qsizetype>(token.length, 0xFFFF)));
+        }
+        m_docTokenBegin.append(quint32(m_tokenOffsets.size()));
+    }
+
+    // Mise à plat des listes
+    m_postingPositionBegin.append(0);
+    for (const TermPostings& list : postings) {
+        m_termPostingBegin.append(quint32(m_postingDocs.size()));
+        m_postingDocs += list.docs;
+        m_positions += list.positions;
+        for (quint32 count : list.positionCounts) {
+            m_postingPositionBegin.append(m_postingPositionBegin.last() + count);
+        }
+    }
+    m_termPostingBegin.append(quint32(m_postingDocs.size()));
+}
+
+bool SearchIndex::load(const QString& path, const QByteArray& key) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_5);
+
+    quint32 magic = 0, version = 0;
+    QByteArray storedKey;
+    in >> magic >> version >> storedKey;
+    if (in.status() != QDataStream::Ok || magic != SEARCH_MAGIC || version != SEARCH_VERSION || storedKey != key) {
+        return false;
+    }
+
+    SearchIndex index;
+    in >> index.m_terms >> index.m_termPostingBegin >> index.m_postingDocs
+       >> index.m_postingPositionBegin >> index.m_positions
+       >> index.m_docTreatise >> index.m_docPage >> index.m_docTokenBegin
+       >> index.m_tokenOffsets >> index.m_tokenLengths;
+    if (in.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    // Tailles cohérentes entre les tableaux à plat
+    auto closes = [](const QVector<quint32>& begins, qsizetype count, qsizetype total) {
+        return begins.size() == count + 1 && begins.first() == 0 && begins.last() == quint32(total)
+            && std::is_sorted(begins.cbegin(), begins.cend());
+    };
+    if (!closes(index.m_termPostingBegin, index.m_terms.size(), index.m_postingDocs.size())
+        || !closes(index.m_postingPositionBegin, index.m_postingDocs.size(), index.m_positions.size())
+        || !closes(index.m_docTokenBegin, index.m_docTreatise.size(), index.m_tokenOffsets.size())
+        || index.m_docPage.size() != index.m_docTreatise.size()
+        || index.m_tokenLengths.size() != index.m_tokenOffsets.size()) {
+        return false;
+    }
+
+    // Chaque entrée renvoie à une page existante, chaque position à un mot de cette page
+    const qsizetype docCount = index.m_docTreatise.size();
+    for (qsizetype entry = 0; entry < index.m_postingDocs.size(); ++entry) {
+        const quint32 doc = index.m_postingDocs[entry];
+        if (doc >= quint32(docCount)) {
+            return false;
+        }
+        const quint32 tokenCount = index.m_docTokenBegin[doc + 1] - index.m_docTokenBegin[doc];
+        for (quint32 p = index.m_postingPositionBegin[entry]; p < index.m_postingPositionBegin[entry + 1]; ++p) {
+            if (index.m_positions[p] >= tokenCount) {
+                return false;
+            }
+        }
+    }
+
+    index.m_termIds.reserve(index.m_terms.size());
+    for (int i = 0; i < index.m_terms.size(); ++i) {
+        index.m_termIds.insert(index.m_terms[i], i);
+    }
+
+    *this = std::move(index);
+    return true;
+}
+
+bool SearchIndex::save(const QString& path, const QByteArray& key) const {
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_5);
+
+    out << SEARCH_MAGIC << SEARCH_VERSION << key
+        << m_terms << m_termPostingBegin << m_postingDocs
+        << m_postingPositionBegin << m_positions
+        << m_docTreatise << m_docPage << m_docTokenBegin
+        << m_tokenOffsets << m_tokenLengths;
+
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+bool SearchIndex::parseQuery(QStringView query, QVector<Clause>& clauses) const {
+    // Un mot absent du vocabulaire : aucune page ne peut tout contenir
+    auto resolve = [this](QStringView text, QVector<int>& terms) {
+        for (const SearchToken& token : tokenize(text)) {
+            const int id = m_termIds.value(token.term, -1);
+            if (id < 0) return false;
+            terms.append(id);
+        }
+        return true;
+    };
+
+    qsizetype i = 0;
+    while (i < query.size()) {
+        if (query[i].isSpace()) {
+            ++i;
+            continue;
+        }
+
+        Clause clause;
+        QStringView text;
+        if (query[i] == u'"' || query[i] == u'«') {
+            const QChar close = query[i] == u'"' ? QChar(u'"') : QChar(u'»');
+            const qsizetype start = ++i;
+            while (i < query.size() && query[i] != close) ++i;
+            text = query.mid(start, i - start);
+            if (i < query.size()) ++i;
+
+            // "..."~N : mots proches, dans n'importe quel ordre
+            if (i < query.size() && query[i] == u'~') {
+                const qsizetype digits = ++i;
+                while (i < query.size() && query[i].isDigit()) ++i;
+                clause.slop = i > digits ? query.mid(digits, i - digits).toInt() : DEFAULT_SLOP;
+            }
+        } else {
+            // Un mot qui se découpe en plusieurs ("l'âme", "peut-être") est une phrase
+            const qsizetype start = i;
+            while (i < query.size() && !query[i].isSpace() && query[i] != u'"') ++i;
+            text = query.mid(start, i - start);
+        }
+
+        if (!resolve(text, clause.terms)) return false;
+        if (clause.terms.isEmpty()) continue;
+        if (clause.terms.size() == 1) clause.slop = -1;
+        clauses.append(clause);
+    }
+
+    return !clauses.isEmpty();
+}
+
+qsizetype SearchIndex::findPosting(int term, quint32 doc) const {
+    const auto begin = m_postingDocs.cbegin() + m_termPostingBegin[term];
+    const auto end = m_postingDocs.cbegin() + m_termPostingBegin[term + 1];
+    const auto it = std::lower_bound(begin, end, doc);
+    return (it != end && *it == doc) ? it - m_postingDocs.cbegin() : -1;
+}
+
+double SearchIndex::inverseFrequency(int term) const {
+    const double documents = m_docTreatise.size();
+    const double frequency = m_termPostingBegin[term + 1] - m_termPostingBegin[term];
+    return std::log(1.0 + (documents - frequency + 0.5) / (frequency + 0.5));
+}
+
+QVector<SearchIndex::TokenSpan> SearchIndex::clauseMatches(const Clause& clause,
+                                                           const QVector<qsizetype>& postings) const {
+    auto positionsBegin = [this](qsizetype posting) {
+        return m_positions.cbegin() + m_postingPositionBegin[posting];
+    };
+    auto positionsEnd = [this](qsizetype posting) {
+        return m_positions.cbegin() + m_postingPositionBegin[posting + 1];
+    };
+
+    QVector<TokenSpan> matches;
+
+    if (clause.terms.size() == 1) {
+        for (auto it = positionsBegin(postings[0]); it != positionsEnd(postings[0]); ++it) {
+            matches.append({*it, *it});
+        }
+        return matches;
+    }
+
+    if (clause.slop < 0) {
+        // Phrase : chaque mot suit le précédent
+        const quint32 length = clause.terms.size();
+        for (auto it = positionsBegin(postings[0]); it != positionsEnd(postings[0]); ++it) {
+            bool follows = true;
+            for (quint32 k = 1; k < length && follows; ++k) {
+                follows = std::binary_search(positionsBegin(postings[k]), positionsEnd(postings[k]), *it + k);
+            }
+            if (follows) matches.append({*it, *it + length - 1});
+        }
+        return matches;
+    }
+
+    // Proximité : fenêtres qui contiennent tous les mots
+    QVector<QVector<TokenSpan>> lists;
+    for (qsizetype posting : postings) {
+        QVector<TokenSpan> list;
+        for (auto it = positionsBegin(posting); it != positionsEnd(posting); ++it) {
+            list.append({*it, *it});
+        }
+        lists.append(list);
+    }
+    return coveringWindows(lists, quint32(clause.slop));
+}
+
+QVector<SearchIndex::TokenSpan> SearchIndex::coveringWindows(const QVector<QVector<TokenSpan>>& lists,
+                                                             quint32 maxSpan) {
+    struct Event {
+        TokenSpan span;
+        int list;
+    };
+
+    QVector<Event> events;
+    for (int list = 0; list < lists.size(); ++list) {
+        for (const TokenSpan& span : lists[list]) {
+            events.append({span, list});
+        }
+    }
+    std::sort(events.begin(), events.end(), [](const Event& a, const Event& b) {
+        return a.span.first != b.span.first ? a.span.first < b.span.first : a.span.last < b.span.last;
+    });
+
+    QVector<TokenSpan> windows;
+    QVector<int> counts(lists.size(), 0);
+    int covered = 0;
+    qsizetype left = 0;
+    qint64 boundary = -1;       // fin de la dernière fenêtre retenue
+
+    for (qsizetype right = 0; right < events.size(); ++right) {
+        if (qint64(events[right].span.first) <= boundary) {
+            left = right + 1;
+            continue;
+        }
+        if (counts[events[right].list]++ == 0) ++covered;
+        if (covered < lists.size()) continue;
+
+        // Plus petite fenêtre qui se termine ici
+        while (counts[events[left].list] > 1) {
+            --counts[events[left].list];
+            ++left;
+        }
+        quint32 last = 0;
+        for (qsizetype k = left; k <= right; ++k) {
+            last = qMax(last, events[k].span.last);
+        }
+        const quint32 first = events[left].span.first;
+
+        if (last - first <= maxSpan) {
+            windows.append({first, last});
+            boundary = last;
+            counts.fill(0);
+            covered = 0;
+            left = right + 1;
+        } else {
+            --counts[events[left].list];
+            --covered;
+            ++left;
+        }
+    }
+
+    return windows;
+}
+
+QVector<SearchHit> SearchIndex::search(QStringView query, int limit) const {
+    QVector<SearchHit> hits;
+    QVector<Clause> clauses;
+    if (isEmpty() || !parseQuery(query, clauses)) return hits;
+
+    // Mots distincts ; les pages candidates sont celles du plus rare
+    QVector<int> terms;
+    for (const Clause& clause : clauses) {
+        for (int term : clause.terms) {
+            if (!terms.contains(term)) terms.append(term);
+        }
+    }
+    const int rarest = *std::min_element(terms.cbegin(), terms.cend(), [this](int a, int b) {
+        return m_termPostingBegin[a + 1] - m_termPostingBegin[a] < m_termPostingBegin[b + 1] - m_termPostingBegin[b];
+    });
+
+    const double averageLength = double(m_tokenOffsets.size()) / m_docTreatise.size();
+    QVector<qsizetype> postings(terms.size());
+
+    for (quint32 entry = m_termPostingBegin[rarest]; entry < m_termPostingBegin[rarest + 1]; ++entry) {
+        const quint32 doc = m_postingDocs[entry];
+
+        bool containsAll = true;
+        for (qsizetype k = 0; k < terms.size() && containsAll; ++k) {
+            postings[k] = findPosting(terms[k], doc);
+            containsAll = postings[k] >= 0;
+        }
+        if (!containsAll) continue;
+
+        const double length = m_docTokenBegin[doc + 1] - m_docTokenBegin[doc];
+        double score = 0.0;
+        QVector<QVector<TokenSpan>> clauseSpans;
+
+        for (const Clause& clause : clauses) {
+            QVector<qsizetype> clausePostings;
+            double idf = 0.0;
+            for (int term : clause.terms) {
+                clausePostings.append(postings[terms.indexOf(term)]);
+                idf += inverseFrequency(term);
+            }
+
+            const QVector<TokenSpan> matches = clauseMatches(clause, clausePostings);
+            if (matches.isEmpty()) {
+                containsAll = false;
+                break;
+            }
+
+            // Une phrase compte comme un mot dont la fréquence est celle de la phrase
+            const double frequency = matches.size();
+            score += idf * frequency * (BM25_K1 + 1.0)
+                     / (frequency + BM25_K1 * (1.0 - BM25_B + BM25_B * length / averageLength));
+            clauseSpans.append(matches);
+        }
+        if (!containsAll) continue;
+
+        // Passage à montrer : la plus courte fenêtre qui couvre toutes les clauses
+        const QVector<TokenSpan> windows = coveringWindows(clauseSpans, std::numeric_limits<quint32>::max());
+        if (windows.isEmpty()) continue;
+        const TokenSpan best = *std::min_element(windows.cbegin(), windows.cend(), [](const TokenSpan& a, const TokenSpan& b) {
+            return a.last - a.first < b.last - b.first;
+        });
+
+        const quint32 first = m_docTokenBegin[doc] + best.first;
+        const quint32 last = m_docTokenBegin[doc] + best.last;
+        hits.append({m_docTreatise[doc], m_docPage[doc],
+                     qsizetype(m_tokenOffsets[first]), qsizetype(m_tokenOffsets[last]) + m_tokenLengths[last],
+                     score});
+    }
+
+    // Meilleur score d'abord, ordre du texte à égalité
+    std::stable_sort(hits.begin(), hits.end(), [](const SearchHit& a, const SearchHit& b) {
+        return a.score > b.score;
+    });
+    if (limit > 0 && hits.size() > limit) {
+        hits.resize(limit);
+    }
+    return hits;
+}
+
+} // namespace codex::core
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <QVector>
+
+namespace codex::core {
+
+// Mot du texte après repliement : minuscules, sans accents, ligatures développées
+struct SearchToken {
+    QString term;               // "ame", "oeuvre", "verite"
+    qsizetype position = 0;     // dans le texte analysé
+    qsizetype length = 0;       // étendue d'origine, césure ou espace parasite compris
+};
+
+// Page à indexer : vue dans le contenu brut du parser
+struct SearchPage {
+    int treatise = -1;          // index dans la table des matières
+    int page = 0;               // page fichier
+    qsizetype offset = 0;       // position de la page dans le contenu brut
+    QStringView text;
+};
+
+// Page trouvée, avec la plus petite fenêtre qui contient toute la requête
+struct SearchHit {
+    int treatise = -1;
+    int page = 0;
+    qsizetype start = 0;        // dans le contenu brut
+    qsizetype end = 0;
+    double score = 0.0;         // BM25
+};
+
+// Index inversé plein texte du Codex, une page par document.
+// Les positions de chaque mot sont conservées pour les requêtes de phrase et de
+// proximité, et le classement suit BM25. La construction découpe les pages en
+// parallèle ; l'index est sauvegardé à côté du fichier Codex.
+//
+// Syntaxe des requêtes (toutes les clauses doivent être présentes) :
+//   sophia lumière            mots, dans n'importe quel ordre
+//   "premier homme"           phrase exacte
+//   "sophia yaldabaoth"~10    mots à 10 mots au plus les uns des autres
+class SearchIndex {
+public:
+    void build(const QVector<SearchPage>& pages);
+    void clear();
+
+    // key identifie le contenu indexé ; un fichier écrit pour une autre clé est ignoré
+    bool load(const QString& path, const QByteArray& key);
+    bool save(const QString& path, const QByteArray& key) const;
+
+    bool isEmpty() const { return m_docTreatise.isEmpty(); }
+    int documentCount() const { return m_docTreatise.size(); }
+    int termCount() const { return m_terms.size(); }
+    int tokenCount() const { return m_tokenOffsets.size(); }
+
+    QVector<SearchHit> search(QStringView query, int limit = 50) const;
+
+    // Découpage en mots, identique pour le texte et les requêtes.
+    // Recolle les césures de fin de ligne ("Sau-\nveur") et les capitales
+    // détachées par l'extraction PDF ("V érité"), comme NarrationCleaner.
+    static QVector<SearchToken> tokenize(QStringView text);
+
+private:
+    // Positions (en mots) de la première et de la dernière occurrence d'une correspondance
+    struct TokenSpan {
+        quint32 first = 0;
+        quint32 last = 0;
+    };
+
+    // Mot isolé, phrase exacte (slop < 0) ou mots proches (slop >= 0)
+    struct Clause {
+        QVector<int> terms;
+        int slop = -1;
+    };
+
+    bool parseQuery(QStringView query, QVector<Clause>& clauses) const;
+    qsizetype findPosting(int term, quint32 doc) const;
+    QVector<TokenSpan> clauseMatches(const Clause& clause, const QVector<qsizetype>& postings) const;
+    double inverseFrequency(int term) const;
+
+    // Fenêtres minimales, sans chevauchement, couvrant une correspondance de
+    // chaque liste et d'au plus maxSpan mots
+    static QVector<TokenSpan> coveringWindows(const QVector<QVector<TokenSpan>>& lists, quint32 maxSpan);
+
+    // Vocabulaire
+    QStringList m_terms;
+    QHash<QString, int> m_termIds;
+
+    // Listes inversées à plat : mot -> pages -> positions
+    QVector<quint32> m_termPostingBegin;        // mot -> première entrée (taille : mots + 1)
+    QVector<quint32> m_postingDocs;             // page de chaque entrée, croissantes par mot
+    QVector<quint32> m_postingPositionBegin;    // entrée -> première position (taille : entrées + 1)
+    QVector<quint32> m_positions;               // rang du mot dans la page
+
+    // Pages et mots
+    QVector<qint32> m_docTreatise;
+    QVector<qint32> m_docPage;
+    QVector<quint32> m_docTokenBegin;           // page -> premier mot (taille : pages + 1)
+    QVector<quint32> m_tokenOffsets;            // position de chaque mot dans le contenu brut
+    QVector<quint16> m_tokenLengths;
+};
+
+} // namespace codex::core
@@ -0,0 +1,254 @@
+#include "SentenceSegmenter.h"
+
+#include <initializer_list>
+
+namespace codex::core {
+
+namespace {
+
+// Pauses de la voix, en caractères prononcés
+constexpr qsizetype SHORT_PAUSE = 3;    // , ; : et tirets
+constexpr qsizetype LONG_PAUSE = 8;     // fin de phrase
+
+// Abréviations suivies d'une majuscule ou d'un nombre dans les traductions et
+// leurs notes ("cf. Jean", "p. 12", "M. Doresse"), sans le point final
+constexpr QStringView ABBREVIATIONS[] = {
+    u"cf", u"p", u"pp", u"v", u"vv", u"ch", u"chap", u"n", u"no", u"éd", u"trad",
+    u"op", u"cit", u"ibid", u"id", u"vol", u"fig", u"col", u"fol", u"ms", u"mss",
+    u"mm", u"mme", u"mlle", u"dr", u"st", u"ste", u"env", u"av", u"apr",
+};
+
+// Niveaux de recoupe d'une unité trop lourde
+enum class Level { Clause, Comma, Word };
+
+bool isTerminator(QChar c) {
+    return c == u'.' || c == u'!' || c == u'?' || c == u'…';
+}
+
+bool isCloser(QChar c) {
+    return c == u'»' || c == u'"' || c == u'”' || c == u'’' || c == u'\'' || c == u')' || c == u']';
+}
+
+// Espace dans la ligne, insécables compris ("Viens ! »")
+bool isInlineSpace(QChar c) {
+    return c != u'\n' && c.isSpace();
+}
+
+qsizetype skipSpaces(QStringView text, qsizetype i) {
+    while (i < text.size() && text[i].isSpace()) ++i;
+    return i;
+}
+
+// Point d'abréviation ou d'initiale ("J. Doresse", "J.-C.")
+bool isAbbreviation(QStringView text, qsizetype dot) {
+    qsizetype wordStart = dot;
+    while (wordStart > 0 && text[wordStart - 1].isLetter()) --wordStart;
+    const QStringView word = text.mid(wordStart, dot - wordStart);
+
+    if (word.size() == 1 && word[0].isUpper()) return true;
+    for (QStringView abbreviation : ABBREVIATIONS) {
+        if (word.compare(abbreviation, Qt::CaseInsensitive) == 0) return true;
+    }
+    return false;
+}
+
+// La ponctuation finale text[first, end) termine-t-elle la phrase ?
+bool endsSentence(QStringView text, qsizetype first, qsizetype end) {
+    if (end >= text.size()) return true;
+    if (!text[end].isSpace()) return false;     // "3.14", "a.b"
+
+    const qsizetype next = skipSpaces(text, end);
+    if (next >= text.size()) return true;
+    if (text[next].isLower()) return false;     // « Viens ! » dit-il
+
+    const bool singleDot = text[first] == u'.' && (first + 1 >= text.size() || text[first + 1] != u'.');
+    return !(singleDot && isAbbreviation(text, first));
+}
+
+qsizetype spanWeight(QStringView text, const TextSpan& span, SentenceSegmenter::Measure measure) {
+    if (measure == SentenceSegmenter::Measure::Characters) return span.length;
+    return SentenceSegmenter::speechWeight(text.mid(span.start, span.length));
+}
+
+// Recoupe au niveau donné les unités plus lourdes que maxWeight
+QVector<TextSpan> splitUnits(QStringView text, const QVector<TextSpan>& units, Level level,
+                             qsizetype maxWeight, SentenceSegmenter::Measure measure) {
+    QVector<TextSpan> pieces;
+    pieces.reserve(units.size());
+
+    for (const TextSpan& unit : units) {
+        if (spanWeight(text, unit, measure) <= maxWeight) {
+            pieces.append(unit);
+            continue;
+        }
+
+        // Coupure après la ponctuation (ou le mot) suivie d'un espace
+        const qsizetype end = unit.end();
+        qsizetype pieceStart = unit.start;
+        for (qsizetype i = unit.start; i + 1 < end; ++i) {
+            const QChar c = text[i];
+            if (c.isSpace() || !text[i + 1].isSpace()) continue;
+
+            const bool cut = level == Level::Word
+                          || (level == Level::Clause ? (c == u';' || c == u':') : c == u',');
+            if (!cut) continue;
+
+            pieces.append({pieceStart, i + 1 - pieceStart});
+            pieceStart = skipSpaces(text, i + 1);
+            i = pieceStart - 1;
+        }
+        pieces.append({pieceStart, end - pieceStart});
+    }
+
+    return pieces;
+}
+
+} // namespace
+
+QVector<TextSpan> SentenceSegmenter::sentences(QStringView text) {
+    QVector<TextSpan> spans;
+    const qsizetype n = text.size();
+
+    // Étendue sans les espaces de fin (le début en est déjà dépourvu)
+    auto addSpan = [&spans, text](qsizetype start, qsizetype end) {
+        while (end > start && text[end - 1].isSpace()) --end;
+        if (end > start) spans.append({start, end - start});
+    };
+
+    qsizetype start = skipSpaces(text, 0);
+    qsizetype i = start;
+    while (i < n) {
+        const QChar c = text[i];
+
+        // Ligne vide : fin de paragraphe
+        if (c == u'\n') {
+            qsizetype k = i + 1;
+            while (k < n && isInlineSpace(text[k])) ++k;
+            if (k < n && text[k] == u'\n') {
+                addSpan(start, i);
+                start = i = skipSpaces(text, k);
+                continue;
+            }
+            i = k;
+            continue;
+        }
+
+        if (!isTerminator(c)) {
+            ++i;
+            continue;
+        }
+
+        // "?!", "...", puis guillemets et parenthèses fermants
+        qsizetype end = i + 1;
+        while (end < n && isTerminator(text[end])) ++end;
+        for (;;) {
+            qsizetype k = end;
+            while (k < n && isInlineSpace(text[k])) ++k;
+            if (k >= n || !isCloser(text[k])) break;
+            end = k + 1;
+        }
+
+        if (endsSentence(text, i, end)) {
+            addSpan(start, end);
+            start = skipSpaces(text, end);
+            i = start;
+        } else {
+            i = end;
+        }
+    }
+    addSpan(start, n);
+
+    return spans;
+}
+
+QVector<TextSpan> SentenceSegmenter::segments(QStringView text, int count, Measure measure) {
+    QVector<TextSpan> result;
+    if (count <= 0) return result;
+
+    QVector<TextSpan> units = sentences(text);
+    if (units.isEmpty()) return result;
+
+    // Unités plus fines tant qu'il en manque ou qu'une dépasse un segment moyen
+    for (Level level : {Level::Clause, Level::Comma, Level::Word}) {
+        qsizetype total = 0;
+        qsizetype heaviest = 0;
+        for (const TextSpan& unit : units) {
+            const qsizetype weight = spanWeight(text, unit, measure);
+            total += weight;
+            heaviest = qMax(heaviest, weight);
+        }
+        if (units.size() >= count && heaviest * count <= total) break;
+
+        units = splitUnits(text, units, level, units.size() < count ? 0 : total / count, measure);
+    }
+
+    const qsizetype n = units.size();
+    result.reserve(count);
+
+    auto addGroup = [&](qsizetype first, qsizetype last) {
+        result.append({units[first].start, units[last - 1].end() - units[first].start});
+    };
+
+    if (n <= count) {
+        result = units;
+    } else {
+        QVector<qsizetype> prefix(n + 1, 0);
+        for (qsizetype i = 0; i < n; ++i) {
+            prefix[i + 1] = prefix[i] + spanWeight(text, units[i], measure);
+        }
+        const qsizetype total = prefix[n];
+
+        // Coupure k au plus près de k/count du poids total, en laissant au
+        // moins une unité à chacun des segments suivants
+        qsizetype begin = 0;
+        qsizetype cut = 1;
+        for (int k = 1; k < count; ++k) {
+            const qsizetype target = total * k;     // comparé à prefix * count
+            const qsizetype maxCut = n - (count - k);
+            cut = qMax(cut, begin + 1);
+            while (cut < maxCut && prefix[cut] * count < target) ++cut;
+            if (cut - 1 > begin && target - prefix[cut - 1] * count < prefix[cut] * count - target) {
+                --cut;
+            }
+
+            addGroup(begin, cut);
+            begin = cut;
+        }
+        addGroup(begin, n);
+    }
+
+    while (result.size() < count) {
+        result.append(result.last());
+    }
+    return result;
+}
+
+qsizetype SentenceSegmenter::speechWeight(QStringView text) {
+    qsizetype weight = 0;
+    bool afterTerminator = false;
+
+    for (QChar c : text) {
+        const bool terminator = isTerminator(c);
+        if (c.isLetterOrNumber()) {
+            ++weight;
+        } else if (terminator) {
+            if (!afterTerminator) weight += LONG_PAUSE;     // "?!" et "..." : une seule pause
+        } else if (c == u',' || c == u';' || c == u':' || c == u'—' || c == u'–') {
+            weight += SHORT_PAUSE;
+        }
+        afterTerminator = terminator;
+    }
+
+    return weight;
+}
+
+QStringList SentenceSegmenter::texts(QStringView text, const QVector<TextSpan>& spans) {
+    QStringList result;
+    result.reserve(spans.size());
+    for (const TextSpan& span : spans) {
+        result.append(text.mid(span.start, span.length).toString());
+    }
+    return result;
+}
+
+} // namespace codex::core
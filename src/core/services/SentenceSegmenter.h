@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <QVector>
+
+namespace codex::core {
+
+// Étendue dans le texte découpé : position et longueur, sans copie
+struct TextSpan {
+    qsizetype start = 0;
+    qsizetype length = 0;
+
+    qsizetype end() const { return start + length; }
+};
+
+// Découpage en phrases et en segments équilibrés, partagé par les planches,
+// le diaporama et la narration. Une seule passe linéaire par niveau, aucune
+// chaîne construite : les résultats sont des étendues du texte d'origine.
+//
+// Une phrase se termine par . ! ? ou …, suivis des guillemets et parenthèses
+// fermants (« Viens ! » avec ou sans espace insécable), puis d'un espace et
+// d'un mot qui ne commence pas par une minuscule ; les abréviations ("cf.",
+// "etc.", "J.-C.") et les initiales ne terminent pas la phrase. Une ligne vide
+// termine toujours la phrase en cours.
+class SentenceSegmenter {
+public:
+    // Poids d'un segment pour l'équilibrage
+    enum class Measure {
+        Characters,     // Longueur du texte (légende, prompt d'image)
+        Speech          // Durée de lecture estimée (narration)
+    };
+
+    // Phrases du texte, sans les espaces qui les séparent
+    static QVector<TextSpan> sentences(QStringView text);
+
+    // Exactement count segments contigus, de poids aussi proches que possible.
+    // Les coupures tombent entre deux phrases ; une phrase plus lourde qu'un
+    // segment moyen est recoupée aux ; et :, puis aux virgules, puis entre les
+    // mots. Un texte trop court répète son dernier segment. Vide si le texte l'est.
+    static QVector<TextSpan> segments(QStringView text, int count, Measure measure = Measure::Characters);
+
+    // Durée de lecture estimée, en caractères prononcés : lettres et chiffres,
+    // plus une pause pour chaque ponctuation
+    static qsizetype speechWeight(QStringView text);
+
+    // Copie des étendues, pour les appels qui gardent des QString
+    static QStringList texts(QStringView text, const QVector<TextSpan>& spans);
+};
+
+} // namespace codex::core
@@ -1,18 +1,39 @@
 #include "TextParser.h"
+#include "CodexScanner.h"
 #include "utils/Logger.h"
 
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QElapsedTimer>
 #include <QFile>
-#include <QTextStream>
+#include <QFileInfo>
 #include <QRegularExpression>
+#include <QSaveFile>
+
+#include <cstring>
 
 namespace codex::core {
 
+namespace {
+
+// Index binaire : à incrémenter dès que le parsing change de résultat
+constexpr quint32 INDEX_MAGIC = 0x43444958;   // "CDIX"
+constexpr quint32 INDEX_VERSION = 2;
+
+QByteArray sourceHash(const char* data, qsizetype length) {
+    return QCryptographicHash::hash(QByteArrayView(data, length), QCryptographicHash::Sha1);
+}
+
+} // namespace
+
 TextParser::TextParser() {
     loadEntityKeywords();
 }
 
 void TextParser::loadEntityKeywords() {
-    m_entityKeywords = {
+    // Accents et casse indifférents : l'automate compare des formes repliées
+    const QMap<QString, QStringList> keywords = {
         {"Plérôme", {"plérôme", "plénitude", "totalité divine", "pleroma"}},
         {"Sophia", {"sophia", "sagesse", "pistis", "pistis sophia"}},
         {"Éons", {"éon", "éons", "aiôn", "aiônes", "aeon"}},
@@ -28,106 +49,244 @@ void TextParser::loadEntityKeywords() {
         {"Adam", {"adam", "premier homme"}},
         {"Ève", {"ève", "eve", "femme"}}
     };
+    m_entityMatcher.build(keywords);
 }
 
 bool TextParser::loadCodexFile(const QString& filePath) {
     QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    if (!file.open(QIODevice::ReadOnly)) {
         LOG_ERROR(QString("Failed to open Codex file: %1").arg(filePath));
         return false;
     }
 
-    QTextStream in(&file);
-    in.setEncoding(QStringConverter::Utf8);
-    m_rawContent = in.readAll();
-    file.close();
+    // Décodage UTF-8 directement depuis le fichier projeté en mémoire
+    // (lecture classique si le système de fichiers ne permet pas le mmap)
+    qsizetype length = file.size();
+    QByteArray fallback;
+    const char* data = reinterpret_cast<const char*>(file.map(0, length));
+    if (!data) {
+        fallback = file.readAll();
+        data = fallback.constData();
+        length = fallback.size();
+    }
 
-    // Normalize line endings (Windows CRLF to LF)
-    m_rawContent.replace("\r\n", "\n");
-    m_rawContent.replace("\r", "\n");
+    if (length >= 3 && memcmp(data, "\xEF\xBB\xBF", 3) == 0) {
+        data += 3;      // BOM UTF-8
+        length -= 3;
+    }
+    m_rawContent = QString::fromUtf8(data, length);
+    normalizeContent();
 
-    // Normalize dashes (en-dash to hyphen for consistent parsing)
-    m_rawContent.replace(QString::fromUtf8("–"), "-");  // en-dash
-    m_rawContent.replace(QString::fromUtf8("—"), "-");  // em-dash
+    m_treatises.clear();
+    m_pageSpans.clear();
+    m_pageOffset = 0;
+
+    // Index binaire à jour : pages, décalage et traités sans aucune regex
+    QFileInfo fileInfo(filePath);
+    SourceStamp stamp;
+    stamp.size = fileInfo.size();
+    stamp.modifiedMs = fileInfo.lastModified().toMSecsSinceEpoch();
+
+    const QString indexPath = indexPathFor(filePath);
+    if (!loadIndex(indexPath, stamp, data, length)) {
+        // Une seule passe : pages, début du Codex I et titres (NH X, Y)
+        CodexScan scan = CodexScanner::scan(m_rawContent);
+        m_pageSpans = std::move(scan.pages);
+        m_titleHeaders = std::move(scan.titleHeaders);
+        LOG_INFO(QString("Parsed %1 pages from Codex").arg(m_pageSpans.size()));
+
+        detectPageOffset(scan.codexStartPage);
+        parseTableOfContents();
+        m_titleHeaders.clear();
+        saveIndex(indexPath, stamp, data, length);
+    }
+    file.close();       // libère la projection
+
+    m_treatiseIds.clear();
+    m_treatiseIds.reserve(m_treatises.size());
+    for (int i = 0; i < m_treatises.size(); ++i) {
+        if (!m_treatiseIds.contains(m_treatises[i].code)) {
+            m_treatiseIds.insert(m_treatises[i].code, i);   // premier traité du code
+        }
+    }
+
+    // Clé de validité des index dérivés : fichier source et découpage en traités
+    m_filePath = filePath;
+    m_contentKey.clear();
+    {
+        QDataStream keyStream(&m_contentKey, QIODevice::WriteOnly);
+        keyStream << INDEX_VERSION << stamp.size << stamp.modifiedMs << qint64(m_rawContent.size())
+                  << qint32(m_pageOffset) << qint32(m_treatises.size());
+    }
+    m_narrationCaches.clear();
 
-    parsePages();
-    detectPageOffset();
-    parseTableOfContents();
+    buildEntityIndex();
+    buildSearchIndex();
 
     m_loaded = true;
     LOG_INFO(QString("Loaded Codex file: %1 pages, %2 treatises, offset: %3")
-             .arg(m_pages.size()).arg(m_treatises.size()).arg(m_pageOffset));
+             .arg(m_pageSpans.size()).arg(m_treatises.size()).arg(m_pageOffset));
     return true;
 }
 
-void TextParser::parsePages() {
-    m_pages.clear();
+QString TextParser::indexPathFor(const QString& filePath) {
+    return filePath + ".idx";
+}
 
-    // Split by "## Page X" markers
-    QRegularExpression pageRegex("## Page (\\d+)\\s*\\n");
-    QRegularExpressionMatchIterator it = pageRegex.globalMatch(m_rawContent);
+QString TextParser::searchIndexPathFor(const QString& filePath) {
+    return filePath + ".search";
+}
 
-    QVector<int> pageStarts;
-    QVector<int> pageNumbers;
+QString TextParser::narrationCachePathFor(const QString& filePath, quint32 settingsKey) {
+    return filePath + QString(".narration-%1").arg(settingsKey, 3, 16, QChar('0'));
+}
 
-    while (it.hasNext()) {
-        QRegularExpressionMatch match = it.next();
-        pageStarts.append(match.capturedEnd());
-        pageNumbers.append(match.captured(1).toInt());
+bool TextParser::loadIndex(const QString& indexPath, SourceStamp& stamp, const char* data, qsizetype length) {
+    QFile file(indexPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
     }
 
-    // Extract content between page markers
-    for (int i = 0; i < pageStarts.size(); ++i) {
-        int start = pageStarts[i];
-        int end = (i + 1 < pageStarts.size()) ?
-                  m_rawContent.lastIndexOf("---", pageStarts[i + 1]) :
-                  m_rawContent.length();
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_5);
 
-        if (end < start) end = m_rawContent.length();
+    quint32 magic = 0, version = 0;
+    qint64 size = 0, modifiedMs = 0, contentLength = 0;
+    QByteArray hash;
+    in >> magic >> version >> size >> modifiedMs >> hash >> contentLength;
 
-        QString pageContent = m_rawContent.mid(start, end - start).trimmed();
+    if (in.status() != QDataStream::Ok || magic != INDEX_MAGIC || version != INDEX_VERSION
+        || size != stamp.size || contentLength != m_rawContent.size()) {
+        LOG_INFO("Codex index missing or outdated, parsing source");
+        return false;
+    }
 
-        // Remove trailing "---"
-        if (pageContent.endsWith("---")) {
-            pageContent.chop(3);
-            pageContent = pageContent.trimmed();
+    // Date différente (copie, checkout) : le contenu peut être identique
+    if (modifiedMs != stamp.modifiedMs) {
+        stamp.hash = sourceHash(data, length);
+        if (stamp.hash != hash) {
+            LOG_INFO("Codex file changed since index was written, parsing source");
+            return false;
         }
+    }
 
-        // Ensure we have enough slots
-        int pageNum = pageNumbers[i];
-        while (m_pages.size() <= pageNum) {
-            m_pages.append(QString());
+    qint32 pageOffset = 0, pageCount = 0, treatiseCount = 0;
+    in >> pageOffset >> pageCount;
+    if (pageCount < 0) return false;
+
+    QVector<PageSpan> spans(pageCount);
+    for (PageSpan& span : spans) {
+        qint64 offset = 0, spanLength = 0;
+        in >> offset >> spanLength;
+        if (offset < 0 || spanLength < 0 || offset + spanLength > m_rawContent.size()) {
+            LOG_WARN("Codex index corrupted, parsing source");
+            return false;
         }
-        m_pages[pageNum] = pageContent;
+        span = {offset, spanLength};
     }
 
-    LOG_INFO(QString("Parsed %1 pages from Codex").arg(m_pages.size()));
+    in >> treatiseCount;
+    if (treatiseCount < 0) return false;
+
+    QVector<TreatiseInfo> treatises(treatiseCount);
+    for (TreatiseInfo& info : treatises) {
+        qint32 startPage = 0, endPage = 0;
+        in >> info.code >> info.pages >> info.title >> startPage >> endPage;
+        info.startPage = startPage;
+        info.endPage = endPage;
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        LOG_WARN("Codex index truncated, parsing source");
+        return false;
+    }
+
+    m_pageSpans = spans;
+    m_treatises = treatises;
+    m_pageOffset = pageOffset;
+
+    // Réécrit l'empreinte pour éviter de rehacher au prochain lancement
+    if (modifiedMs != stamp.modifiedMs) {
+        saveIndex(indexPath, stamp, data, length);
+    }
+
+    LOG_INFO(QString("Loaded Codex index: %1 pages, %2 treatises").arg(pageCount).arg(treatiseCount));
+    return true;
 }
 
-void TextParser::detectPageOffset() {
-    m_pageOffset = 0;
+void TextParser::saveIndex(const QString& indexPath, SourceStamp& stamp, const char* data, qsizetype length) const {
+    if (stamp.hash.isEmpty()) {
+        stamp.hash = sourceHash(data, length);
+    }
 
-    // Look for "Codex I-1" pattern which marks page 1 content (dashes normalized to hyphen)
-    QRegularExpression codexStartRegex(R"(^1\s*\nCodex\s+I-1)",
-                                        QRegularExpression::MultilineOption);
+    QSaveFile file(indexPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        LOG_WARN(QString("Cannot write Codex index: %1").arg(indexPath));
+        return;
+    }
 
-    for (int i = 0; i < m_pages.size(); ++i) {
-        if (codexStartRegex.match(m_pages[i]).hasMatch()) {
-            // Found page 1 content at file page i
-            // TOC says page 1, but it's at file page i, so offset = i - 1
-            m_pageOffset = i - 1;
-            LOG_INFO(QString("Detected page offset: %1 (page 1 content found at file page %2)")
-                     .arg(m_pageOffset).arg(i));
-            return;
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_5);
+
+    out << INDEX_MAGIC << INDEX_VERSION << stamp.size << stamp.modifiedMs << stamp.hash
+        << qint64(m_rawContent.size());
+
+    out << qint32(m_pageOffset) << qint32(m_pageSpans.size());
+    for (const PageSpan& span : m_pageSpans) {
+        out << qint64(span.offset) << qint64(span.length);
+    }
+
+    out << qint32(m_treatises.size());
+    for (const TreatiseInfo& info : m_treatises) {
+        out << info.code << info.pages << info.title << qint32(info.startPage) << qint32(info.endPage);
+    }
+
+    if (!file.commit()) {
+        LOG_WARN(QString("Cannot write Codex index: %1").arg(indexPath));
+    }
+}
+
+void TextParser::normalizeContent() {
+    // Une seule passe, en place : les remplacements ne rallongent jamais le texte
+    // - fins de ligne Windows (CRLF) et Mac (CR) vers LF
+    // - tirets demi-cadratin et cadratin vers "-" pour un parsing uniforme
+    QChar* begin = m_rawContent.data();
+    QChar* out = begin;
+    const QChar* in = begin;
+    const QChar* end = begin + m_rawContent.size();
+
+    while (in < end) {
+        QChar c = *in++;
+        if (c == u'\r') {
+            if (in < end && *in == u'\n') ++in;
+            c = u'\n';
+        } else if (c == u'\u2013' || c == u'\u2014') {
+            c = u'-';
         }
+        *out++ = c;
+    }
+
+    m_rawContent.truncate(out - begin);
+}
+
+void TextParser::detectPageOffset(int codexStartPage) {
+    m_pageOffset = 0;
+
+    // "1" then "Codex I-1" marks page 1 content, found by the scanner
+    if (codexStartPage >= 0) {
+        // TOC says page 1, but it's at file page i, so offset = i - 1
+        m_pageOffset = codexStartPage - 1;
+        LOG_INFO(QString("Detected page offset: %1 (page 1 content found at file page %2)")
+                 .arg(m_pageOffset).arg(codexStartPage));
+        return;
     }
 
     // Fallback: look for "Prière" which is typically the first treatise
     QRegularExpression prayerRegex(R"(Prière\s+de\s+l['']?\s*Apôtre\s+Paul)",
                                     QRegularExpression::CaseInsensitiveOption);
 
-    for (int i = 0; i < m_pages.size(); ++i) {
-        if (prayerRegex.match(m_pages[i]).hasMatch()) {
+    for (int i = 0; i < m_pageSpans.size(); ++i) {
+        if (prayerRegex.matchView(pageView(i)).hasMatch()) {
             // First treatise typically starts at TOC page 1
             m_pageOffset = i - 1;
             LOG_INFO(QString("Detected page offset via Prière: %1").arg(m_pageOffset));
@@ -150,31 +309,21 @@ QVector<TreatiseInfo> TextParser::parseTableOfContents() {
     // ou "II–2 32-51 L'Évangile selon Thomas . . . . . . . . . . 101"
 
     QString tocContent;
-    for (int i = 7; i <= 8 && i < m_pages.size(); ++i) {
-        tocContent += m_pages[i] + "\n";
+    for (int i = 7; i <= 8 && i < m_pageSpans.size(); ++i) {
+        tocContent += pageView(i);
+        tocContent += u'\n';
     }
 
-    // Regex pour parser les entrées de la table des matières
-    // Capture: code (I-1), pages manuscrit (A-B ou 1-16), titre, page fichier
+    // Entrées lues par l'analyseur : code (I-1), pages manuscrit (A-B ou 1-16),
+    // titre, page fichier ; les points peuvent être espacés ". . . ."
     // Note: dashes are normalized to hyphen in loadCodexFile()
-    // Note: dots may be separated by spaces: ". . . ." instead of "...."
-    QRegularExpression tocRegex(
-        R"(([IVX]+-\d+|8502-\d+|X)\s+(\d+\*?-\d+\*?|A-B)\s+(.+?)\s*(?:\.[\s.]*){2,}\s*(\d+))"
-    );
-
-    QRegularExpressionMatchIterator it = tocRegex.globalMatch(tocContent);
-
-    while (it.hasNext()) {
-        QRegularExpressionMatch match = it.next();
-        TreatiseInfo info;
-        info.code = normalizeCode(match.captured(1));
-        info.pages = match.captured(2);
-        info.title = match.captured(3).trimmed();
-        info.startPage = match.captured(4).toInt();
+    for (TreatiseInfo info : CodexScanner::scanTableOfContents(tocContent)) {
+        info.code = normalizeCode(info.code);
 
         // Clean title (remove L', Le, La, Les prefixes artifacts)
-        info.title = info.title.replace(QRegularExpression("^L '"), "L'");
-        info.title = info.title.replace(QRegularExpression("^L'"), "L'");
+        if (info.title.startsWith(u"L '")) {
+            info.title.remove(1, 1);
+        }
 
         m_treatises.append(info);
     }
@@ -184,7 +333,7 @@ QVector<TreatiseInfo> TextParser::parseTableOfContents() {
         m_treatises[i].endPage = m_treatises[i + 1].startPage - 1;
     }
     if (!m_treatises.isEmpty()) {
-        m_treatises.last().endPage = m_pages.size() - 1;
+        m_treatises.last().endPage = m_pageSpans.size() - 1;
     }
 
     // Si aucun traité trouvé, essayer la détection alternative par titres (NH X, Y)
@@ -198,29 +347,15 @@ QVector<TreatiseInfo> TextParser::parseTableOfContents() {
 
 void TextParser::parseByTitleHeaders() {
     // Détection alternative pour fichiers sans table des matières structurée
-    // Cherche les titres avec format "TITRE (NH X, Y)" ou "<TITRE> (NH X, Y)"
-
-    QRegularExpression titleRegex(
-        R"(^<?([A-ZÀÂÄÉÈÊËÏÎÔÙÛÜÇ][A-ZÀÂÄÉÈÊËÏÎÔÙÛÜÇ'\s\-]+?)>?\s*\(NH\s+([IVX]+),?\s*(\d+)\))",
-        QRegularExpression::MultilineOption
-    );
+    // Titres "TITRE (NH X, Y)" ou "<TITRE> (NH X, Y)" relevés par l'analyseur
 
     QMap<QString, int> treatiseFirstPage;  // code -> première page
     QMap<QString, QString> treatiseTitles; // code -> titre
 
-    for (int pageIdx = 0; pageIdx < m_pages.size(); ++pageIdx) {
-        QRegularExpressionMatchIterator it = titleRegex.globalMatch(m_pages[pageIdx]);
-        while (it.hasNext()) {
-            QRegularExpressionMatch match = it.next();
-            QString title = match.captured(1).trimmed();
-            QString codex = match.captured(2);
-            QString num = match.captured(3);
-            QString code = codex + "-" + num;
-
-            if (!treatiseFirstPage.contains(code)) {
-                treatiseFirstPage[code] = pageIdx;
-                treatiseTitles[code] = title;
-            }
+    for (const CodexTitleHeader& header : m_titleHeaders) {
+        if (!treatiseFirstPage.contains(header.code)) {
+            treatiseFirstPage[header.code] = header.page;
+            treatiseTitles[header.code] = header.title;
         }
     }
 
@@ -239,7 +374,7 @@ void TextParser::parseByTitleHeaders() {
         info.startPage = sortedTreatises[i].first;
         info.endPage = (i + 1 < sortedTreatises.size())
                        ? sortedTreatises[i + 1].first - 1
-                       : m_pages.size() - 1;
+                       : m_pageSpans.size() - 1;
         m_treatises.append(info);
     }
 
@@ -255,53 +390,54 @@ QString TextParser::normalizeCode(const QString& code) const {
     return normalized;
 }
 
-ParsedTreatise TextParser::extractTreatise(const QString& code) {
-    ParsedTreatise result;
-    QString normalizedCode = normalizeCode(code);
-
-    // Trouver le traité dans la table des matières
-    TreatiseInfo* info = nullptr;
-    for (auto& t : m_treatises) {
-        if (t.code == normalizedCode) {
-            info = &t;
-            break;
-        }
+QString ParsedTreatise::fullText() const {
+    QString text;
+    text.reserve(textLength);
+    for (QStringView page : pages) {
+        if (!text.isEmpty()) text += u"\n\n";
+        text += page;
     }
+    return text;
+}
 
-    if (!info) {
+ParsedTreatise TextParser::extractTreatise(const QString& code) const {
+    const int index = m_treatiseIds.value(normalizeCode(code), -1);
+    if (index < 0) {
         LOG_WARN(QString("Treatise not found: %1").arg(code));
-        return result;
+        return ParsedTreatise();
     }
+    return treatiseAt(index);
+}
 
-    result.code = info->code;
-    result.title = info->title;
-    result.startPage = info->startPage;
-
-    // Extraire le contenu des pages (avec offset)
-    QStringList contentParts;
-    int actualStartPage = info->startPage + m_pageOffset;
-    int actualEndPage = info->endPage + m_pageOffset;
+ParsedTreatise TextParser::treatiseAt(int index) const {
+    const TreatiseInfo& info = m_treatises[index];
 
-    for (int p = actualStartPage; p <= actualEndPage && p < m_pages.size(); ++p) {
-        QString pageContent = m_pages[p];
-        if (!pageContent.isEmpty()) {
-            contentParts.append(pageContent);
-            result.pages.append(pageContent);
-        }
+    ParsedTreatise result;
+    result.code = info.code;
+    result.title = info.title;
+    result.startPage = info.startPage;
+
+    // Vues sur les pages du traité (avec offset), sans copie
+    const auto [firstPage, lastPage] = pageRange(info);
+    for (int p = firstPage; p <= lastPage; ++p) {
+        const QStringView page = pageView(p);
+        if (page.isEmpty()) continue;
+
+        result.textLength += (result.pages.isEmpty() ? 0 : 2) + page.size();
+        result.pages.append(page);
     }
 
-    result.fullText = contentParts.join("\n\n");
-
     return result;
 }
 
-QVector<ParsedTreatise> TextParser::parseAllTreatises() {
+QVector<ParsedTreatise> TextParser::parseAllTreatises() const {
     QVector<ParsedTreatise> results;
+    results.reserve(m_treatises.size());
 
-    for (const auto& info : m_treatises) {
-        ParsedTreatise treatise = extractTreatise(info.code);
-        if (!treatise.fullText.isEmpty()) {
-            results.append(treatise);
+    for (int i = 0; i < m_treatises.size(); ++i) {
+        ParsedTreatise treatise = treatiseAt(i);
+        if (!treatise.isEmpty()) {
+            results.append(std::move(treatise));
         }
     }
 
@@ -309,10 +445,15 @@ QVector<ParsedTreatise> TextParser::parseAllTreatises() {
 }
 
 QString TextParser::getPageContent(int pageNumber) {
-    if (pageNumber >= 0 && pageNumber < m_pages.size()) {
-        return m_pages[pageNumber];
+    return pageView(pageNumber).toString();
+}
+
+QStringView TextParser::pageView(int pageNumber) const {
+    if (pageNumber >= 0 && pageNumber < m_pageSpans.size()) {
+        const PageSpan& span = m_pageSpans[pageNumber];
+        return QStringView(m_rawContent).mid(span.offset, span.length);
     }
-    return QString();
+    return QStringView();
 }
 
 ParsedPassage TextParser::extractPassage(const QString& fullText, int start, int end) {
@@ -324,22 +465,233 @@ ParsedPassage TextParser::extractPassage(const QString& fullText, int start, int
     return passage;
 }
 
-QStringList TextParser::detectGnosticEntities(const QString& text) {
-    QStringList detected;
-    QString lowerText = text.toLower();
+QStringList TextParser::detectGnosticEntities(const QString& text) const {
+    // Une seule passe sur le texte, mots entiers uniquement
+    return m_entityMatcher.detect(text);
+}
+
+QVector<EntityMatch> TextParser::matchGnosticEntities(const QString& text) const {
+    return m_entityMatcher.match(text);
+}
+
+void TextParser::buildEntityIndex() {
+    QElapsedTimer timer;
+    timer.start();
+
+    QStringList codes;
+    for (const TreatiseInfo& info : m_treatises) {
+        codes.append(info.code);
+    }
+    m_entityIndex.reset(m_entityMatcher.entityNames(), codes);
+
+    // Une passe de l'automate par page de chaque traité
+    for (int t = 0; t < m_treatises.size(); ++t) {
+        const auto [firstPage, lastPage] = pageRange(m_treatises[t]);
+        for (int p = firstPage; p <= lastPage; ++p) {
+            m_entityIndex.addPage(t, p, m_pageSpans[p].offset, m_entityMatcher.match(pageView(p)));
+        }
+    }
+    m_entityIndex.finish();
+
+    LOG_INFO(QString("Entity index: %1 occurrences in %2 treatises (%3 ms)")
+             .arg(m_entityIndex.postingCount()).arg(m_treatises.size()).arg(timer.elapsed()));
+}
+
+QPair<int, int> TextParser::pageRange(const TreatiseInfo& info) const {
+    return {qMax(0, info.startPage + m_pageOffset),
+            qMin(int(m_pageSpans.size()) - 1, info.endPage + m_pageOffset)};
+}
+
+QString TextParser::passageText(const EntityPassage& passage, int context) const {
+    return contextText(passage.start, passage.end, context);
+}
+
+QString TextParser::contextText(qsizetype start, qsizetype end, int context) const {
+    const qsizetype size = m_rawContent.size();
+    start = qBound(qsizetype(0), start, size);
+    end = qBound(start, end, size);
+
+    auto isSentenceEnd = [](QChar c) {
+        return c == u'.' || c == u'!' || c == u'?';
+    };
+
+    // Début de la phrase, sans remonter au-delà du contexte ni d'un marqueur de page
+    const qsizetype minStart = qMax(qsizetype(0), start - context);
+    while (start > minStart && !isSentenceEnd(m_rawContent[start - 1]) && m_rawContent[start - 1] != u'#') {
+        --start;
+    }
+
+    // Fin de la phrase, ponctuation comprise
+    const qsizetype maxEnd = qMin(size, end + context);
+    while (end < maxEnd && m_rawContent[end] != u'#') {
+        if (isSentenceEnd(m_rawContent[end++])) break;
+    }
+
+    return m_rawContent.mid(start, end - start).trimmed();
+}
+
+void TextParser::buildSearchIndex() {
+    QElapsedTimer timer;
+    timer.start();
+
+    const QString indexPath = searchIndexPathFor(m_filePath);
+    if (m_searchIndex.load(indexPath, m_contentKey)) {
+        LOG_INFO(QString("Loaded search index: %1 terms in %2 pages (%3 ms)")
+                 .arg(m_searchIndex.termCount()).arg(m_searchIndex.documentCount()).arg(timer.elapsed()));
+        return;
+    }
+
+    QVector<SearchPage> pages;
+    for (int t = 0; t < m_treatises.size(); ++t) {
+        const auto [firstPage, lastPage] = pageRange(m_treatises[t]);
+        for (int p = firstPage; p <= lastPage; ++p) {
+            pages.append({t, p, m_pageSpans[p].offset, pageView(p)});
+        }
+    }
+    m_searchIndex.build(pages);
+
+    if (!m_searchIndex.save(indexPath, m_contentKey)) {
+        LOG_WARN(QString("Cannot write search index: %1").arg(indexPath));
+    }
+
+    LOG_INFO(QString("Built search index: %1 terms, %2 words in %3 pages (%4 ms)")
+             .arg(m_searchIndex.termCount()).arg(m_searchIndex.tokenCount())
+             .arg(m_searchIndex.documentCount()).arg(timer.elapsed()));
+}
+
+std::function<NarrationCache()> TextParser::narrationCacheTask(const NarrationCleaner& cleaner) const {
+    if (!m_loaded) {
+        return [] { return NarrationCache(); };
+    }
+
+    // Mêmes pages que treatiseAt(), le cache suit la numérotation des traités.
+    // Les vues restent valides : la tâche garde une référence au contenu
+    QVector<NarrationSource> sources;
+    sources.reserve(m_treatises.size());
+    for (const TreatiseInfo& info : m_treatises) {
+        NarrationSource source;
+        const auto [firstPage, lastPage] = pageRange(info);
+        for (int p = firstPage; p <= lastPage; ++p) {
+            const QStringView page = pageView(p);
+            if (page.isEmpty()) continue;
+
+            source.pages.append(page);
+            source.offsets.append(m_pageSpans[p].offset);
+        }
+        sources.append(source);
+    }
+
+    const quint32 settings = cleaner.settingsKey();
+    const QByteArray key = m_contentKey + QByteArray::number(settings, 16);
+    const QString cachePath = narrationCachePathFor(m_filePath, settings);
+
+    return [content = m_rawContent, sources, cleaner, settings, key, cachePath]() {
+        Q_UNUSED(content);
+
+        QElapsedTimer timer;
+        timer.start();
+
+        NarrationCache cache;
+        if (cache.load(cachePath, key) && cache.treatiseCount() == sources.size()) {
+            LOG_INFO(QString("Loaded narration cache %1: %2 chars (%3 ms)")
+                     .arg(settings, 0, 16).arg(cache.textLength()).arg(timer.elapsed()));
+            return cache;
+        }
+
+        cache.build(sources, cleaner);
+        if (!cache.save(cachePath, key)) {
+            LOG_WARN(QString("Cannot write narration cache: %1").arg(cachePath));
+        }
+
+        LOG_INFO(QString("Built narration cache %1: %2 treatises, %3 chars, %4 runs (%5 ms)")
+                 .arg(settings, 0, 16).arg(cache.treatiseCount()).arg(cache.textLength())
+                 .arg(cache.runCount()).arg(timer.elapsed()));
+        return cache;
+    };
+}
+
+void TextParser::setNarrationCache(const NarrationCleaner& cleaner, const QByteArray& contentKey,
+                                   const NarrationCache& cache) {
+    if (!m_loaded || contentKey != m_contentKey || cache.treatiseCount() != m_treatises.size()) {
+        return;
+    }
+    m_narrationCaches.insert(cleaner.settingsKey(), cache);
+}
+
+bool TextParser::hasNarrationCache(const NarrationCleaner& cleaner) const {
+    return m_narrationCaches.contains(cleaner.settingsKey());
+}
+
+NarrationText TextParser::narrationText(const QString& code, const NarrationCleaner& cleaner) const {
+    const int index = m_treatiseIds.value(normalizeCode(code), -1);
+    const auto it = m_narrationCaches.constFind(cleaner.settingsKey());
+    if (index < 0 || it == m_narrationCaches.cend()) {
+        return NarrationText();
+    }
+    return it->treatise(index);
+}
+
+QString TextParser::narrationPassage(const QString& code, qsizetype start, qsizetype end,
+                                     const NarrationCleaner& cleaner) const {
+    const int index = m_treatiseIds.value(normalizeCode(code), -1);
+    const auto it = m_narrationCaches.constFind(cleaner.settingsKey());
+    if (index < 0 || it == m_narrationCaches.cend()) {
+        return QString();
+    }
+    return it->text(index, start, end);
+}
+
+QVector<SearchResult> TextParser::search(const QString& query, int limit) const {
+    QVector<SearchResult> results;
+
+    for (const SearchHit& hit : m_searchIndex.search(query, limit)) {
+        SearchResult result;
+        result.code = m_treatises.value(hit.treatise).code;
+        result.page = hit.page;
+        result.start = hit.start;
+        result.end = hit.end;
+        result.score = hit.score;
+        result.passage = contextText(hit.start, hit.end, 300);
+        locateVerse(hit.treatise, hit.start, result);
+        results.append(result);
+    }
+
+    return results;
+}
 
-    for (auto it = m_entityKeywords.constBegin(); it != m_entityKeywords.constEnd(); ++it) {
-        for (const QString& keyword : it.value()) {
-            if (lowerText.contains(keyword.toLower())) {
-                if (!detected.contains(it.key())) {
-                    detected.append(it.key());
-                }
-                break;
+void TextParser::locateVerse(int treatise, qsizetype offset, SearchResult& result) const {
+    // Même numérotation que TextViewerWidget::setTextWithVerses : "|" change de
+    // page du manuscrit, une ligne vide de paragraphe ; les notes ne comptent pas
+    if (treatise < 0 || treatise >= m_treatises.size()) return;
+
+    const TreatiseInfo& info = m_treatises[treatise];
+    const auto [firstPage, lastPage] = pageRange(info);
+
+    int page = info.startPage;
+    int verse = 0;
+    for (int p = firstPage; p <= lastPage && m_pageSpans[p].offset <= offset; ++p) {
+        bool inParagraph = false;       // les pages sont jointes par une ligne vide
+        const qsizetype end = qMin(m_pageSpans[p].offset + m_pageSpans[p].length, offset);
+
+        for (qsizetype i = m_pageSpans[p].offset; i < end; ++i) {
+            const QChar c = m_rawContent[i];
+            if (c == u'|') {
+                ++page;
+                verse = 0;
+                inParagraph = false;
+            } else if (c == u'\n') {
+                qsizetype k = i + 1;
+                while (k < end && m_rawContent[k].isSpace() && m_rawContent[k] != u'\n') ++k;
+                if (k < end && m_rawContent[k] == u'\n') inParagraph = false;
+            } else if (!inParagraph && !c.isSpace()) {
+                inParagraph = true;
+                if (c != u'*' && c != u'†') ++verse;
             }
         }
     }
 
-    return detected;
+    result.manuscriptPage = page;
+    result.verse = qMax(1, verse);
 }
 
 } // namespace codex::core
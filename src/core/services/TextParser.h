@@ -1,10 +1,19 @@
 #pragma once
 
+#include "core/entities/EntityIndex.h"
+#include "core/entities/EntityMatcher.h"
+#include "core/services/NarrationCache.h"
+#include "core/services/SearchIndex.h"
+
 #include <QString>
+#include <QStringView>
 #include <QVector>
 #include <QStringList>
+#include <QHash>
 #include <QMap>
 
+#include <functional>
+
 namespace codex::core {
 
 struct TreatiseInfo {
@@ -15,13 +24,46 @@ struct TreatiseInfo {
     int endPage = 0;        // Page de fin
 };
 
+// Traité extrait sans copie : les pages sont des vues sur le contenu du parser,
+// valides tant que le fichier reste chargé
 struct ParsedTreatise {
     QString code;
     QString title;
-    QString fullText;
-    QVector<QString> pages;
+    QVector<QStringView> pages;     // Pages non vides du traité
     QString category;       // Catégorie mythique
     int startPage = 0;      // Page de début (pour numérotation des versets)
+    qsizetype textLength = 0;       // Longueur de fullText(), sans le construire
+
+    bool isEmpty() const { return pages.isEmpty(); }
+
+    // Texte complet, pages séparées par une ligne vide ; copie faite à la demande,
+    // sans état partagé (appelable depuis plusieurs threads)
+    QString fullText() const;
+};
+
+// Vue sur une page : position et longueur dans le contenu brut
+struct PageSpan {
+    qsizetype offset = 0;
+    qsizetype length = 0;
+};
+
+// Titre de traité "TITRE (NH X, Y)" trouvé dans une page
+struct CodexTitleHeader {
+    int page = 0;           // Page fichier
+    QString code;           // "II-3"
+    QString title;
+};
+
+// Résultat de la recherche plein texte, prêt pour l'affichage et la navigation
+struct SearchResult {
+    QString code;               // Traité
+    int page = 0;               // Page fichier
+    int manuscriptPage = 0;     // Page du manuscrit, numérotée comme dans le lecteur
+    int verse = 0;              // Paragraphe dans cette page
+    qsizetype start = 0;        // Correspondance dans le contenu brut
+    qsizetype end = 0;
+    double score = 0.0;         // BM25
+    QString passage;            // Phrase(s) autour de la correspondance
 };
 
 struct ParsedPassage {
@@ -47,35 +89,114 @@ public:
     // Parse la table des matières et retourne la liste des traités
     QVector<TreatiseInfo> parseTableOfContents();
 
-    // Extrait le contenu d'un traité spécifique
-    ParsedTreatise extractTreatise(const QString& code);
+    // Extrait le contenu d'un traité spécifique (recherche du code par table de hachage)
+    ParsedTreatise extractTreatise(const QString& code) const;
 
-    // Extrait tous les traités
-    QVector<ParsedTreatise> parseAllTreatises();
+    // Extrait tous les traités en une passe sur les pages, sans copier le texte
+    QVector<ParsedTreatise> parseAllTreatises() const;
 
     // Extrait un passage sélectionné
     ParsedPassage extractPassage(const QString& fullText, int start, int end);
 
     // Détecte les entités gnostiques dans le texte
-    QStringList detectGnosticEntities(const QString& text);
+    QStringList detectGnosticEntities(const QString& text) const;
+
+    // Entités détectées avec le nombre et la position de leurs occurrences
+    QVector<EntityMatch> matchGnosticEntities(const QString& text) const;
+
+    // Index des occurrences d'entités de tout le Codex, construit au chargement
+    const EntityIndex& entityIndex() const { return m_entityIndex; }
+
+    // Entité désignée par son nom ou un mot-clé ("démiurge", "Yaldabaoth"), -1 sinon
+    int resolveEntity(const QString& term) const { return m_entityMatcher.entityId(term); }
+
+    // Texte d'un passage de l'index, étendu aux phrases qui l'entourent
+    QString passageText(const EntityPassage& passage, int context = 300) const;
+
+    // Recherche plein texte classée (BM25) : mots, "phrase exacte", "mots proches"~N
+    QVector<SearchResult> search(const QString& query, int limit = 50) const;
+
+    // Index plein texte, construit ou relu au chargement
+    const SearchIndex& searchIndex() const { return m_searchIndex; }
+
+    // Préparation du texte de narration de tous les traités pour ces réglages :
+    // relu depuis le disque, ou construit puis sauvegardé. La tâche garde sa
+    // copie partagée du contenu et ne touche pas au parser, elle peut tourner
+    // sur un autre thread même si un autre fichier est chargé entre-temps
+    std::function<NarrationCache()> narrationCacheTask(const NarrationCleaner& cleaner) const;
+
+    // Rend disponible le résultat de narrationCacheTask() ; ignoré si un autre
+    // fichier a été chargé depuis (contentKey() différente)
+    void setNarrationCache(const NarrationCleaner& cleaner, const QByteArray& contentKey,
+                           const NarrationCache& cache);
+    bool hasNarrationCache(const NarrationCleaner& cleaner) const;
+
+    // Identifie le fichier chargé et son découpage en traités
+    QByteArray contentKey() const { return m_contentKey; }
+
+    // Traité nettoyé, avec la position dans le contenu brut de chaque caractère ;
+    // vide tant que le cache de ces réglages n'est pas prêt
+    NarrationText narrationText(const QString& code, const NarrationCleaner& cleaner) const;
+
+    // Texte nettoyé de [start, end) du contenu brut, pris dans le cache du
+    // traité ; vide tant que le cache n'est pas prêt. Les titres en majuscules
+    // répétés sont retirés sur tout le traité : un titre déjà vu plus haut dans
+    // le traité manque aussi au passage
+    QString narrationPassage(const QString& code, qsizetype start, qsizetype end,
+                             const NarrationCleaner& cleaner) const;
 
     // Retourne le contenu d'une page spécifique
     QString getPageContent(int pageNumber);
 
+    // Vue sans copie sur une page, valide tant que le fichier reste chargé
+    QStringView pageView(int pageNumber) const;
+
     // Retourne le nombre total de pages
-    int pageCount() const { return m_pages.size(); }
+    int pageCount() const { return m_pageSpans.size(); }
+
+    // Chemin de l'index binaire écrit à côté du fichier Codex
+    static QString indexPathFor(const QString& filePath);
+
+    // Chemin de l'index plein texte écrit à côté du fichier Codex
+    static QString searchIndexPathFor(const QString& filePath);
+
+    // Chemin du texte de narration précalculé pour un jeu de réglages
+    static QString narrationCachePathFor(const QString& filePath, quint32 settingsKey);
 
 private:
+    // Empreinte du fichier source qui valide l'index binaire
+    struct SourceStamp {
+        qint64 size = 0;
+        qint64 modifiedMs = 0;
+        QByteArray hash;        // SHA-1, calculé seulement si nécessaire
+    };
+
+    bool loadIndex(const QString& indexPath, SourceStamp& stamp, const char* data, qsizetype length);
+    void saveIndex(const QString& indexPath, SourceStamp& stamp, const char* data, qsizetype length) const;
+
     void loadEntityKeywords();
-    void parsePages();
-    void detectPageOffset();
+    void buildEntityIndex();
+    void buildSearchIndex();
+    QPair<int, int> pageRange(const TreatiseInfo& info) const;     // Pages fichier du traité
+    ParsedTreatise treatiseAt(int index) const;
+    QString contextText(qsizetype start, qsizetype end, int context) const;
+    void locateVerse(int treatise, qsizetype offset, SearchResult& result) const;
+    void normalizeContent();
+    void detectPageOffset(int codexStartPage);
     void parseByTitleHeaders();  // Détection alternative par titres (NH X, Y)
     QString normalizeCode(const QString& code) const;
 
-    QString m_rawContent;
-    QVector<QString> m_pages;           // Contenu par page
+    QString m_rawContent;               // Texte normalisé, seule copie en mémoire
+    QVector<PageSpan> m_pageSpans;      // Pages : vues dans m_rawContent
     QVector<TreatiseInfo> m_treatises;  // Table des matières parsée
-    QMap<QString, QStringList> m_entityKeywords;
+    QHash<QString, int> m_treatiseIds;  // Code -> index dans m_treatises
+    QVector<CodexTitleHeader> m_titleHeaders;  // Titres (NH X, Y), le temps du parsing
+    EntityMatcher m_entityMatcher;      // Automate compilé des mots-clés d'entités
+    EntityIndex m_entityIndex;          // Occurrences d'entités par traité et page
+    SearchIndex m_searchIndex;          // Index plein texte des pages des traités
+    QMap<quint32, NarrationCache> m_narrationCaches;   // Réglages du nettoyeur -> texte précalculé
+    QString m_filePath;                 // Fichier Codex chargé
+    QByteArray m_contentKey;            // Valide les index dérivés écrits sur disque
     int m_pageOffset = 0;               // Décalage entre pages TOC et pages fichier
     bool m_loaded = false;
 };
@@ -0,0 +1,405 @@
+#include "VideoExporter.h"
+#include "utils/Logger.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QPainter>
+#include <QStandardPaths>
+
+#include <cstring>
+
+namespace codex::core {
+
+namespace {
+
+// Overall progress share of the narration probing step
+constexpr int PROBE_END = 5;
+
+// Frames kept queued in the encoder's stdin before waiting for bytesWritten
+constexpr int QUEUED_FRAMES = 4;
+
+} // namespace
+
+VideoExporter::VideoExporter(QObject* parent)
+    : QObject(parent)
+{
+}
+
+VideoExporter::~VideoExporter() {
+    if (isRunning()) {
+        cancel();
+    }
+}
+
+QString VideoExporter::ffmpegPath() {
+    // Only file lookups, no process spawned; the result is kept for the whole run
+    static const QString path = [] {
+        QString found = QStandardPaths::findExecutable("ffmpeg");
+        if (found.isEmpty()) {
+            // Common Windows installation paths when ffmpeg is not in PATH
+            const QStringList searchPaths = {
+                QDir::homePath() + "/AppData/Local/Microsoft/WinGet/Links/ffmpeg.exe",
+                "C:/ffmpeg/bin/ffmpeg.exe",
+                "C:/Program Files/ffmpeg/bin/ffmpeg.exe",
+                "C:/Program Files (x86)/ffmpeg/bin/ffmpeg.exe"
+            };
+            for (const QString& candidate : searchPaths) {
+                if (QFileInfo(candidate).isExecutable()) {
+                    found = candidate;
+                    break;
+                }
+            }
+        }
+
+        if (found.isEmpty()) {
+            LOG_WARN("FFmpeg not found in PATH or common locations");
+        } else {
+            LOG_INFO(QString("FFmpeg found at: %1").arg(found));
+        }
+        return found;
+    }();
+    return path;
+}
+
+QString VideoExporter::ffprobePath() {
+    // ffprobe ships next to ffmpeg in every distribution
+    static const QString path = [] {
+        QString found = QStandardPaths::findExecutable("ffprobe");
+        if (found.isEmpty() && !ffmpegPath().isEmpty()) {
+            QFileInfo ffmpeg(ffmpegPath());
+            QString candidate = ffmpeg.dir().filePath(
+                ffmpeg.suffix().isEmpty() ? QString("ffprobe") : "ffprobe." + ffmpeg.suffix());
+            if (QFileInfo(candidate).isExecutable()) {
+                found = candidate;
+            }
+        }
+        if (found.isEmpty()) {
+            LOG_WARN("ffprobe not found, narration durations will be estimated");
+        }
+        return found;
+    }();
+    return path;
+}
+
+bool VideoExporter::start(const QList<VideoExportSlide>& slides, const QString& outputPath) {
+    if (isRunning()) {
+        LOG_WARN("VideoExporter: export already running");
+        return false;
+    }
+
+    if (ffmpegPath().isEmpty()) {
+        emit failed("FFmpeg introuvable");
+        return false;
+    }
+
+    m_slides = slides;
+    m_outputPath = outputPath;
+
+    // Every frame is scaled into the first one's size, even for yuv420p
+    m_frameSize = m_slides.isEmpty() ? QSize() : m_slides.first().frame.size();
+    m_frameSize = QSize(m_frameSize.width() & ~1, m_frameSize.height() & ~1);
+
+    if (m_frameSize.isEmpty()) {
+        cleanup();
+        emit failed("Aucune image a exporter.");
+        return false;
+    }
+
+    LOG_INFO(QString("VideoExporter: exporting %1 slides (%2x%3) to %4")
+             .arg(m_slides.size()).arg(m_frameSize.width()).arg(m_frameSize.height()).arg(outputPath));
+
+    m_step = Step::ProbingAudio;
+    emit progressChanged(0, "Mesure de la narration...");
+    m_probeIndex = -1;
+    probeNextAudio();
+    return true;
+}
+
+void VideoExporter::cancel() {
+    if (!isRunning()) return;
+
+    LOG_INFO("VideoExporter: export cancelled");
+    m_step = Step::Idle;
+    cleanup();
+    emit cancelled();
+}
+
+void VideoExporter::probeNextAudio() {
+    // The slide timing estimates (EdgeTTS only guesses from the text length)
+    // are replaced by the real duration of each narration clip
+    if (!ffprobePath().isEmpty()) {
+        while (++m_probeIndex < m_slides.size()) {
+            if (m_slides[m_probeIndex].audioPath.isEmpty()) continue;
+
+            QStringList args;
+            args << "-v" << "error";
+            args << "-show_entries" << "format=duration";
+            args << "-of" << "default=noprint_wrappers=1:nokey=1";
+            args << m_slides[m_probeIndex].audioPath;
+
+            emit progressChanged(m_probeIndex * PROBE_END / m_slides.size(), "Mesure de la narration...");
+            runProcess(Step::ProbingAudio, ffprobePath(), args);
+            return;
+        }
+    }
+
+    encodeVideo();
+}
+
+void VideoExporter::layoutFrames() {
+    // Slide boundaries come from the cumulative duration so rounding to
+    // whole frames never accumulates drift: every boundary stays within
+    // half a frame of the end of its narration
+    m_totalDurationMs = 0;
+    m_slideEndFrames.clear();
+    for (const auto& slide : m_slides) {
+        m_totalDurationMs += slide.durationMs;
+        m_slideEndFrames.append((m_totalDurationMs * FRAME_RATE + 500) / 1000);
+    }
+    m_totalFrames = m_slideEndFrames.isEmpty() ? 0 : m_slideEndFrames.last();
+}
+
+void VideoExporter::encodeVideo() {
+    layoutFrames();
+    if (m_totalFrames == 0) {
+        fail("Aucune image a exporter.");
+        return;
+    }
+
+    m_nextFrame = 0;
+    m_currentSlide = -1;
+    m_currentFrame.clear();
+
+    QStringList args;
+    args << "-y";  // Overwrite
+    args << "-nostats" << "-progress" << "pipe:1";
+
+    // Raw RGB frames streamed on stdin
+    args << "-f" << "rawvideo";
+    args << "-pix_fmt" << "rgb24";
+    args << "-s" << QString("%1x%2").arg(m_frameSize.width()).arg(m_frameSize.height());
+    args << "-framerate" << QString::number(FRAME_RATE);
+    args << "-i" << "pipe:0";
+
+    QStringList audioDirs;
+    for (const auto& slide : m_slides) {
+        if (!slide.audioPath.isEmpty()) {
+            QString dir = QFileInfo(slide.audioPath).absolutePath();
+            if (!audioDirs.contains(dir)) audioDirs.append(dir);
+        }
+    }
+    const bool hasNarration = !audioDirs.isEmpty();
+
+    // Clips usually share the slideshow's temp folder: ffmpeg then runs in
+    // it and gets bare file names, which keeps long plates well below the
+    // Windows command line limit
+    m_workingDir = (audioDirs.size() == 1) ? audioDirs.first() : QString();
+
+    if (hasNarration) {
+        // One audio input per slide, in slide order: the narration clip, or
+        // silence of the slide's duration when it has none
+        QString concatInputs;
+        for (int i = 0; i < m_slides.size(); ++i) {
+            const auto& slide = m_slides[i];
+            if (!slide.audioPath.isEmpty()) {
+                args << "-i" << (m_workingDir.isEmpty() ? slide.audioPath
+                                                        : QFileInfo(slide.audioPath).fileName());
+            } else {
+                args << "-f" << "lavfi" << "-t" << QString::number(slide.durationMs / 1000.0, 'f', 3);
+                args << "-i" << "anullsrc=r=24000:cl=mono";
+            }
+            concatInputs += QString("[%1:a]").arg(i + 1);
+        }
+
+        // Single pass: the narration is concatenated in the filter graph
+        // (libavfilter resamples mismatched clips) and muxed with the frames
+        args << "-filter_complex" << QString("%1concat=n=%2:v=0:a=1[aout]")
+                                         .arg(concatInputs).arg(m_slides.size());
+        args << "-map" << "0:v" << "-map" << "[aout]";
+        args << "-c:a" << "aac" << "-b:a" << "192k";
+    } else {
+        args << "-map" << "0:v";
+    }
+
+    args << "-c:v" << "libx264";
+    args << "-pix_fmt" << "yuv420p";
+    args << "-preset" << "medium";
+    args << "-crf" << "23";
+    args << m_outputPath;
+
+    emit progressChanged(PROBE_END, "Encodage video...");
+    runProcess(Step::Encoding, ffmpegPath(), args);
+}
+
+void VideoExporter::runProcess(Step step, const QString& program, const QStringList& args) {
+    m_step = step;
+    m_progressBuffer.clear();
+
+    m_process = new QProcess(this);
+    if (step == Step::Encoding && !m_workingDir.isEmpty()) {
+        m_process->setWorkingDirectory(m_workingDir);
+    }
+    connect(m_process, &QProcess::finished, this, &VideoExporter::onProcessFinished);
+    connect(m_process, &QProcess::readyReadStandardOutput, this, &VideoExporter::onProgressOutput);
+    if (step == Step::Encoding) {
+        connect(m_process, &QProcess::started, this, &VideoExporter::writeFrames);
+        connect(m_process, &QProcess::bytesWritten, this, &VideoExporter::writeFrames);
+    }
+    connect(m_process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            fail(QString("Impossible de lancer %1: %2")
+                 .arg(QFileInfo(m_process->program()).baseName(), m_process->errorString()));
+        }
+    });
+
+    LOG_INFO(QString("VideoExporter: %1 %2").arg(QFileInfo(program).baseName(), args.join(' ')));
+    m_process->start(program, args);
+}
+
+void VideoExporter::onProgressOutput() {
+    // ffprobe output is read once the process has finished
+    if (m_step != Step::Encoding) return;
+
+    // -progress writes key=value lines; out_time_us is the encoded position
+    m_progressBuffer.append(m_process->readAllStandardOutput());
+    int newline;
+    while ((newline = m_progressBuffer.indexOf('\n')) >= 0) {
+        QByteArray line = m_progressBuffer.left(newline).trimmed();
+        m_progressBuffer.remove(0, newline + 1);
+
+        // Older ffmpeg builds only report out_time_ms, also in microseconds
+        if (!line.startsWith("out_time_us=") && !line.startsWith("out_time_ms=")) continue;
+
+        qint64 positionUs = line.mid(line.indexOf('=') + 1).toLongLong();
+        if (positionUs <= 0 || m_totalDurationMs <= 0) continue;
+
+        int encoded = static_cast<int>(qMin<qint64>(100, positionUs / 10 / m_totalDurationMs));
+        emit progressChanged(PROBE_END + encoded * (100 - PROBE_END) / 100,
+                             QString("Encodage video... %1%").arg(encoded));
+    }
+}
+
+void VideoExporter::writeFrames() {
+    if (m_step != Step::Encoding || !m_process) return;
+
+    const qint64 frameBytes = qint64(m_frameSize.width()) * m_frameSize.height() * 3;
+    while (m_nextFrame < m_totalFrames && m_process->bytesToWrite() < QUEUED_FRAMES * frameBytes) {
+        // Advance to the slide covering this frame (slides shorter than a frame are skipped)
+        bool slideChanged = false;
+        while (m_currentSlide < 0 || m_nextFrame >= m_slideEndFrames[m_currentSlide]) {
+            ++m_currentSlide;
+            slideChanged = true;
+        }
+        if (slideChanged) {
+            m_currentFrame = rawFrame(m_currentSlide);
+        }
+
+        m_process->write(m_currentFrame);
+        ++m_nextFrame;
+    }
+
+    // All frames queued: EOF lets ffmpeg finish the encode
+    if (m_nextFrame >= m_totalFrames && m_currentSlide >= 0) {
+        m_process->closeWriteChannel();
+        m_currentFrame.clear();
+        m_currentSlide = -1;
+    }
+}
+
+QByteArray VideoExporter::rawFrame(int slideIndex) const {
+    QImage image = m_slides[slideIndex].frame;
+    if (image.size() != m_frameSize) {
+        // Letterbox slides whose image size differs from the video size
+        QImage canvas(m_frameSize, QImage::Format_RGB888);
+        canvas.fill(Qt::black);
+        QImage scaled = image.scaled(m_frameSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        QPainter painter(&canvas);
+        painter.drawImage((m_frameSize.width() - scaled.width()) / 2,
+                          (m_frameSize.height() - scaled.height()) / 2, scaled);
+        painter.end();
+        image = canvas;
+    } else {
+        image = image.convertToFormat(QImage::Format_RGB888);
+    }
+
+    // Scan lines are 4-byte aligned in QImage, rawvideo expects them packed
+    const int rowBytes = m_frameSize.width() * 3;
+    QByteArray data;
+    data.resize(qsizetype(rowBytes) * m_frameSize.height());
+    for (int y = 0; y < m_frameSize.height(); ++y) {
+        memcpy(data.data() + qsizetype(y) * rowBytes, image.constScanLine(y), rowBytes);
+    }
+    return data;
+}
+
+void VideoExporter::onProcessFinished(int exitCode, QProcess::ExitStatus status) {
+    const Step step = m_step;
+    const QString errorOutput = QString::fromUtf8(m_process->readAllStandardError());
+    const QByteArray output = (step == Step::ProbingAudio) ? m_process->readAllStandardOutput() : QByteArray();
+    m_process->deleteLater();
+    m_process = nullptr;
+
+    if (step == Step::ProbingAudio) {
+        bool ok = false;
+        double seconds = output.trimmed().toDouble(&ok);
+        VideoExportSlide& slide = m_slides[m_probeIndex];
+        if (exitCode == 0 && status == QProcess::NormalExit && ok && seconds > 0) {
+            LOG_DEBUG(QString("VideoExporter: slide %1 narration %2 ms (estimated %3 ms)")
+                      .arg(m_probeIndex).arg(qRound(seconds * 1000)).arg(slide.durationMs));
+            slide.durationMs = qRound(seconds * 1000);
+        } else {
+            // Keep the estimate rather than failing the whole video
+            LOG_WARN(QString("VideoExporter: could not probe %1: %2")
+                     .arg(slide.audioPath, errorOutput.right(200)));
+        }
+        probeNextAudio();
+        return;
+    }
+
+    if (step != Step::Encoding) return;
+
+    if (exitCode == 0 && status == QProcess::NormalExit && QFile::exists(m_outputPath)) {
+        const QString outputPath = m_outputPath;
+        const int slideCount = m_slides.size();
+        const double durationSec = m_totalDurationMs / 1000.0;
+
+        m_step = Step::Idle;
+        cleanup();
+
+        LOG_INFO(QString("Video exported: %1 (%2 slides, %3 sec)")
+                 .arg(outputPath).arg(slideCount).arg(durationSec));
+        emit progressChanged(100, "Termine");
+        emit finished(outputPath, slideCount, durationSec);
+    } else {
+        LOG_ERROR(QString("FFmpeg failed: %1").arg(errorOutput));
+        fail(QString("L'export video a echoue.\n\nErreur: %1").arg(errorOutput.right(500)));
+    }
+}
+
+void VideoExporter::fail(const QString& error) {
+    if (!isRunning()) return;
+
+    m_step = Step::Idle;
+    cleanup();
+    emit failed(error);
+}
+
+void VideoExporter::cleanup() {
+    if (m_process) {
+        m_process->disconnect(this);
+        if (m_process->state() != QProcess::NotRunning) {
+            m_process->kill();
+            m_process->waitForFinished(1000);
+        }
+        m_process->deleteLater();
+        m_process = nullptr;
+    }
+
+    m_slides.clear();
+    m_slideEndFrames.clear();
+    m_currentFrame.clear();
+    m_progressBuffer.clear();
+}
+
+} // namespace codex::core
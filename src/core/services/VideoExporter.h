@@ -0,0 +1,87 @@
+#pragma once
+
+#include <QObject>
+#include <QImage>
+#include <QList>
+#include <QProcess>
+#include <QString>
+#include <QStringList>
+
+namespace codex::core {
+
+// One slide of an exported video: the rendered frame and its narration
+struct VideoExportSlide {
+    QImage frame;
+    QString audioPath;          // empty when the slide has no narration
+    int durationMs = 5000;      // estimate, replaced by the probed clip duration
+};
+
+// Encodes a slideshow to MP4 with FFmpeg without blocking the GUI thread.
+// Narration clips are first measured with ffprobe, then a single ffmpeg run
+// muxes frames streamed on stdin as raw RGB with the concatenated narration,
+// so every slide boundary lands within a frame of the end of its clip.
+// All processes are asynchronous QProcess jobs; encode progress is parsed
+// from ffmpeg's -progress output.
+class VideoExporter : public QObject {
+    Q_OBJECT
+
+public:
+    explicit VideoExporter(QObject* parent = nullptr);
+    ~VideoExporter();
+
+    // FFmpeg executable, looked up once per application run (empty if missing)
+    static QString ffmpegPath();
+    static QString ffprobePath();
+
+    // Output frame rate; slide boundaries are rounded to the nearest frame
+    static constexpr int FRAME_RATE = 25;
+
+    // Start exporting; returns false if an export is already running
+    bool start(const QList<VideoExportSlide>& slides, const QString& outputPath);
+    void cancel();
+    bool isRunning() const { return m_step != Step::Idle; }
+
+signals:
+    void progressChanged(int percent, const QString& step);
+    void finished(const QString& outputPath, int slideCount, double durationSec);
+    void failed(const QString& error);
+    void cancelled();
+
+private:
+    enum class Step {
+        Idle,
+        ProbingAudio,
+        Encoding
+    };
+
+    void probeNextAudio();
+    void layoutFrames();
+    void encodeVideo();
+    void runProcess(Step step, const QString& program, const QStringList& args);
+    void onProcessFinished(int exitCode, QProcess::ExitStatus status);
+    void onProgressOutput();
+    void writeFrames();
+    QByteArray rawFrame(int slideIndex) const;
+    void fail(const QString& error);
+    void cleanup();
+
+    Step m_step = Step::Idle;
+    QList<VideoExportSlide> m_slides;
+    QString m_outputPath;
+    qint64 m_totalDurationMs = 0;
+    int m_probeIndex = -1;
+    QString m_workingDir;       // encoder working directory when all clips share it
+
+    // Frame streaming state
+    QSize m_frameSize;
+    QList<qint64> m_slideEndFrames;     // exclusive end frame of each slide
+    qint64 m_totalFrames = 0;
+    qint64 m_nextFrame = 0;
+    int m_currentSlide = -1;
+    QByteArray m_currentFrame;          // raw RGB of the slide being streamed
+
+    QProcess* m_process = nullptr;
+    QByteArray m_progressBuffer;
+};
+
+} // namespace codex::core
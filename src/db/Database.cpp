@@ -101,6 +101,23 @@ bool Database::createTables() {
         return false;
     }
 
+    // Enrichment cache table (LLM scene descriptions keyed by input hash)
+    if (!query.exec(R"(
+        CREATE TABLE IF NOT EXISTS enrichment_cache (
+            cache_key TEXT PRIMARY KEY,
+            provider TEXT NOT NULL,
+            model TEXT,
+            scene TEXT NOT NULL,
+            emotion TEXT,
+            visual_elements TEXT,
+            hit_count INTEGER NOT NULL DEFAULT 0,
+            created_at DATETIME DEFAULT CURRENT_TIMESTAMP
+        )
+    )")) {
+        LOG_ERROR(QString("Failed to create enrichment_cache table: %1").arg(query.lastError().text()));
+        return false;
+    }
+
     // Audio files table
     if (!query.exec(R"(
         CREATE TABLE IF NOT EXISTS audio_files (
@@ -0,0 +1,90 @@
+#include "EnrichmentCacheRepository.h"
+#include "../Database.h"
+#include "utils/Logger.h"
+
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QCryptographicHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+namespace codex::db {
+
+EnrichmentCacheRepository::EnrichmentCacheRepository() {
+}
+
+QString EnrichmentCacheRepository::makeKey(const QString& provider, const QString& model, const QString& prompt) {
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(provider.toUtf8());
+    hash.addData(QByteArray(1, '\0'));
+    hash.addData(model.toUtf8());
+    hash.addData(QByteArray(1, '\0'));
+    hash.addData(prompt.toUtf8());
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+std::optional<CachedEnrichment> EnrichmentCacheRepository::findByKey(const QString& cacheKey) {
+    if (!Database::instance().isInitialized()) {
+        return std::nullopt;
+    }
+
+    QSqlQuery query(Database::instance().connection());
+    query.prepare("SELECT * FROM enrichment_cache WHERE cache_key = :cache_key");
+    query.bindValue(":cache_key", cacheKey);
+
+    if (!query.exec() || !query.next()) {
+        return std::nullopt;
+    }
+
+    CachedEnrichment enrichment;
+    enrichment.cacheKey = query.value("cache_key").toString();
+    enrichment.provider = query.value("provider").toString();
+    enrichment.model = query.value("model").toString();
+    enrichment.scene = query.value("scene").toString();
+    enrichment.emotion = query.value("emotion").toString();
+    enrichment.hitCount = query.value("hit_count").toInt();
+    enrichment.createdAt = query.value("created_at").toDateTime();
+
+    QJsonArray elements = QJsonDocument::fromJson(query.value("visual_elements").toByteArray()).array();
+    for (const auto& elem : elements) {
+        enrichment.visualElements.append(elem.toString());
+    }
+
+    // Track usage (informative only)
+    QSqlQuery hitQuery(Database::instance().connection());
+    hitQuery.prepare("UPDATE enrichment_cache SET hit_count = hit_count + 1 WHERE cache_key = :cache_key");
+    hitQuery.bindValue(":cache_key", cacheKey);
+    hitQuery.exec();
+
+    return enrichment;
+}
+
+bool EnrichmentCacheRepository::store(const CachedEnrichment& enrichment) {
+    if (!Database::instance().isInitialized()) {
+        return false;
+    }
+
+    QSqlQuery query(Database::instance().connection());
+    query.prepare(R"(
+        INSERT OR REPLACE INTO enrichment_cache
+            (cache_key, provider, model, scene, emotion, visual_elements)
+        VALUES (:cache_key, :provider, :model, :scene, :emotion, :visual_elements)
+    )");
+    query.bindValue(":cache_key", enrichment.cacheKey);
+    query.bindValue(":provider", enrichment.provider);
+    query.bindValue(":model", enrichment.model);
+    query.bindValue(":scene", enrichment.scene);
+    query.bindValue(":emotion", enrichment.emotion);
+    query.bindValue(":visual_elements",
+        QString::fromUtf8(QJsonDocument(QJsonArray::fromStringList(enrichment.visualElements))
+                              .toJson(QJsonDocument::Compact)));
+
+    if (!query.exec()) {
+        LOG_ERROR(QString("Failed to store enrichment: %1").arg(query.lastError().text()));
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace codex::db
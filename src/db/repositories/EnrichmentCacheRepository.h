@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QDateTime>
+#include <optional>
+
+namespace codex::db {
+
+// LLM scene enrichment, stored under a hash of everything that produced it
+// (provider, model and the full prompt: passage, entities, category, template)
+struct CachedEnrichment {
+    QString cacheKey;
+    QString provider;
+    QString model;
+    QString scene;
+    QString emotion;
+    QStringList visualElements;
+    int hitCount = 0;
+    QDateTime createdAt;
+};
+
+class EnrichmentCacheRepository {
+public:
+    EnrichmentCacheRepository();
+
+    // Build the cache key for an enrichment request
+    static QString makeKey(const QString& provider, const QString& model, const QString& prompt);
+
+    std::optional<CachedEnrichment> findByKey(const QString& cacheKey);
+    bool store(const CachedEnrichment& enrichment);
+};
+
+} // namespace codex::db
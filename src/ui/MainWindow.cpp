@@ -17,8 +17,11 @@
 #include "api/ElevenLabsClient.h"
 #include "api/EdgeTTSClient.h"
 #include "api/VeoClient.h"
+#include "api/ImagenClient.h"
+#include "api/RequestQueue.h"
 #include "core/services/TextParser.h"
 #include "core/services/NarrationCleaner.h"
+#include "core/services/SentenceSegmenter.h"
 #include "core/controllers/PipelineController.h"
 #include "utils/Logger.h"
 #include "utils/Config.h"
@@ -49,6 +52,8 @@
 #include <QUrl>
 #include <QCloseEvent>
 #include <QMouseEvent>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentRun>
 
 namespace codex::ui {
 
@@ -139,7 +144,8 @@ MainWindow::MainWindow(QWidget* parent)
                         m_currentTreatiseCode = lastTreatise;
                         m_selectionStart = selStart;
                         m_selectionEnd = selEnd;
-                        m_passagePreview->setPassage(lastText, selStart, selEnd);
+                        m_selectionSource = m_textViewer->sourceRange(selStart, selEnd);
+                        m_passagePreview->setPassage(lastText, selStart, selEnd, narrationText(lastText));
                         LOG_INFO(QString("Restored selection [%1-%2] in treatise: %3")
                                  .arg(selStart).arg(selEnd).arg(lastTreatise));
                     }
@@ -184,6 +190,9 @@ void MainWindow::closeEvent(QCloseEvent* event) {
     settings.setValue("windowState", saveState());
     LOG_INFO("Saved window geometry and dock state");
 
+    // Abort every generation job still in flight
+    m_pipelineController->cancelAll();
+
     QMainWindow::closeEvent(event);
 }
 
@@ -500,7 +509,18 @@ void MainWindow::setupUi() {
     settingsToolbar->addWidget(openVideosBtn);
 
 
-    // Status bar
+    // Status bar, with the generation requests of every window
+    auto& queue = codex::api::RequestQueue::instance();
+    auto showQueueCounts = [this](int queued, int running, int done) {
+        m_queueLabel->setText(QString("File: %1 | En cours: %2 | Terminees: %3")
+                              .arg(queued).arg(running).arg(done));
+    };
+    m_queueLabel = new QLabel(this);
+    m_queueLabel->setToolTip("Requetes de generation : en attente, en cours, terminees");
+    statusBar()->addPermanentWidget(m_queueLabel);
+    showQueueCounts(queue.queuedCount(), queue.runningCount(), queue.doneCount());
+    connect(&queue, &codex::api::RequestQueue::countsChanged, this, showQueueCounts);
+
     statusBar()->showMessage("Pret");
 }
 
@@ -681,6 +701,11 @@ void MainWindow::setupConnections() {
     connect(m_treatiseList, &TreatiseListWidget::treatiseDoubleClicked,
             this, &MainWindow::onTreatiseDoubleClicked);
 
+    // Corpus indexes: treatise filter, search results and entity passages
+    m_treatiseList->setTextParser(m_textParser);
+    connect(m_infoDock, &InfoDockWidget::passageRequested,
+            this, &MainWindow::onIndexPassageRequested);
+
     // Generation is now handled via the Generation menu
 
     // Veo (video generation) signals
@@ -690,6 +715,10 @@ void MainWindow::setupConnections() {
             this, &MainWindow::onVideoProgress);
     connect(m_veoClient, &codex::api::VeoClient::errorOccurred,
             this, &MainWindow::onVideoError);
+    connect(m_veoClient, &codex::api::VeoClient::retryScheduled, this, [this](int attempt, int delayMs) {
+        statusBar()->showMessage(QString("Quota Veo atteint, nouvel essai %1 dans %2 s...")
+                                 .arg(attempt).arg((delayMs + 999) / 1000));
+    });
 
     // Pipeline controller signals
     connect(m_pipelineController, &codex::core::PipelineController::stateChanged,
@@ -700,6 +729,10 @@ void MainWindow::setupConnections() {
             this, &MainWindow::onPipelineCompleted);
     connect(m_pipelineController, &codex::core::PipelineController::generationFailed,
             this, &MainWindow::onPipelineFailed);
+    connect(m_pipelineController, &codex::core::PipelineController::batchEnrichmentCompleted,
+            this, &MainWindow::onBatchEnrichmentCompleted);
+    connect(m_pipelineController, &codex::core::PipelineController::batchEnrichmentCancelled,
+            this, &MainWindow::onBatchEnrichmentCancelled);
 
     // Image viewer save signal
     connect(m_imageViewer, &ImageViewerWidget::imageSaveRequested,
@@ -755,9 +788,12 @@ void MainWindow::loadCodexAndRefreshUI(const QString& filePath) {
     // Update treatise list
     QVector<codex::core::TreatiseInfo> treatises = m_textParser->parseTableOfContents();
     m_treatiseList->loadTreatises(treatises);
+    m_infoDock->setTextParser(m_textParser);
 
     // Clear text viewer
     m_textViewer->setText("Selectionnez un traite dans la liste a gauche.");
+    m_currentTreatiseHeader.clear();
+    prepareNarrationCache();
 
     statusBar()->showMessage(QString("Codex charge: %1 traites, %2 pages")
                              .arg(treatises.size())
@@ -769,6 +805,43 @@ void MainWindow::loadCodexAndRefreshUI(const QString& filePath) {
     LOG_INFO(QString("Loaded Codex: %1").arg(filePath));
 }
 
+void MainWindow::prepareNarrationCache() {
+    const codex::core::NarrationCleaner cleaner = TextViewerWidget::cleaner();
+    if (m_textParser->hasNarrationCache(cleaner)) return;
+
+    // Load or build on a worker thread; treatises show their raw text until it is ready
+    const QByteArray contentKey = m_textParser->contentKey();
+    auto* watcher = new QFutureWatcher<codex::core::NarrationCache>(this);
+    connect(watcher, &QFutureWatcher<codex::core::NarrationCache>::finished, this,
+            [this, watcher, cleaner, contentKey]() {
+        const codex::core::NarrationCache cache = watcher->result();
+        watcher->deleteLater();
+        m_textParser->setNarrationCache(cleaner, contentKey, cache);
+        if (m_textParser->hasNarrationCache(cleaner)) onNarrationCacheReady();
+    });
+    watcher->setFuture(QtConcurrent::run(m_textParser->narrationCacheTask(cleaner)));
+}
+
+void MainWindow::onNarrationCacheReady() {
+    // Show the current treatise again with source offsets, unless the user is selecting in it
+    if (!m_currentTreatiseCode.isEmpty() && !m_textViewer->hasSourceOffsets()
+        && m_textViewer->selectedText().isEmpty()) {
+        const codex::core::ParsedTreatise treatise = m_textParser->extractTreatise(m_currentTreatiseCode);
+        if (!treatise.isEmpty()) showTreatiseText(treatise);
+    }
+    statusBar()->showMessage("Texte de narration pret", 3000);
+}
+
+void MainWindow::showTreatiseText(const codex::core::ParsedTreatise& treatise) {
+    const codex::core::NarrationText text = m_textParser->narrationText(treatise.code, TextViewerWidget::cleaner());
+    if (text.text.isEmpty()) {
+        // Narration cache not ready yet: clean the raw text, without source offsets
+        m_textViewer->setTextWithVerses(m_currentTreatiseHeader + treatise.fullText(), treatise.startPage);
+    } else {
+        m_textViewer->setCleanTextWithVerses(m_currentTreatiseHeader, text, treatise.startPage);
+    }
+}
+
 void MainWindow::onSaveProject() {
     if (m_currentProject.id <= 0) {
         // No project loaded, create new one
@@ -810,10 +883,24 @@ void MainWindow::onPassageSelected(const QString& text, int start, int end) {
     m_selectedPassage = text;
     m_selectionStart = start;
     m_selectionEnd = end;
-    m_passagePreview->setPassage(text, start, end);
+    m_selectionSource = m_textViewer->sourceRange(start, end);     // {-1, -1} for passages from the index
+    m_passagePreview->setPassage(text, start, end, narrationText(text));
     statusBar()->showMessage(QString("Passage selectionne: %1 caracteres").arg(text.length()));
 }
 
+QString MainWindow::narrationText(const QString& passage) {
+    // Viewer selection: slice of the cache the viewer shows, pipes removed. Repeated
+    // titles are dropped per treatise, so a title shown earlier is not read again
+    if (passage == m_selectedPassage && m_selectionSource.first >= 0 && !m_currentTreatiseCode.isEmpty()) {
+        const QString text = m_textParser->narrationPassage(m_currentTreatiseCode, m_selectionSource.first,
+                                                            m_selectionSource.second, TextViewerWidget::cleaner());
+        if (!text.isEmpty()) return codex::core::NarrationCleaner::removePipes(text);
+    }
+
+    codex::core::NarrationCleaner cleaner;
+    return cleaner.clean(passage);
+}
+
 void MainWindow::onGenerateImage() {
     if (m_selectedPassage.isEmpty()) {
         codex::utils::MessageBox::warning(this, "Erreur", "Veuillez d'abord selectionner un passage de texte.");
@@ -842,29 +929,44 @@ void MainWindow::onTreatiseSelected(const QString& code, const QString& title, c
     // Extract and display treatise content
     codex::core::ParsedTreatise treatise = m_textParser->extractTreatise(code);
 
-    if (treatise.fullText.isEmpty()) {
+    if (treatise.isEmpty()) {
         statusBar()->showMessage(QString("Erreur: impossible d'extraire %1").arg(code));
         return;
     }
 
     // Display in text viewer with verse numbering (Page:Paragraph)
-    QString header = QString("══════════════════════════════════════\n"
-                             "  %1 - %2\n"
-                             "  Categorie: %3\n"
-                             "  Pages manuscrit: %4+\n"
-                             "══════════════════════════════════════\n\n")
-                     .arg(code, title, category)
-                     .arg(treatise.startPage);
-    m_textViewer->setTextWithVerses(header + treatise.fullText, treatise.startPage);
+    m_currentTreatiseHeader = QString("══════════════════════════════════════\n"
+                                      "  %1 - %2\n"
+                                      "  Categorie: %3\n"
+                                      "  Pages manuscrit: %4+\n"
+                                      "══════════════════════════════════════\n\n")
+                              .arg(code, title, category)
+                              .arg(treatise.startPage);
+    showTreatiseText(treatise);
 
     statusBar()->showMessage(QString("Traite: %1 - %2 | Categorie: %3 | Page %4 | %5 caracteres")
                              .arg(code, title, category)
                              .arg(treatise.startPage)
-                             .arg(treatise.fullText.length()));
+                             .arg(treatise.textLength));
 
     LOG_INFO(QString("Displayed treatise: %1, category: %2").arg(code, category));
 }
 
+void MainWindow::onIndexPassageRequested(const QString& code, const QString& passage,
+                                         qsizetype start, qsizetype end) {
+    // Selecting the treatise loads its text into the viewer
+    m_treatiseList->selectTreatiseByCode(code);
+
+    // Exact occurrence first; the words of the passage only when the view
+    // has no source offsets
+    if (m_textViewer->selectSourceRange(start, end)) return;
+
+    if (!m_textViewer->selectPassage(passage)) {
+        // Not found in the formatted view: use the source text as is
+        onPassageSelected(passage, -1, -1);
+    }
+}
+
 void MainWindow::onTreatiseDoubleClicked(const QString& code, const QString& title, const QString& category) {
     // Double-click does the same as single click (for compatibility)
     onTreatiseSelected(code, title, category);
@@ -873,18 +975,26 @@ void MainWindow::onTreatiseDoubleClicked(const QString& code, const QString& tit
 void MainWindow::onGenerateImageFromPreview(const QString& passage) {
     m_selectedPassage = passage;
 
-    // Check if pipeline is already running
-    if (m_pipelineController->isRunning()) {
+    // Only one single image at a time (plates run as their own jobs)
+    if (m_pipelineController->isRunning(m_singleImageJobId)) {
         codex::utils::MessageBox::warning(this, "Generation en cours",
             "Une generation est deja en cours. Veuillez patienter.");
         return;
     }
 
     statusBar()->showMessage(QString("Generation... Categorie: %1").arg(m_currentCategory));
-    m_imageViewer->showLoading();
+    if (!m_plateGenerating) {
+        m_imageViewer->showLoading();
+    }
+
+    // Generating the same passage again means another image is wanted
+    const bool freshSample = passage == m_lastImagePassage;
+    m_lastImagePassage = passage;
 
     // Start the generation pipeline with category
-    m_pipelineController->startGeneration(passage, m_currentTreatiseCode, m_currentCategory);
+    m_singleImageJobId = m_pipelineController->startGeneration(
+        passage, m_currentTreatiseCode, m_currentCategory, codex::core::SceneEnrichment(), 1,
+        codex::api::RequestTicket(), freshSample);
 
     LOG_INFO(QString("Image generation started for passage: %1 chars, category: %2")
              .arg(passage.length()).arg(m_currentCategory));
@@ -897,8 +1007,7 @@ void MainWindow::onGenerateAudioFromPreview(const QString& passage) {
     }
 
     // Nettoyer le texte pour la narration
-    codex::core::NarrationCleaner cleaner;
-    QString cleanedPassage = cleaner.clean(passage);
+    QString cleanedPassage = narrationText(passage);
 
     LOG_INFO(QString("Narration text cleaned: %1 -> %2 chars")
              .arg(passage.length()).arg(cleanedPassage.length()));
@@ -906,6 +1015,10 @@ void MainWindow::onGenerateAudioFromPreview(const QString& passage) {
     auto& config = codex::utils::Config::instance();
     QString ttsProvider = config.ttsProvider();
 
+    // Narrating the same passage again means another take is wanted
+    const bool freshSample = passage == m_lastAudioPassage;
+    m_lastAudioPassage = passage;
+
     statusBar()->showMessage("Generation audio en cours...");
 
     if (ttsProvider == "edge") {
@@ -916,7 +1029,7 @@ void MainWindow::onGenerateAudioFromPreview(const QString& passage) {
         edgeSettings.pitch = 0;      // Normal pitch
         edgeSettings.volume = 100;   // Full volume
 
-        m_edgeTTSClient->generateSpeech(cleanedPassage, edgeSettings);
+        m_edgeTTSClient->generateSpeech(cleanedPassage, edgeSettings, freshSample);
 
         LOG_INFO(QString("Edge TTS generation started for passage: %1 chars, voice: %2")
                  .arg(cleanedPassage.length()).arg(edgeSettings.voiceId));
@@ -941,6 +1054,7 @@ void MainWindow::onGenerateAudioFromPreview(const QString& passage) {
         voiceSettings.similarityBoost = 0.75;
         voiceSettings.speed = 0.85;
 
+        m_elevenLabsClient->setCacheBypass(freshSample);
         m_elevenLabsClient->generateSpeech(cleanedPassage, voiceSettings);
 
         LOG_INFO(QString("ElevenLabs generation started for passage: %1 chars, voice: %2")
@@ -1110,33 +1224,31 @@ void MainWindow::onVideoError(const QString& error) {
     LOG_ERROR(QString("Video generation failed: %1").arg(error));
 }
 
-void MainWindow::onPipelineStateChanged(codex::core::PipelineState state, const QString& message) {
+void MainWindow::onPipelineStateChanged(int jobId, codex::core::PipelineState state, const QString& message) {
     Q_UNUSED(state)
+    // Plate jobs report through the plate progress instead
+    if (m_plateJobIndex.contains(jobId)) return;
     statusBar()->showMessage(message);
 }
 
-void MainWindow::onPipelineProgress(int percent, const QString& step) {
+void MainWindow::onPipelineProgress(int jobId, int percent, const QString& step) {
     // Update progress bar for plate generation mode
-    if (m_plateGenerating && m_plateTextSegments.size() > 0) {
-        // Calculate fine progress: current image + progress within that image
+    if (m_plateJobIndex.contains(jobId) && m_plateTextSegments.size() > 0) {
+        // Several images are in flight, so progress is counted in finished images
         int totalImages = m_plateTextSegments.size();
-        int completedImages = m_plateNextIndex;
+        int totalPercent = (m_plateCompletedCount * 100) / totalImages;
 
-        // Each image contributes (100 / totalImages) to total progress
-        // Current image progress adds partial contribution
-        int basePercent = (completedImages * 100) / totalImages;
-        int totalPercent = basePercent + (percent / totalImages);
+        m_progressBar->setValue(m_plateCompletedCount);
 
-        m_progressBar->setValue(totalPercent * totalImages / 100);  // Scale to range
-
-        // Update button text with fine progress
+        // Update button text with progress
         m_genAllBtn->setText(QString("Pause (%1%)").arg(totalPercent));
 
-        statusBar()->showMessage(QString("Image %1/%2: %3 (%4%)")
-            .arg(completedImages + 1).arg(totalImages).arg(step).arg(percent));
+        statusBar()->showMessage(QString("Planche: %1/%2 images, %3 en cours: %4 (%5%)")
+            .arg(m_plateCompletedCount).arg(totalImages)
+            .arg(m_plateJobIndex.size()).arg(step).arg(percent));
     }
     // Update progress bar if in full generation mode
-    else if (m_fullGenerating) {
+    else if (m_fullGenerating && jobId == m_singleImageJobId) {
         // Steps: 0-33% = prompt, 33-66% = image, 66-100% = audio
         if (step.contains("prompt", Qt::CaseInsensitive)) {
             m_progressBar->setValue(percent / 3);
@@ -1152,7 +1264,8 @@ void MainWindow::onPipelineProgress(int percent, const QString& step) {
     }
 }
 
-void MainWindow::onPipelineCompleted(const QPixmap& image, const QString& prompt) {
+void MainWindow::onPipelineCompleted(int jobId, const QPixmap& image, const QString& prompt,
+                                     const QList<QPixmap>& variants) {
     // Store the prompt and display it in the prompt tab
     if (!prompt.isEmpty()) {
         m_generatedPrompt = prompt;
@@ -1160,19 +1273,14 @@ void MainWindow::onPipelineCompleted(const QPixmap& image, const QString& prompt
         m_centerTabWidget->setCurrentIndex(1);  // Switch to Prompt tab
     }
 
-    if (m_plateGenerating && m_plateNextIndex < m_plateTextSegments.size()) {
-        // We're in plate generation mode - add image to grid
-        QString segmentText = m_plateTextSegments[m_plateNextIndex];
-        m_imageViewer->setPlateGridImage(m_plateNextIndex, image, segmentText);
-
-        LOG_INFO(QString("Plate image %1 completed, size: %2x%3")
-                 .arg(m_plateNextIndex + 1).arg(image.width()).arg(image.height()));
-
-        // Auto-save image to MediaStorage
-        codex::utils::MediaStorage::instance().saveImage(image, m_plateNextIndex, segmentText);
+    if (m_plateJobIndex.contains(jobId)) {
+        // We're in plate generation mode - add images to grid at their own index,
+        // completions may arrive in any order
+        const QList<int> indexes = m_plateJobIndex.take(jobId);
+        bool firstImage = (m_plateCompletedCount == 0);
 
         // Open slideshow on first image if requested
-        if (m_plateNextIndex == 0 && m_openSlideshowOnFirstImage && !m_activeSlideshowDialog) {
+        if (firstImage && m_openSlideshowOnFirstImage && !m_activeSlideshowDialog) {
             m_openSlideshowOnFirstImage = false;  // Only open once
 
             SlideshowDialog* dialog = new SlideshowDialog(this);
@@ -1181,8 +1289,12 @@ void MainWindow::onPipelineCompleted(const QPixmap& image, const QString& prompt
 
             connect(dialog, &QObject::destroyed, this, [this]() {
                 m_activeSlideshowDialog = nullptr;
+                codex::api::RequestQueue::instance().setFocus(m_plateSession, -1);
                 LOG_INFO("Slideshow closed");
             });
+            connect(dialog, &SlideshowDialog::slideShown, this, [this](int index) {
+                codex::api::RequestQueue::instance().setFocus(m_plateSession, index);
+            });
 
             dialog->setContent(m_selectedPassage, m_currentTreatiseCode, m_currentCategory, m_plateCols, m_plateRows);
             dialog->prepareSlideshow();
@@ -1197,30 +1309,51 @@ void MainWindow::onPipelineCompleted(const QPixmap& image, const QString& prompt
             LOG_INFO("Slideshow opened on first image");
         }
 
-        // Send image to active slideshow dialog if one exists
-        if (m_activeSlideshowDialog) {
-            m_activeSlideshowDialog->addImage(image, segmentText, m_plateNextIndex);
-            LOG_INFO(QString("Sent image %1 to slideshow").arg(m_plateNextIndex));
+        // One sample per panel; panels sharing a scene reuse the first image
+        // if Imagen returned fewer samples than requested
+        for (int i = 0; i < indexes.size(); ++i) {
+            int index = indexes[i];
+            QPixmap panelImage = variants.value(i, image);
+            QString segmentText = m_plateTextSegments.value(index);
+            m_imageViewer->setPlateGridImage(index, panelImage, segmentText);
+
+            LOG_INFO(QString("Plate image %1 completed, size: %2x%3")
+                     .arg(index + 1).arg(panelImage.width()).arg(panelImage.height()));
+
+            // Auto-save image to MediaStorage
+            codex::utils::MediaStorage::instance().saveImage(panelImage, index, segmentText);
+
+            // Send image to active slideshow dialog if one exists
+            if (m_activeSlideshowDialog) {
+                m_activeSlideshowDialog->addImage(panelImage, segmentText, index);
+                LOG_INFO(QString("Sent image %1 to slideshow").arg(index));
+            }
         }
 
-        // Move to next image
-        m_plateNextIndex++;
+        m_plateCompletedCount += indexes.size();
 
         // Update progress bar and button text
-        m_progressBar->setValue(m_plateNextIndex);
-        int percent = (m_plateNextIndex * 100) / m_plateTextSegments.size();
+        m_progressBar->setValue(m_plateCompletedCount);
+        int percent = (m_plateCompletedCount * 100) / m_plateTextSegments.size();
         m_genAllBtn->setText(QString("Pause (%1%)").arg(percent));
 
-        // Generate next image after a small delay to avoid overwhelming the API
-        QTimer::singleShot(500, this, &MainWindow::generateNextPlateImage);
+        // Refill the in-flight window
+        generateNextPlateImage();
+    } else if (jobId != m_singleImageJobId) {
+        LOG_WARN(QString("Ignoring result of unknown pipeline job %1").arg(jobId));
     } else if (m_fullGenerating) {
         // Full generation mode - image done, now generate audio
-        m_imageViewer->setImage(image);
+        m_singleImageJobId = 0;
         m_fullGenStep = 2;
 
         m_progressBar->setValue(66);
         m_progressBar->setFormat("Etape 3/3: Generation de l'audio...");
         statusBar()->showMessage("Generation complete: creation de l'audio...");
+        if (m_plateGenerating) {
+            saveImageBesidePlate(image);
+        } else {
+            m_imageViewer->setImage(image);
+        }
 
         LOG_INFO(QString("Full generation: image completed, starting audio. Size: %1x%2")
                  .arg(image.width()).arg(image.height()));
@@ -1229,42 +1362,72 @@ void MainWindow::onPipelineCompleted(const QPixmap& image, const QString& prompt
         onGenerateAudioFromPreview(m_selectedPassage);
     } else {
         // Normal single image generation
-        m_imageViewer->setImage(image);
-        statusBar()->showMessage("Image generee avec succes!");
+        m_singleImageJobId = 0;
+        if (m_plateGenerating) {
+            saveImageBesidePlate(image);
+        } else {
+            m_imageViewer->setImage(image);
+            statusBar()->showMessage("Image generee avec succes!");
+        }
 
         LOG_INFO(QString("Pipeline completed, image size: %1x%2")
                  .arg(image.width()).arg(image.height()));
     }
 }
 
-void MainWindow::onPipelineFailed(const QString& error) {
+void MainWindow::onPipelineFailed(int jobId, const QString& error) {
     LOG_ERROR(QString("Pipeline failed: %1").arg(error));
 
-    if (m_plateGenerating && m_plateNextIndex < m_plateTextSegments.size()) {
+    if (m_plateJobIndex.contains(jobId)) {
         // In plate mode - skip this image and continue
+        const QList<int> indexes = m_plateJobIndex.take(jobId);
         statusBar()->showMessage(QString("Image %1 echouee, passage a la suivante...")
-                                 .arg(m_plateNextIndex + 1));
+                                 .arg(indexes.first() + 1));
 
         // Notify slideshow of failure (it will handle placeholder)
         // Note: slideshow will just not receive this image
 
-        m_plateNextIndex++;
-        QTimer::singleShot(500, this, &MainWindow::generateNextPlateImage);
+        m_plateCompletedCount += indexes.size();
+        generateNextPlateImage();
+    } else if (jobId != m_singleImageJobId) {
+        // Job that nobody tracks anymore - nothing to update
     } else if (m_fullGenerating) {
         // Full generation mode - cancel
+        m_singleImageJobId = 0;
         m_fullGenerating = false;
         m_progressBar->hide();
-        m_imageViewer->showPlaceholder();
+        if (!m_plateGenerating) {
+            m_imageViewer->showPlaceholder();
+        }
         statusBar()->showMessage(QString("Erreur: %1").arg(error));
         codex::utils::MessageBox::critical(this, "Erreur de generation", error);
     } else {
         // Normal mode - show error
-        m_imageViewer->showPlaceholder();
+        m_singleImageJobId = 0;
+        if (!m_plateGenerating) {
+            m_imageViewer->showPlaceholder();
+        }
         statusBar()->showMessage(QString("Erreur: %1").arg(error));
         codex::utils::MessageBox::critical(this, "Erreur de generation", error);
     }
 }
 
+void MainWindow::saveImageBesidePlate(const QPixmap& image) {
+    // The viewer shows the plate grid: the single image goes to the output folder
+    QString outputPath = codex::utils::Config::instance().outputImagesPath();
+    QDir().mkpath(outputPath);
+    QString filePath = outputPath + "/" + QString("codex_image_%1.png")
+        .arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
+
+    if (image.save(filePath)) {
+        statusBar()->showMessage(QString("Image generee (planche en cours), sauvegardee: %1").arg(filePath));
+        LOG_INFO(QString("Single image saved beside the running plate: %1").arg(filePath));
+    } else {
+        statusBar()->showMessage("Image generee mais non sauvegardee (planche en cours)");
+        LOG_ERROR(QString("Failed to save single image to: %1").arg(filePath));
+    }
+}
+
 void MainWindow::onSaveImage() {
     if (!m_imageViewer->hasImage()) {
         codex::utils::MessageBox::warning(this, "Erreur", "Aucune image a sauvegarder.");
@@ -1318,8 +1481,12 @@ void MainWindow::onStartSlideshow() {
     // When dialog is destroyed, clear the pointer
     connect(dialog, &QObject::destroyed, this, [this]() {
         m_activeSlideshowDialog = nullptr;
+        codex::api::RequestQueue::instance().setFocus(m_plateSession, -1);
         LOG_INFO("Slideshow closed");
     });
+    connect(dialog, &SlideshowDialog::slideShown, this, [this](int index) {
+        codex::api::RequestQueue::instance().setFocus(m_plateSession, index);
+    });
 
     // Use grid dimensions from ImageViewer if available, otherwise default to 2x2
     int cols = m_imageViewer->gridCols() > 0 ? m_imageViewer->gridCols() : (m_plateCols > 0 ? m_plateCols : 2);
@@ -1374,7 +1541,7 @@ void MainWindow::onGenerateAllAndSlideshow() {
     // If generation is in progress, handle pause/resume
     if (m_plateGenerating) {
         int percent = m_plateTextSegments.size() > 0
-            ? (m_plateNextIndex * 100) / m_plateTextSegments.size()
+            ? (m_plateCompletedCount * 100) / m_plateTextSegments.size()
             : 0;
 
         if (m_platePaused) {
@@ -1414,9 +1581,9 @@ void MainWindow::onGenerateAllAndSlideshow() {
                 QPushButton:pressed { background-color: #0d3a0d; }
             )");
             statusBar()->showMessage(QString("Generation en pause (%1/%2 images)")
-                .arg(m_plateNextIndex).arg(m_plateTextSegments.size()));
+                .arg(m_plateCompletedCount).arg(m_plateTextSegments.size()));
             LOG_INFO(QString("Plate generation paused at %1/%2")
-                .arg(m_plateNextIndex).arg(m_plateTextSegments.size()));
+                .arg(m_plateCompletedCount).arg(m_plateTextSegments.size()));
         }
         return;
     }
@@ -1618,8 +1785,9 @@ void MainWindow::loadProject(const codex::db::Project& project) {
     // Load treatise if set
     if (!project.treatiseCode.isEmpty()) {
         codex::core::ParsedTreatise treatise = m_textParser->extractTreatise(project.treatiseCode);
-        if (!treatise.fullText.isEmpty()) {
-            m_textViewer->setTextWithVerses(treatise.fullText, treatise.startPage);
+        if (!treatise.isEmpty()) {
+            m_currentTreatiseHeader.clear();
+            showTreatiseText(treatise);
         }
     }
 
@@ -1757,7 +1925,7 @@ void MainWindow::onGeneratePlateFromPreview(const QString& passage, int cols, in
         return;
     }
 
-    if (m_pipelineController->isRunning()) {
+    if (m_plateGenerating) {
         codex::utils::MessageBox::warning(this, "Generation en cours",
             "Une generation est deja en cours. Veuillez patienter.");
         return;
@@ -1766,14 +1934,23 @@ void MainWindow::onGeneratePlateFromPreview(const QString& passage, int cols, in
     int totalImages = cols * rows;
     m_plateCols = cols;
     m_plateRows = rows;
-    m_plateTextSegments = splitTextForPlate(passage, totalImages);
+    // Same segments as the slideshow, balanced by narration length
+    using codex::core::SentenceSegmenter;
+    m_plateTextSegments = SentenceSegmenter::texts(
+        passage, SentenceSegmenter::segments(passage, totalImages, SentenceSegmenter::Measure::Speech));
     m_plateNextIndex = 0;
+    m_plateCompletedCount = 0;
+    m_plateJobIndex.clear();
+    m_plateEnrichments.clear();
+    m_plateBatchId = 0;
+    m_plateMaxInFlight = codex::utils::Config::instance().plateMaxInFlight();
     m_plateGenerating = true;
 
     // Create a new session in MediaStorage for auto-saving
     // Note: MediaStorage uses the codex file's parent directory as base path
     codex::utils::MediaStorage::instance().updateBasePath();
     codex::utils::MediaStorage::instance().createSession(m_currentTreatiseCode);
+    m_plateSession = "plate:" + codex::utils::MediaStorage::instance().currentSessionPath();
 
     // Start the grid display
     m_imageViewer->startPlateGrid(cols, rows);
@@ -1781,144 +1958,140 @@ void MainWindow::onGeneratePlateFromPreview(const QString& passage, int cols, in
     statusBar()->showMessage(QString("Generation de planche %1x%2 : demarrage...")
                              .arg(cols).arg(rows));
 
-    LOG_INFO(QString("Starting plate generation: %1x%2, %3 segments")
-             .arg(cols).arg(rows).arg(m_plateTextSegments.size()));
+    LOG_INFO(QString("Starting plate generation: %1x%2, %3 segments, %4 in flight")
+             .arg(cols).arg(rows).arg(m_plateTextSegments.size()).arg(m_plateMaxInFlight));
+
+    // Enrich every segment with one LLM request, images start once it lands
+    if (codex::utils::Config::instance().plateBatchEnrichment() && m_plateTextSegments.size() > 1) {
+        statusBar()->showMessage(QString("Generation de planche %1x%2 : enrichissement des %3 cases...")
+                                 .arg(cols).arg(rows).arg(m_plateTextSegments.size()));
+        codex::api::RequestTicket ticket;
+        ticket.priority = codex::api::RequestPriority::Batch;
+        ticket.session = m_plateSession;
+        m_plateBatchId = m_pipelineController->enrichBatch(
+            m_plateTextSegments, m_currentTreatiseCode, m_currentCategory, ticket);
+        return;
+    }
 
-    // Start generating first image
+    // Start generating the first window of images
     generateNextPlateImage();
 }
 
-QStringList MainWindow::splitTextForPlate(const QString& text, int count) {
-    QStringList segments;
-    if (text.isEmpty() || count <= 0) return segments;
-
-    // Split by sentences first
-    QStringList sentences;
-    QString current;
-    for (int i = 0; i < text.length(); ++i) {
-        current += text[i];
-        if (text[i] == '.' || text[i] == '!' || text[i] == '?') {
-            // Check if it's end of sentence (not abbreviation)
-            if (i + 1 >= text.length() || text[i + 1] == ' ' || text[i + 1] == '\n') {
-                sentences.append(current.trimmed());
-                current.clear();
-            }
-        }
+void MainWindow::generateNextPlateImage() {
+    if (!m_plateGenerating) return;
+
+    // All segments dispatched and none left in flight
+    if (m_plateNextIndex >= m_plateTextSegments.size() && m_plateJobIndex.isEmpty()) {
+        finishPlateGeneration();
+        return;
     }
-    if (!current.trimmed().isEmpty()) {
-        sentences.append(current.trimmed());
+
+    // Waiting for the batch enrichment of the plate
+    if (m_plateBatchId != 0) return;
+
+    // Check if paused - in-flight images still land, but no new ones start
+    if (m_platePaused) {
+        LOG_INFO("Plate generation paused, waiting for resume");
+        return;
     }
 
-    // If we have enough sentences, distribute them
-    if (sentences.size() >= count) {
-        int perSegment = sentences.size() / count;
-        int remainder = sentences.size() % count;
+    // Keep up to m_plateMaxInFlight pipeline runs going
+    while (m_plateJobIndex.size() < m_plateMaxInFlight
+           && m_plateNextIndex < m_plateTextSegments.size()) {
+        int index = m_plateNextIndex++;
+        QString segment = m_plateTextSegments[index];
 
-        int idx = 0;
-        for (int i = 0; i < count; ++i) {
-            QString segment;
-            int sentenceCount = perSegment + (i < remainder ? 1 : 0);
-            for (int j = 0; j < sentenceCount && idx < sentences.size(); ++j, ++idx) {
-                if (!segment.isEmpty()) segment += " ";
-                segment += sentences[idx];
-            }
-            segments.append(segment);
+        // Neighbouring panels with the same text share a scene: ask Imagen
+        // for one sample per panel in a single request
+        QList<int> indexes{index};
+        while (m_plateNextIndex < m_plateTextSegments.size()
+               && indexes.size() < codex::api::ImagenClient::MAX_SAMPLES
+               && m_plateTextSegments[m_plateNextIndex] == segment) {
+            indexes.append(m_plateNextIndex++);
         }
-    } else {
-        // Not enough sentences - split text into equal parts
-        int charsPerSegment = text.length() / count;
-        for (int i = 0; i < count; ++i) {
-            int start = i * charsPerSegment;
-            int len = (i == count - 1) ? -1 : charsPerSegment;
-
-            QString segment = text.mid(start, len).trimmed();
-
-            // Try to end at word boundary
-            if (len > 0 && start + len < text.length()) {
-                int lastSpace = segment.lastIndexOf(' ');
-                if (lastSpace > segment.length() * 0.7) {
-                    segment = segment.left(lastSpace).trimmed();
-                }
-            }
 
-            if (!segment.isEmpty()) {
-                segments.append(segment);
-            }
-        }
-    }
+        LOG_INFO(QString("Generating plate image %1/%2: %3 chars, %4 sample(s)")
+                 .arg(index + 1)
+                 .arg(m_plateTextSegments.size())
+                 .arg(segment.length())
+                 .arg(indexes.size()));
+
+        // Start generation for this segment, behind interactive requests
+        codex::api::RequestTicket ticket;
+        ticket.priority = codex::api::RequestPriority::Batch;
+        ticket.session = m_plateSession;
+        ticket.panel = index;
+        int jobId = m_pipelineController->startGeneration(segment, m_currentTreatiseCode, m_currentCategory,
+                                                          m_plateEnrichments.value(index), indexes.size(),
+                                                          ticket);
+        m_plateJobIndex.insert(jobId, indexes);
+    }
+
+    statusBar()->showMessage(QString("Generation planche: %1/%2 images, %3 en cours...")
+                             .arg(m_plateCompletedCount)
+                             .arg(m_plateTextSegments.size())
+                             .arg(m_plateJobIndex.size()));
+}
 
-    // Ensure we have exactly 'count' segments
-    while (segments.size() < count) {
-        // Duplicate last segment if needed
-        segments.append(segments.isEmpty() ? text.left(100) : segments.last());
-    }
-    while (segments.size() > count) {
-        segments.removeLast();
-    }
+void MainWindow::onBatchEnrichmentCompleted(int batchId, const QVector<codex::core::SceneEnrichment>& scenes) {
+    if (batchId != m_plateBatchId) return;
 
-    return segments;
-}
+    m_plateBatchId = 0;
+    m_plateEnrichments = scenes;
 
-void MainWindow::generateNextPlateImage() {
-    // Check if paused - don't continue generating
-    if (m_platePaused) {
-        LOG_INFO("Plate generation paused, waiting for resume");
-        return;
-    }
+    LOG_INFO(QString("Plate batch enrichment received: %1 scenes").arg(scenes.size()));
 
-    if (!m_plateGenerating || m_plateNextIndex >= m_plateTextSegments.size()) {
-        // All done
-        m_plateGenerating = false;
-        m_platePaused = false;
-        m_imageViewer->finishPlateGrid();
-        statusBar()->showMessage(QString("Planche %1x%2 terminee! Images sauvegardees dans %3")
-                                 .arg(m_plateCols).arg(m_plateRows)
-                                 .arg(codex::utils::MediaStorage::instance().currentSessionPath()));
-        LOG_INFO("Plate generation completed");
-
-        // Reset button to initial state
-        m_genAllBtn->setText("Generer Tout + Diapo");
-        m_genAllBtn->setStyleSheet(R"(
-            QPushButton {
-                background-color: #1e5a1e;
-                color: white;
-                border: none;
-                border-radius: 4px;
-                padding: 5px 12px;
-                font-weight: bold;
-            }
-            QPushButton:hover { background-color: #2d7a2d; }
-            QPushButton:pressed { background-color: #0d3a0d; }
-        )");
+    // Fan out to Imagen
+    generateNextPlateImage();
+}
 
-        // Hide progress bar
-        m_progressBar->hide();
+void MainWindow::onBatchEnrichmentCancelled(int batchId) {
+    if (batchId != m_plateBatchId) return;
 
-        // Save session metadata
-        codex::utils::MediaStorage::instance().saveSessionMetadata(
-            m_currentTreatiseCode, m_currentCategory,
-            m_plateTextSegments.size(), m_plateTextSegments);
+    // No image starts before the batch lands: the plate simply ends here
+    m_plateBatchId = 0;
+    m_plateNextIndex = m_plateTextSegments.size();
+    LOG_INFO("Plate batch enrichment cancelled");
+    finishPlateGeneration();
+}
 
-        // Notify slideshow that all images have been sent
-        if (m_activeSlideshowDialog) {
-            m_activeSlideshowDialog->finishAddingImages();
-            LOG_INFO("Notified slideshow that all images are done");
+void MainWindow::finishPlateGeneration() {
+    m_plateGenerating = false;
+    m_platePaused = false;
+    m_imageViewer->finishPlateGrid();
+    statusBar()->showMessage(QString("Planche %1x%2 terminee! Images sauvegardees dans %3")
+                             .arg(m_plateCols).arg(m_plateRows)
+                             .arg(codex::utils::MediaStorage::instance().currentSessionPath()));
+    LOG_INFO("Plate generation completed");
+
+    // Reset button to initial state
+    m_genAllBtn->setText("Generer Tout + Diapo");
+    m_genAllBtn->setStyleSheet(R"(
+        QPushButton {
+            background-color: #1e5a1e;
+            color: white;
+            border: none;
+            border-radius: 4px;
+            padding: 5px 12px;
+            font-weight: bold;
         }
-        return;
-    }
+        QPushButton:hover { background-color: #2d7a2d; }
+        QPushButton:pressed { background-color: #0d3a0d; }
+    )");
 
-    QString segment = m_plateTextSegments[m_plateNextIndex];
-    statusBar()->showMessage(QString("Generation planche: image %1/%2...")
-                             .arg(m_plateNextIndex + 1)
-                             .arg(m_plateTextSegments.size()));
+    // Hide progress bar
+    m_progressBar->hide();
 
-    LOG_INFO(QString("Generating plate image %1/%2: %3 chars")
-             .arg(m_plateNextIndex + 1)
-             .arg(m_plateTextSegments.size())
-             .arg(segment.length()));
+    // Save session metadata
+    codex::utils::MediaStorage::instance().saveSessionMetadata(
+        m_currentTreatiseCode, m_currentCategory,
+        m_plateTextSegments.size(), m_plateTextSegments);
 
-    // Start generation for this segment
-    m_pipelineController->startGeneration(segment, m_currentTreatiseCode, m_currentCategory);
+    // Notify slideshow that all images have been sent
+    if (m_activeSlideshowDialog) {
+        m_activeSlideshowDialog->finishAddingImages();
+        LOG_INFO("Notified slideshow that all images are done");
+    }
 }
 
 } // namespace codex::ui
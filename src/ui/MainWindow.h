@@ -3,11 +3,13 @@
 #include <QMainWindow>
 #include <QTimer>
 #include <QComboBox>
+#include <QLabel>
 #include <QLineEdit>
 #include <QProgressBar>
 #include <QPushButton>
 #include <QTabWidget>
 #include <QTextEdit>
+#include <QHash>
 #include <memory>
 #include "db/repositories/ProjectRepository.h"
 
@@ -20,6 +22,8 @@ class VeoClient;
 namespace codex::core {
 class TextParser;
 class PipelineController;
+struct SceneEnrichment;
+struct ParsedTreatise;
 enum class PipelineState;
 }
 
@@ -59,6 +63,7 @@ private slots:
 
     void onTreatiseSelected(const QString& code, const QString& title, const QString& category);
     void onTreatiseDoubleClicked(const QString& code, const QString& title, const QString& category);
+    void onIndexPassageRequested(const QString& code, const QString& passage, qsizetype start, qsizetype end);
 
     void onGenerateImageFromPreview(const QString& passage);
     void onGenerateAudioFromPreview(const QString& passage);
@@ -69,10 +74,11 @@ private slots:
     void onVideoProgress(int percent);
     void onVideoError(const QString& error);
 
-    void onPipelineStateChanged(codex::core::PipelineState state, const QString& message);
-    void onPipelineProgress(int percent, const QString& step);
-    void onPipelineCompleted(const QPixmap& image, const QString& prompt);
-    void onPipelineFailed(const QString& error);
+    void onPipelineStateChanged(int jobId, codex::core::PipelineState state, const QString& message);
+    void onPipelineProgress(int jobId, int percent, const QString& step);
+    void onPipelineCompleted(int jobId, const QPixmap& image, const QString& prompt,
+                             const QList<QPixmap>& variants);
+    void onPipelineFailed(int jobId, const QString& error);
     void onSaveImage();
 
     void onAudioGenerated(const QByteArray& audioData, int durationMs);
@@ -90,6 +96,17 @@ private:
     void setupConnections();
     void loadCodexAndRefreshUI(const QString& filePath);
 
+    // Start loading or building the viewer's narration cache off the GUI thread
+    void prepareNarrationCache();
+    void onNarrationCacheReady();
+
+    // Display a treatise under m_currentTreatiseHeader: cached text with source
+    // offsets when ready, raw text cleaned on the spot otherwise
+    void showTreatiseText(const codex::core::ParsedTreatise& treatise);
+
+    // Narration text of a passage: from the precomputed cache when it is the viewer selection
+    QString narrationText(const QString& passage);
+
     TreatiseListWidget* m_treatiseList = nullptr;
     TextViewerWidget* m_textViewer = nullptr;
     ImageViewerWidget* m_imageViewer = nullptr;
@@ -113,12 +130,25 @@ private:
     QString m_selectedPassage;
     QString m_currentTreatiseCode;
     QString m_currentCategory;
+    QString m_currentTreatiseHeader;
     int m_selectionStart = -1;
     int m_selectionEnd = -1;
+    QPair<qsizetype, qsizetype> m_selectionSource{-1, -1};    // Selection in the Codex raw content
 
     // Plate generation state
     QStringList m_plateTextSegments;
-    int m_plateNextIndex = 0;
+    int m_plateNextIndex = 0;           // Next segment to dispatch
+    int m_plateCompletedCount = 0;      // Segments finished (success or failure)
+    int m_plateMaxInFlight = 1;         // Concurrent pipeline runs for the plate
+    QHash<int, QList<int>> m_plateJobIndex;    // Pipeline job id -> segment indexes (one per sample)
+    int m_plateBatchId = 0;             // Pending batch enrichment (0 when none)
+    QString m_plateSession;             // RequestQueue session of the plate jobs
+    QVector<codex::core::SceneEnrichment> m_plateEnrichments;
+
+    // Single image generation job (0 when none)
+    int m_singleImageJobId = 0;
+    QString m_lastImagePassage;         // Asked again: new images, not the cached ones
+    QString m_lastAudioPassage;         // Asked again: a new take, not the cached one
     int m_plateCols = 0;
     int m_plateRows = 0;
     bool m_plateGenerating = false;
@@ -141,6 +171,9 @@ private:
     // Progress bar for generation
     QProgressBar* m_progressBar = nullptr;
 
+    // Request queue counts in the status bar
+    QLabel* m_queueLabel = nullptr;
+
     // Generate All + Slideshow button (to change text during generation)
     QPushButton* m_genAllBtn = nullptr;
 
@@ -166,7 +199,10 @@ private:
     void showRecentProjectsOnStartup();
 
     void generateNextPlateImage();
-    QStringList splitTextForPlate(const QString& text, int count);
+    void finishPlateGeneration();
+    void saveImageBesidePlate(const QPixmap& image);
+    void onBatchEnrichmentCompleted(int batchId, const QVector<codex::core::SceneEnrichment>& scenes);
+    void onBatchEnrichmentCancelled(int batchId);
 };
 
 } // namespace codex::ui
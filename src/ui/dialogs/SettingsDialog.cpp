@@ -1,4 +1,5 @@
 #include "SettingsDialog.h"
+#include "api/NetworkTransport.h"
 #include "utils/SecureStorage.h"
 #include "utils/Config.h"
 #include "utils/Logger.h"
@@ -15,7 +16,6 @@
 #include <QFileDialog>
 #include <QColorDialog>
 #include <QDir>
-#include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QNetworkRequest>
 #include <QJsonDocument>
@@ -59,6 +59,10 @@ void SettingsDialog::setupUi() {
     providerLayout->addWidget(new QLabel("Fournisseur:"));
     providerLayout->addWidget(m_llmProviderCombo, 1);
     llmMainLayout->addLayout(providerLayout);
+
+    m_plateBatchCheck = new QCheckBox("Planche: enrichir toutes les cases en une seule requete", llmGroup);
+    m_plateBatchCheck->setToolTip("Un seul appel LLM pour tous les segments, style coherent entre les cases");
+    llmMainLayout->addWidget(m_plateBatchCheck);
     apiLayout->addWidget(llmGroup);
 
     // Claude API
@@ -121,7 +125,6 @@ void SettingsDialog::setupUi() {
         }
         setCursor(Qt::WaitCursor);
         QString testUrl = QString("https://aiplatform.googleapis.com/v1/publishers/google/models/gemini-2.0-flash:generateContent?key=%1").arg(key);
-        QNetworkAccessManager* netManager = new QNetworkAccessManager(this);
         QUrl testQUrl(testUrl);
         QNetworkRequest testReq;
         testReq.setUrl(testQUrl);
@@ -140,8 +143,8 @@ void SettingsDialog::setupUi() {
         QJsonObject testGenConfig;
         testGenConfig["maxOutputTokens"] = 10;
         testBody["generationConfig"] = testGenConfig;
-        QNetworkReply* testReply = netManager->post(testReq, QJsonDocument(testBody).toJson());
-        connect(testReply, &QNetworkReply::finished, this, [this, testReply, netManager]() {
+        QNetworkReply* testReply = codex::api::NetworkTransport::instance().post(testReq, QJsonDocument(testBody).toJson());
+        connect(testReply, &QNetworkReply::finished, this, [this, testReply]() {
             setCursor(Qt::ArrowCursor);
             if (testReply->error() == QNetworkReply::NoError) {
                 codex::utils::MessageBox::info(this, "Test Vertex AI", "Connexion Vertex AI reussie !");
@@ -157,7 +160,6 @@ void SettingsDialog::setupUi() {
                 codex::utils::MessageBox::warning(this, "Test Vertex AI", QString("Erreur: %1").arg(errorMsg));
             }
             testReply->deleteLater();
-            netManager->deleteLater();
         });
     });
     vertexKeyLayout->addWidget(new QLabel("Cle API:"));
@@ -165,6 +167,15 @@ void SettingsDialog::setupUi() {
     vertexKeyLayout->addWidget(testVertexBtn);
     vertexMainLayout->addLayout(vertexKeyLayout);
 
+    auto* concurrencyLayout = new QHBoxLayout();
+    m_plateConcurrencySpin = new QSpinBox(vertexGroup);
+    m_plateConcurrencySpin->setRange(1, 8);
+    m_plateConcurrencySpin->setToolTip("Nombre d'images generees en parallele pour une planche");
+    concurrencyLayout->addWidget(new QLabel("Requetes simultanees (planche):"));
+    concurrencyLayout->addWidget(m_plateConcurrencySpin);
+    concurrencyLayout->addStretch();
+    vertexMainLayout->addLayout(concurrencyLayout);
+
     auto* vertexInfoLabel = new QLabel(
         "<i>Payant. Pour Imagen (images) et Veo (videos). Quotas entreprise.</i>",
         vertexGroup
@@ -320,6 +331,21 @@ void SettingsDialog::setupUi() {
     videosPathLayout->addWidget(browseVideosBtn);
     pathsLayout->addRow("Dossier videos:", videosPathLayout);
 
+    // Response cache of the generation APIs
+    auto* cacheLayout = new QHBoxLayout();
+    m_responseCacheCheck = new QCheckBox("Reutiliser les reponses deja generees", pathsTab);
+    m_responseCacheCheck->setToolTip("Meme prompt, meme modele et memes parametres: la reponse est lue sur le disque "
+                                     "au lieu d'etre generee et facturee de nouveau");
+    m_responseCacheSizeSpin = new QSpinBox(pathsTab);
+    m_responseCacheSizeSpin->setRange(16, 65536);
+    m_responseCacheSizeSpin->setSingleStep(256);
+    m_responseCacheSizeSpin->setSuffix(" Mo");
+    connect(m_responseCacheCheck, &QCheckBox::toggled, m_responseCacheSizeSpin, &QSpinBox::setEnabled);
+    cacheLayout->addWidget(m_responseCacheCheck);
+    cacheLayout->addWidget(m_responseCacheSizeSpin);
+    cacheLayout->addStretch();
+    pathsLayout->addRow("Cache:", cacheLayout);
+
     m_tabWidget->addTab(pathsTab, "Chemins");
 
     // ========== Appearance Tab ==========
@@ -507,10 +533,17 @@ void SettingsDialog::loadSettings() {
         }
     }
 
+    // Load generation settings
+    m_plateConcurrencySpin->setValue(config.plateMaxInFlight());
+    m_plateBatchCheck->setChecked(config.plateBatchEnrichment());
+
     // Load paths
     m_codexPathEdit->setText(config.codexFilePath());
     m_outputImagesPathEdit->setText(config.outputImagesPath());
     m_outputVideosPathEdit->setText(config.outputVideosPath());
+    m_responseCacheCheck->setChecked(config.responseCacheEnabled());
+    m_responseCacheSizeSpin->setValue(config.responseCacheMaxMb());
+    m_responseCacheSizeSpin->setEnabled(config.responseCacheEnabled());
 
     // Load appearance settings
     auto& theme = codex::utils::ThemeManager::instance();
@@ -587,10 +620,16 @@ void SettingsDialog::saveSettings() {
     QString selectedVoiceId = m_voiceCombo->currentData().toString();
     config.setElevenLabsVoiceId(selectedVoiceId);
 
+    // Save generation settings
+    config.setPlateMaxInFlight(m_plateConcurrencySpin->value());
+    config.setPlateBatchEnrichment(m_plateBatchCheck->isChecked());
+
     // Save paths
     config.setCodexFilePath(m_codexPathEdit->text());
     config.setOutputImagesPath(m_outputImagesPathEdit->text());
     config.setOutputVideosPath(m_outputVideosPathEdit->text());
+    config.setResponseCacheEnabled(m_responseCacheCheck->isChecked());
+    config.setResponseCacheMaxMb(m_responseCacheSizeSpin->value());
 
     // Save appearance settings
     auto& theme = codex::utils::ThemeManager::instance();
@@ -691,7 +730,6 @@ void SettingsDialog::onTestClaude() {
 
     setCursor(Qt::WaitCursor);
 
-    QNetworkAccessManager manager;
     QUrl reqUrl("https://api.anthropic.com/v1/messages");
     QNetworkRequest req(reqUrl);
     req.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
@@ -709,7 +747,7 @@ void SettingsDialog::onTestClaude() {
     body["messages"] = messages;
 
     QByteArray postData = QJsonDocument(body).toJson();
-    QNetworkReply* reply = manager.post(req, postData);
+    QNetworkReply* reply = codex::api::NetworkTransport::instance().post(req, postData);
 
     // Attendre la réponse avec timeout de 30 secondes
     QTimer timer;
@@ -764,7 +802,6 @@ void SettingsDialog::onTestGoogleAI() {
     // AI Studio endpoint
     QString url = QString("https://generativelanguage.googleapis.com/v1beta/models/gemini-2.0-flash:generateContent?key=%1").arg(key);
 
-    QNetworkAccessManager manager;
     QUrl reqUrl(url);
     QNetworkRequest req(reqUrl);
     req.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
@@ -786,7 +823,7 @@ void SettingsDialog::onTestGoogleAI() {
     body["generationConfig"] = genConfig;
 
     QByteArray postData = QJsonDocument(body).toJson();
-    QNetworkReply* reply = manager.post(req, postData);
+    QNetworkReply* reply = codex::api::NetworkTransport::instance().post(req, postData);
 
     // Attendre la réponse avec timeout de 30 secondes
     QTimer timer;
@@ -837,12 +874,11 @@ void SettingsDialog::onTestElevenLabs() {
 
     setCursor(Qt::WaitCursor);
 
-    QNetworkAccessManager manager;
     QUrl reqUrl("https://api.elevenlabs.io/v1/user");
     QNetworkRequest req(reqUrl);
     req.setRawHeader("xi-api-key", key.toUtf8());
 
-    QNetworkReply* reply = manager.get(req);
+    QNetworkReply* reply = codex::api::NetworkTransport::instance().get(req);
 
     // Attendre la réponse avec timeout de 30 secondes
     QTimer timer;
@@ -43,13 +43,17 @@ private:
     QLineEdit* m_elevenLabsKeyEdit;
     QComboBox* m_voiceCombo;           // ElevenLabs voices
     QComboBox* m_llmProviderCombo;     // Claude vs Gemini
+    QCheckBox* m_plateBatchCheck;      // One LLM request per plate
     QComboBox* m_ttsProviderCombo;     // ElevenLabs vs Edge TTS
     QComboBox* m_edgeVoiceCombo;       // Edge TTS voices
+    QSpinBox* m_plateConcurrencySpin;  // Concurrent Imagen runs for a plate
 
     // Paths tab
     QLineEdit* m_codexPathEdit;
     QLineEdit* m_outputImagesPathEdit;
     QLineEdit* m_outputVideosPathEdit;
+    QCheckBox* m_responseCacheCheck;   // Reuse earlier generation responses
+    QSpinBox* m_responseCacheSizeSpin; // Response cache limit, in MB
 
     // Appearance tab
     QComboBox* m_themeCombo;
@@ -2,8 +2,11 @@
 #include "SessionPickerDialog.h"
 #include "VideoPreviewDialog.h"
 #include "api/EdgeTTSClient.h"
+#include "api/RequestQueue.h"
 #include "api/VeoClient.h"
 #include "core/services/NarrationCleaner.h"
+#include "core/services/SentenceSegmenter.h"
+#include "core/services/VideoExporter.h"
 #include "utils/Logger.h"
 #include "utils/Config.h"
 #include "utils/MediaStorage.h"
@@ -29,8 +32,6 @@
 #include <QPdfWriter>
 #include <QTextDocument>
 #include <QMenu>
-#include <QProcess>
-#include <QTemporaryDir>
 #include <QBuffer>
 #include <QClipboard>
 #include <QTextEdit>
@@ -75,6 +76,8 @@ SlideshowDialog::SlideshowDialog(QWidget* parent)
     setMinimumSize(1200, 800);
     setWindowFlags(windowFlags() | Qt::WindowMaximizeButtonHint);
 
+    m_requestSession = "slideshow:" + codex::utils::MediaStorage::instance().currentSessionPath();
+
     // Create temp directory for audio files
     m_tempDir = QDir::tempPath() + "/codex_slideshow_" + QString::number(QDateTime::currentMSecsSinceEpoch());
     QDir().mkpath(m_tempDir);
@@ -132,6 +135,23 @@ SlideshowDialog::SlideshowDialog(QWidget* parent)
             this, &SlideshowDialog::onVideoProgress);
     connect(m_veoClient, &codex::api::VeoClient::errorOccurred,
             this, &SlideshowDialog::onVideoError);
+    connect(m_veoClient, &codex::api::VeoClient::retryScheduled, this, [this](int attempt, int delayMs) {
+        m_statusLabel->setText(QString("Quota Veo atteint, nouvel essai %1 dans %2 s...")
+                               .arg(attempt).arg((delayMs + 999) / 1000));
+    });
+
+    // Background MP4 export
+    m_videoExporter = new codex::core::VideoExporter(this);
+    connect(m_videoExporter, &codex::core::VideoExporter::progressChanged,
+            this, &SlideshowDialog::onExportProgress);
+    connect(m_videoExporter, &codex::core::VideoExporter::finished,
+            this, &SlideshowDialog::onExportFinished);
+    connect(m_videoExporter, &codex::core::VideoExporter::failed,
+            this, &SlideshowDialog::onExportFailed);
+    connect(m_videoExporter, &codex::core::VideoExporter::cancelled, this, [this]() {
+        m_videoBtn->setText("Exporter Video");
+        m_statusLabel->setText("Export video annule");
+    });
 
     setupUi();
 
@@ -139,6 +159,8 @@ SlideshowDialog::SlideshowDialog(QWidget* parent)
 }
 
 SlideshowDialog::~SlideshowDialog() {
+    codex::api::RequestQueue::instance().setFocus(m_requestSession, -1);
+
     // Clean up temp files
     QDir tempDir(m_tempDir);
     tempDir.removeRecursively();
@@ -530,48 +552,23 @@ void SlideshowDialog::prepareSlideshow() {
 }
 
 void SlideshowDialog::splitTextIntoSegments() {
-    // Split text into sentences first
-    QStringList sentences;
-    QString currentSentence;
-
-    for (const QChar& c : m_fullText) {
-        currentSentence += c;
-        if (c == '.' || c == '!' || c == '?' || c == ';') {
-            sentences.append(currentSentence.trimmed());
-            currentSentence.clear();
-        }
-    }
-    if (!currentSentence.trimmed().isEmpty()) {
-        sentences.append(currentSentence.trimmed());
-    }
-
-    // Distribute sentences across expected images
-    int sentencesPerImage = qMax(1, sentences.size() / m_totalExpectedImages);
+    // Same segments as the plate, balanced by narration length
+    using codex::core::SentenceSegmenter;
+    const QVector<codex::core::TextSpan> segments =
+        SentenceSegmenter::segments(m_fullText, m_totalExpectedImages, SentenceSegmenter::Measure::Speech);
 
     m_slides.clear();
 
     for (int i = 0; i < m_totalExpectedImages; ++i) {
         SlideItem slide;
-
-        int startIdx = i * sentencesPerImage;
-        int endIdx = (i == m_totalExpectedImages - 1) ? sentences.size() : (i + 1) * sentencesPerImage;
-
-        QStringList segmentSentences;
-        for (int j = startIdx; j < endIdx && j < sentences.size(); ++j) {
-            segmentSentences.append(sentences[j]);
+        if (i < segments.size()) {
+            slide.text = m_fullText.mid(segments[i].start, segments[i].length);
         }
-
-        if (segmentSentences.isEmpty() && !sentences.isEmpty()) {
-            // Use last sentence if we run out
-            segmentSentences.append(sentences.last());
-        }
-
-        slide.text = segmentSentences.join(" ");
         m_slides.append(slide);
     }
 
-    LOG_INFO(QString("Split text into %1 segments. Total sentences found: %2")
-             .arg(m_slides.size()).arg(sentences.size()));
+    LOG_INFO(QString("Split text into %1 segments (%2 chars)")
+             .arg(m_slides.size()).arg(m_fullText.length()));
 }
 
 void SlideshowDialog::addImage(const QPixmap& image, const QString& text, int index) {
@@ -794,6 +791,8 @@ void SlideshowDialog::showSlide(int index) {
     }
 
     m_currentIndex = index;
+    codex::api::RequestQueue::instance().setFocus(m_requestSession, index);
+    emit slideShown(index);
 
     // Display image with text embedded
     QSize targetSize = m_imageLabel->size();
@@ -1095,6 +1094,7 @@ void SlideshowDialog::closeEvent(QCloseEvent* event) {
     m_isPaused = false;
     m_audioPlayer->stop();
     m_slideTimer->stop();
+    m_videoExporter->cancel();
     QDialog::closeEvent(event);
 }
 
@@ -1318,6 +1318,8 @@ void SlideshowDialog::onLoadMedia() {
 
 void SlideshowDialog::loadMediaSession(const QString& sessionPath) {
     auto& storage = codex::utils::MediaStorage::instance();
+    codex::api::RequestQueue::instance().setFocus(m_requestSession, -1);
+    m_requestSession = "slideshow:" + sessionPath;
     auto info = storage.loadSessionInfo(sessionPath);
 
     if (info.imageCount == 0) {
@@ -1622,6 +1624,13 @@ void SlideshowDialog::generateVideoForSlide(int slideIndex) {
     params.referenceImage = imageData;
     params.referenceImageMimeType = "image/png";
 
+    // A single video is waited on, the "all videos" batch yields to interactive work
+    codex::api::RequestTicket ticket;
+    ticket.priority = m_generatingAllVideos ? codex::api::RequestPriority::Batch
+                                            : codex::api::RequestPriority::Interactive;
+    ticket.session = m_requestSession;
+    ticket.panel = slideIndex;
+    m_veoClient->setTicket(ticket);
     m_veoClient->generateVideo(params);
 
     LOG_INFO(QString("AI Video generation started from slide %1 with image (%2x%3). Prompt: %4 chars")
@@ -1816,6 +1825,12 @@ void SlideshowDialog::processNextVideoInQueue() {
 }
 
 void SlideshowDialog::onExportVideo() {
+    // The button doubles as cancel while an export is running
+    if (m_videoExporter->isRunning()) {
+        m_videoExporter->cancel();
+        return;
+    }
+
     if (m_slides.isEmpty()) {
         QMessageBox::warning(this, "Erreur", "Aucune image a exporter.");
         return;
@@ -1832,33 +1847,8 @@ void SlideshowDialog::onExportVideo() {
         return;
     }
 
-    // Find FFmpeg executable
-    QString ffmpegPath = "ffmpeg";  // Default: try PATH
-
-    // Check common installation paths if not in PATH
-    QStringList searchPaths = {
-        "ffmpeg",
-        QDir::homePath() + "/AppData/Local/Microsoft/WinGet/Links/ffmpeg.exe",
-        "C:/ffmpeg/bin/ffmpeg.exe",
-        "C:/Program Files/ffmpeg/bin/ffmpeg.exe",
-        "C:/Program Files (x86)/ffmpeg/bin/ffmpeg.exe"
-    };
-
-    bool ffmpegFound = false;
-    for (const QString& path : searchPaths) {
-        QProcess testProcess;
-        testProcess.start(path, QStringList() << "-version");
-        testProcess.waitForFinished(3000);
-
-        if (testProcess.exitCode() == 0 && testProcess.error() != QProcess::FailedToStart) {
-            ffmpegPath = path;
-            ffmpegFound = true;
-            LOG_INFO(QString("FFmpeg found at: %1").arg(ffmpegPath));
-            break;
-        }
-    }
-
-    if (!ffmpegFound) {
+    // Find FFmpeg executable (looked up once, then cached)
+    if (codex::core::VideoExporter::ffmpegPath().isEmpty()) {
         QMessageBox::warning(this, "FFmpeg requis",
             "FFmpeg n'est pas installe ou introuvable.\n\n"
             "Pour installer FFmpeg sur Windows:\n"
@@ -1883,161 +1873,63 @@ void SlideshowDialog::onExportVideo() {
 
     if (filePath.isEmpty()) return;
 
-    // Create temp directory for frames
-    QTemporaryDir tempDir;
-    if (!tempDir.isValid()) {
-        QMessageBox::critical(this, "Erreur", "Impossible de creer le dossier temporaire.");
-        return;
-    }
-
-    m_videoBtn->setEnabled(false);
-    m_videoBtn->setText("Export...");
-    m_statusLabel->setText("Export video en cours...");
-    QApplication::processEvents();
-
-    // Export frames with text overlay
-    QStringList frameFiles;
-    QStringList audioFiles;
-    double totalDuration = 0;
-
+    // Render frames with text overlay; encoding happens in the background
+    QList<codex::core::VideoExportSlide> exportSlides;
     for (int i = 0; i < m_slides.size(); ++i) {
         if (!m_slides[i].imageReady) continue;
 
-        // Create image with text overlay
-        QPixmap frameImage = createImageWithText(i);
-        QString framePath = QString("%1/frame_%2.png")
-            .arg(tempDir.path())
-            .arg(i, 4, 10, QChar('0'));
+        codex::core::VideoExportSlide exportSlide;
+        exportSlide.frame = createImageWithText(i).toImage();
 
-        frameImage.save(framePath, "PNG");
-        frameFiles.append(framePath);
-
-        // Get audio duration or use default
-        double duration = 5.0;  // Default 5 seconds per slide
+        // Get audio duration or use default (5 seconds per slide)
         if (m_slides[i].audioReady && m_slides[i].audioDurationMs > 0) {
-            duration = m_slides[i].audioDurationMs / 1000.0;
+            exportSlide.durationMs = m_slides[i].audioDurationMs;
         }
-        totalDuration += duration;
 
         // Add audio file if available
         if (m_slides[i].audioReady && !m_slides[i].audioPath.isEmpty()) {
-            audioFiles.append(m_slides[i].audioPath);
+            exportSlide.audioPath = m_slides[i].audioPath;
         }
+        exportSlides.append(exportSlide);
     }
 
-    if (frameFiles.isEmpty()) {
-        m_videoBtn->setEnabled(true);
-        m_videoBtn->setText("Exporter Video");
+    if (exportSlides.isEmpty()) {
         QMessageBox::warning(this, "Erreur", "Aucune image a exporter.");
         return;
     }
 
-    // Create FFmpeg concat file for images
-    QString concatPath = tempDir.path() + "/concat.txt";
-    QFile concatFile(concatPath);
-    if (concatFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QTextStream stream(&concatFile);
-        for (int i = 0; i < frameFiles.size(); ++i) {
-            double duration = 5.0;
-            if (i < m_slides.size() && m_slides[i].audioDurationMs > 0) {
-                duration = m_slides[i].audioDurationMs / 1000.0;
-            }
-            stream << "file '" << frameFiles[i].replace("\\", "/") << "'\n";
-            stream << "duration " << duration << "\n";
-        }
-        // Add last frame again (FFmpeg concat requirement)
-        stream << "file '" << frameFiles.last().replace("\\", "/") << "'\n";
-        concatFile.close();
-    }
-
-    m_statusLabel->setText("Encodage video...");
-    QApplication::processEvents();
-
-    // Build FFmpeg command
-    QStringList ffmpegArgs;
-    ffmpegArgs << "-y";  // Overwrite
-    ffmpegArgs << "-f" << "concat";
-    ffmpegArgs << "-safe" << "0";
-    ffmpegArgs << "-i" << concatPath;
-
-    // If we have audio files, merge them
-    if (!audioFiles.isEmpty()) {
-        // Create audio concat file
-        QString audioConcatPath = tempDir.path() + "/audio_concat.txt";
-        QFile audioConcatFile(audioConcatPath);
-        if (audioConcatFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-            QTextStream stream(&audioConcatFile);
-            for (const QString& audioPath : audioFiles) {
-                QString path = audioPath;
-                path.replace("\\", "/");
-                stream << "file '" << path << "'\n";
-            }
-            audioConcatFile.close();
-        }
-
-        // First merge audio files
-        QString mergedAudioPath = tempDir.path() + "/merged_audio.mp3";
-        QProcess audioMerge;
-        QStringList audioMergeArgs;
-        audioMergeArgs << "-y" << "-f" << "concat" << "-safe" << "0";
-        audioMergeArgs << "-i" << audioConcatPath;
-        audioMergeArgs << "-c" << "copy" << mergedAudioPath;
-
-        audioMerge.start(ffmpegPath, audioMergeArgs);
-        audioMerge.waitForFinished(60000);
-
-        if (QFile::exists(mergedAudioPath)) {
-            ffmpegArgs << "-i" << mergedAudioPath;
-            ffmpegArgs << "-c:a" << "aac" << "-b:a" << "192k";
-        }
+    if (m_videoExporter->start(exportSlides, filePath)) {
+        m_videoBtn->setText("Annuler export");
+        m_statusLabel->setText("Export video en cours...");
     }
+}
 
-    ffmpegArgs << "-c:v" << "libx264";
-    ffmpegArgs << "-pix_fmt" << "yuv420p";
-    ffmpegArgs << "-preset" << "medium";
-    ffmpegArgs << "-crf" << "23";
-    ffmpegArgs << "-shortest";
-    ffmpegArgs << filePath;
+void SlideshowDialog::onExportProgress(int percent, const QString& step) {
+    m_videoBtn->setText(QString("Annuler (%1%)").arg(percent));
+    m_statusLabel->setText(step);
+}
 
-    // Run FFmpeg
-    QProcess ffmpeg;
-    ffmpeg.start(ffmpegPath, ffmpegArgs);
+void SlideshowDialog::onExportFinished(const QString& filePath, int slideCount, double durationSec) {
+    m_videoBtn->setText("Exporter Video");
 
-    // Wait with timeout (max 5 minutes)
-    if (!ffmpeg.waitForFinished(300000)) {
-        ffmpeg.kill();
-        m_videoBtn->setEnabled(true);
-        m_videoBtn->setText("Exporter Video");
-        QMessageBox::critical(this, "Erreur", "L'export video a depasse le delai maximum.");
-        return;
-    }
+    QFileInfo fi(filePath);
+    m_statusLabel->setText(QString("Video exportee: %1").arg(fi.fileName()));
+    QMessageBox::information(this, "Export reussi",
+        QString("Video exportee avec succes!\n\n"
+                "Fichier: %1\n"
+                "Taille: %2 MB\n"
+                "Duree: ~%3 secondes\n"
+                "Images: %4")
+        .arg(filePath)
+        .arg(fi.size() / (1024.0 * 1024.0), 0, 'f', 2)
+        .arg(durationSec, 0, 'f', 1)
+        .arg(slideCount));
+}
 
-    m_videoBtn->setEnabled(true);
+void SlideshowDialog::onExportFailed(const QString& error) {
     m_videoBtn->setText("Exporter Video");
-
-    if (ffmpeg.exitCode() == 0 && QFile::exists(filePath)) {
-        QFileInfo fi(filePath);
-        m_statusLabel->setText(QString("Video exportee: %1").arg(fi.fileName()));
-        QMessageBox::information(this, "Export reussi",
-            QString("Video exportee avec succes!\n\n"
-                    "Fichier: %1\n"
-                    "Taille: %2 MB\n"
-                    "Duree: ~%3 secondes\n"
-                    "Images: %4")
-            .arg(filePath)
-            .arg(fi.size() / (1024.0 * 1024.0), 0, 'f', 2)
-            .arg(totalDuration, 0, 'f', 1)
-            .arg(frameFiles.size()));
-
-        LOG_INFO(QString("Video exported: %1 (%2 frames, %3 sec)")
-                 .arg(filePath).arg(frameFiles.size()).arg(totalDuration));
-    } else {
-        QString errorOutput = ffmpeg.readAllStandardError();
-        m_statusLabel->setText("Erreur export video");
-        QMessageBox::critical(this, "Erreur FFmpeg",
-            QString("L'export video a echoue.\n\nErreur: %1").arg(errorOutput.left(500)));
-        LOG_ERROR(QString("FFmpeg failed: %1").arg(errorOutput));
-    }
+    m_statusLabel->setText("Erreur export video");
+    QMessageBox::critical(this, "Erreur FFmpeg", error);
 }
 
 } // namespace codex::ui
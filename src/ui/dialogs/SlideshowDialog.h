@@ -21,6 +21,7 @@ class VeoClient;
 
 namespace codex::core {
 class PipelineController;
+class VideoExporter;
 }
 
 namespace codex::ui {
@@ -66,6 +67,8 @@ public:
 
 signals:
     void generationCompleted();
+    // Slide on screen, plate jobs for the following panels go first
+    void slideShown(int index);
 
 protected:
     void keyPressEvent(QKeyEvent* event) override;
@@ -91,7 +94,10 @@ private slots:
     void onVideoGenerated(const QByteArray& videoData, const QString& prompt);
     void onVideoProgress(int percent);
     void onVideoError(const QString& error);
-    void onExportVideo();  // Export slideshow as MP4 using FFmpeg
+    void onExportVideo();  // Export slideshow as MP4 using FFmpeg (or cancel the running export)
+    void onExportProgress(int percent, const QString& step);
+    void onExportFinished(const QString& filePath, int slideCount, double durationSec);
+    void onExportFailed(const QString& error);
 
     void onSlideTimerTimeout();
     void onAudioPositionChanged(qint64 position);
@@ -167,6 +173,7 @@ private:
     // Controllers
     codex::api::EdgeTTSClient* m_ttsClient = nullptr;
     codex::api::VeoClient* m_veoClient = nullptr;
+    codex::core::VideoExporter* m_videoExporter = nullptr;
 
     // Audio
     QMediaPlayer* m_audioPlayer = nullptr;
@@ -180,6 +187,7 @@ private:
     QVector<int> m_videoQueue;          // Slides to generate videos for
     int m_currentVideoSlide = -1;       // Currently generating slide
     bool m_generatingAllVideos = false; // Batch generation mode
+    QString m_requestSession;           // RequestQueue session of the video requests
     int m_videosGenerated = 0;          // Count for progress
 };
 
@@ -1,7 +1,16 @@
 #include "InfoDockWidget.h"
+#include "core/services/TextParser.h"
 
 #include <QVBoxLayout>
+#include <QHBoxLayout>
 #include <QLabel>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QRegularExpression>
+#include <algorithm>
+#include <numeric>
 
 namespace codex::ui {
 
@@ -40,6 +49,12 @@ void InfoDockWidget::setupUi() {
     m_tipsBrowser->setHtml(getTipsInfo());
     m_tabWidget->addTab(m_tipsBrowser, "Conseils");
 
+    // Full-text search tab (corpus index)
+    m_tabWidget->addTab(createSearchTab(), "Recherche");
+
+    // Entities tab (corpus index)
+    m_tabWidget->addTab(createEntityTab(), "Entites");
+
     layout->addWidget(m_tabWidget);
     setWidget(container);
 
@@ -48,6 +63,205 @@ void InfoDockWidget::setupUi() {
     setMinimumHeight(200);
 }
 
+QWidget* InfoDockWidget::createSearchTab() {
+    auto* tab = new QWidget(m_tabWidget);
+    auto* layout = new QVBoxLayout(tab);
+    layout->setContentsMargins(0, 5, 0, 0);
+
+    auto* queryLayout = new QHBoxLayout();
+    m_searchQuery = new QLineEdit(tab);
+    m_searchQuery->setPlaceholderText("Mots, \"phrase exacte\" ou \"mots proches\"~10");
+    m_searchQuery->setClearButtonEnabled(true);
+    m_searchQuery->setToolTip("Accents et majuscules indifferents. Tous les mots doivent etre presents.\n"
+                              "\"premier homme\" : phrase exacte\n"
+                              "\"sophia lumiere\"~10 : a 10 mots au plus l'un de l'autre");
+    queryLayout->addWidget(m_searchQuery, 1);
+
+    auto* searchButton = new QPushButton("Chercher", tab);
+    queryLayout->addWidget(searchButton);
+    layout->addLayout(queryLayout);
+
+    m_searchStatus = new QLabel(tab);
+    m_searchStatus->setStyleSheet("color: #888;");
+    layout->addWidget(m_searchStatus);
+
+    m_searchResults = new QListWidget(tab);
+    m_searchResults->setWordWrap(true);
+    m_searchResults->setToolTip("Double-cliquez pour ouvrir le passage");
+    layout->addWidget(m_searchResults, 1);
+
+    connect(m_searchQuery, &QLineEdit::returnPressed, this, &InfoDockWidget::runTextSearch);
+    connect(searchButton, &QPushButton::clicked, this, &InfoDockWidget::runTextSearch);
+    connect(m_searchResults, &QListWidget::itemDoubleClicked, this, &InfoDockWidget::onPassageResultActivated);
+
+    return tab;
+}
+
+QWidget* InfoDockWidget::createEntityTab() {
+    auto* tab = new QWidget(m_tabWidget);
+    auto* layout = new QVBoxLayout(tab);
+    layout->setContentsMargins(0, 5, 0, 0);
+
+    m_entitySummary = new QTextBrowser(tab);
+    layout->addWidget(m_entitySummary, 1);
+
+    // Proximity query: "Sophia Yaldabaoth" within N characters
+    auto* queryLayout = new QHBoxLayout();
+    m_entityQuery = new QLineEdit(tab);
+    m_entityQuery->setPlaceholderText("Entites proches (ex: Sophia Yaldabaoth)");
+    m_entityQuery->setClearButtonEnabled(true);
+    queryLayout->addWidget(m_entityQuery, 1);
+
+    m_entityDistance = new QSpinBox(tab);
+    m_entityDistance->setRange(20, 5000);
+    m_entityDistance->setSingleStep(50);
+    m_entityDistance->setValue(200);
+    m_entityDistance->setSuffix(" car.");
+    m_entityDistance->setToolTip("Distance maximale entre les entites");
+    queryLayout->addWidget(m_entityDistance);
+
+    auto* searchButton = new QPushButton("Chercher", tab);
+    queryLayout->addWidget(searchButton);
+    layout->addLayout(queryLayout);
+
+    m_entityResults = new QListWidget(tab);
+    m_entityResults->setWordWrap(true);
+    m_entityResults->setToolTip("Double-cliquez pour ouvrir le passage");
+    layout->addWidget(m_entityResults, 2);
+
+    connect(m_entityQuery, &QLineEdit::returnPressed, this, &InfoDockWidget::searchEntityPassages);
+    connect(searchButton, &QPushButton::clicked, this, &InfoDockWidget::searchEntityPassages);
+    connect(m_entityResults, &QListWidget::itemDoubleClicked, this, &InfoDockWidget::onPassageResultActivated);
+
+    refreshEntitySummary();
+    return tab;
+}
+
+void InfoDockWidget::setTextParser(const codex::core::TextParser* parser) {
+    m_parser = parser;
+    m_entityResults->clear();
+    m_searchResults->clear();
+    m_searchStatus->clear();
+    refreshEntitySummary();
+}
+
+void InfoDockWidget::runTextSearch() {
+    m_searchResults->clear();
+    m_searchStatus->clear();
+    if (!m_parser || m_parser->searchIndex().isEmpty()) {
+        m_searchStatus->setText("Chargez un Codex pour lancer une recherche.");
+        return;
+    }
+
+    const QString query = m_searchQuery->text().trimmed();
+    if (query.isEmpty()) return;
+
+    const QVector<codex::core::SearchResult> results = m_parser->search(query);
+    for (const codex::core::SearchResult& result : results) {
+        // Same [page:verse] reference as the text viewer
+        auto* item = new QListWidgetItem(QString("%1 [%2:%3]  (%4)\n%5")
+                                         .arg(result.code)
+                                         .arg(result.manuscriptPage).arg(result.verse)
+                                         .arg(result.score, 0, 'f', 1)
+                                         .arg(result.passage.simplified().left(240)));
+        item->setData(Qt::UserRole, result.code);
+        item->setData(Qt::UserRole + 1, result.passage);
+        item->setData(Qt::UserRole + 2, qlonglong(result.start));
+        item->setData(Qt::UserRole + 3, qlonglong(result.end));
+        m_searchResults->addItem(item);
+    }
+
+    m_searchStatus->setText(results.isEmpty() ? QString("Aucun resultat")
+                                              : QString("%1 page(s), meilleur score d'abord").arg(results.size()));
+}
+
+void InfoDockWidget::refreshEntitySummary() {
+    if (!m_parser || m_parser->entityIndex().isEmpty()) {
+        m_entitySummary->setHtml("<p style='color: #888;'>Chargez un Codex pour indexer les entites.</p>");
+        return;
+    }
+
+    const codex::core::EntityIndex& index = m_parser->entityIndex();
+
+    // Most frequent entities first
+    QVector<int> entities(index.entityCount());
+    std::iota(entities.begin(), entities.end(), 0);
+    std::sort(entities.begin(), entities.end(), [&index](int a, int b) {
+        return index.occurrenceCount(a) > index.occurrenceCount(b);
+    });
+
+    QString html = "<table width='100%' cellspacing='0' cellpadding='4'>"
+                   "<tr><th align='left'>Entite</th><th>Occurrences</th><th>Traites</th>"
+                   "<th align='left'>Plus frequent dans</th></tr>";
+    for (int entity : entities) {
+        const QVector<int> treatises = index.treatisesMentioning({entity});
+        int topTreatise = -1;
+        for (int treatise : treatises) {
+            if (topTreatise < 0 || index.occurrenceCount(entity, treatise) > index.occurrenceCount(entity, topTreatise)) {
+                topTreatise = treatise;
+            }
+        }
+
+        html += QString("<tr><td>%1</td><td align='center'>%2</td><td align='center'>%3</td><td>%4</td></tr>")
+                .arg(index.entityName(entity).toHtmlEscaped())
+                .arg(index.occurrenceCount(entity))
+                .arg(treatises.size())
+                .arg(topTreatise < 0 ? QString("-")
+                     : QString("%1 (%2)").arg(index.treatiseCode(topTreatise))
+                                         .arg(index.occurrenceCount(entity, topTreatise)));
+    }
+    html += "</table>";
+
+    m_entitySummary->setHtml(html);
+}
+
+void InfoDockWidget::searchEntityPassages() {
+    m_entityResults->clear();
+    if (!m_parser) return;
+
+    // Each term is an entity name or one of its keywords
+    QVector<int> entities;
+    const QStringList terms = m_entityQuery->text().split(QRegularExpression("[\\s,+]+"), Qt::SkipEmptyParts);
+    for (const QString& term : terms) {
+        const int entity = m_parser->resolveEntity(term);
+        if (entity < 0) {
+            m_entityResults->addItem(QString("Entite inconnue: %1").arg(term));
+            return;
+        }
+        entities.append(entity);
+    }
+    if (entities.isEmpty()) return;
+
+    const codex::core::EntityIndex& index = m_parser->entityIndex();
+    const QVector<codex::core::EntityPassage> passages = index.findNear(entities, m_entityDistance->value());
+
+    for (const codex::core::EntityPassage& passage : passages) {
+        const QString code = index.treatiseCode(passage.treatise);
+        const QString text = m_parser->passageText(passage);
+
+        auto* item = new QListWidgetItem(QString("%1, page %2\n%3").arg(code).arg(passage.page)
+                                         .arg(text.simplified().left(240)));
+        item->setData(Qt::UserRole, code);
+        item->setData(Qt::UserRole + 1, text);
+        item->setData(Qt::UserRole + 2, qlonglong(passage.start));
+        item->setData(Qt::UserRole + 3, qlonglong(passage.end));
+        m_entityResults->addItem(item);
+    }
+
+    if (passages.isEmpty()) {
+        m_entityResults->addItem("Aucun passage trouve");
+    }
+}
+
+void InfoDockWidget::onPassageResultActivated(QListWidgetItem* item) {
+    const QString code = item->data(Qt::UserRole).toString();
+    if (!code.isEmpty()) {
+        emit passageRequested(code, item->data(Qt::UserRole + 1).toString(),
+                              item->data(Qt::UserRole + 2).toLongLong(),
+                              item->data(Qt::UserRole + 3).toLongLong());
+    }
+}
+
 QString InfoDockWidget::getVertexAIPricing() const {
     return R"(
 <html>
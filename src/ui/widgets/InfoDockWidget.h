@@ -4,6 +4,16 @@
 #include <QTextBrowser>
 #include <QTabWidget>
 
+class QLabel;
+class QLineEdit;
+class QListWidget;
+class QListWidgetItem;
+class QSpinBox;
+
+namespace codex::core {
+class TextParser;
+}
+
 namespace codex::ui {
 
 class InfoDockWidget : public QDockWidget {
@@ -12,8 +22,21 @@ class InfoDockWidget : public QDockWidget {
 public:
     explicit InfoDockWidget(QWidget* parent = nullptr);
 
+    // Parser whose indexes feed the "Recherche" and "Entites" tabs (refresh after each load)
+    void setTextParser(const codex::core::TextParser* parser);
+
+signals:
+    // start/end: raw-content range of the passage, passage: its text as a fallback
+    void passageRequested(const QString& treatiseCode, const QString& passage, qsizetype start, qsizetype end);
+
 private:
     void setupUi();
+    QWidget* createSearchTab();
+    QWidget* createEntityTab();
+    void runTextSearch();
+    void refreshEntitySummary();
+    void searchEntityPassages();
+    void onPassageResultActivated(QListWidgetItem* item);
     QString getVertexAIPricing() const;
     QString getAIStudioPricing() const;
     QString getQuotasInfo() const;
@@ -23,6 +46,19 @@ private:
     QTextBrowser* m_pricingBrowser;
     QTextBrowser* m_quotasBrowser;
     QTextBrowser* m_tipsBrowser;
+
+    const codex::core::TextParser* m_parser = nullptr;
+
+    // Full-text search tab
+    QLineEdit* m_searchQuery = nullptr;
+    QLabel* m_searchStatus = nullptr;
+    QListWidget* m_searchResults = nullptr;
+
+    // Entity index tab
+    QTextBrowser* m_entitySummary = nullptr;
+    QLineEdit* m_entityQuery = nullptr;
+    QSpinBox* m_entityDistance = nullptr;
+    QListWidget* m_entityResults = nullptr;
 };
 
 } // namespace codex::ui
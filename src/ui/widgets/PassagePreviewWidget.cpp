@@ -140,17 +140,20 @@ void PassagePreviewWidget::setTreatiseCode(const QString& code) {
     m_treatiseCode = code;
 }
 
-void PassagePreviewWidget::setPassage(const QString& text, int startPos, int endPos) {
+void PassagePreviewWidget::setPassage(const QString& text, int startPos, int endPos,
+                                      const QString& cleanedText) {
     m_passage = text;
     m_startPos = startPos;
     m_endPos = endPos;
 
     // Clean the text for display (same as narration)
-    codex::core::NarrationCleaner cleaner;
-    QString cleanedText = cleaner.clean(text);
+    QString displayText = cleanedText;
+    if (displayText.isEmpty()) {
+        codex::core::NarrationCleaner cleaner;
+        displayText = cleaner.clean(text);
+    }
 
     // Display passage (truncate if very long for preview)
-    QString displayText = cleanedText;
     if (displayText.length() > 500) {
         displayText = displayText.left(500) + "...";
     }
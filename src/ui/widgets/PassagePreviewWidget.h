@@ -14,8 +14,8 @@ class PassagePreviewWidget : public QWidget {
 public:
     explicit PassagePreviewWidget(QWidget* parent = nullptr);
 
-    // Set the selected passage
-    void setPassage(const QString& text, int startPos, int endPos);
+    // Set the selected passage; cleanedText is its narration text when already known
+    void setPassage(const QString& text, int startPos, int endPos, const QString& cleanedText = QString());
 
     // Set current treatise code (for favorites)
     void setTreatiseCode(const QString& code);
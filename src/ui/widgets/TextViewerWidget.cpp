@@ -13,6 +13,8 @@
 #include <QPaintEvent>
 #include <QPalette>
 
+#include <algorithm>
+
 namespace codex::ui {
 
 // ============================================================================
@@ -139,34 +141,86 @@ void TextViewerWidget::loadFile(const QString& filePath) {
     QString content = in.readAll();
     file.close();
 
-    m_textEdit->setPlainText(content);
+    setText(content);
     LOG_INFO(QString("Loaded file: %1 (%2 chars)").arg(filePath).arg(content.length()));
 }
 
 void TextViewerWidget::setText(const QString& text) {
+    m_segments.clear();
+    m_sourceOffsets.clear();
     m_textEdit->setPlainText(text);
 }
 
+codex::core::NarrationCleaner TextViewerWidget::cleaner() {
+    codex::core::NarrationCleaner cleaner;
+    cleaner.setRemovePipes(false);  // Keep pipes for page splitting
+    return cleaner;
+}
+
 void TextViewerWidget::setTextWithVerses(const QString& text, int startPage) {
+    // Clean the text first (remove annotations, notes, etc.)
+    showVerses(cleaner().clean(text), {}, startPage);
+}
+
+void TextViewerWidget::setCleanTextWithVerses(const QString& header, const codex::core::NarrationText& text,
+                                              int startPage) {
+    // The header has no source: it maps to the start of the treatise
+    const QString cleanedHeader = cleaner().clean(header);
+    const qsizetype origin = text.sourceOffsets.isEmpty() ? 0 : text.sourceOffsets.first();
+
+    QVector<qsizetype> sourceOffsets(cleanedHeader.size() + 2, origin);
+    sourceOffsets += text.sourceOffsets;
+    showVerses(cleanedHeader + "\n\n" + text.text, sourceOffsets, startPage);
+}
+
+void TextViewerWidget::showVerses(const QString& cleanedText, const QVector<qsizetype>& sourceOffsets,
+                                  int startPage) {
     // Format text with Page:Paragraph verse numbers
     // Page markers in text: "|" indicates manuscript page change
     // Paragraphs are separated by double newlines or indentation
-
-    // Clean the text first (remove annotations, notes, etc.)
-    codex::core::NarrationCleaner cleaner;
-    cleaner.setRemovePipes(false);  // Keep pipes for page splitting
-    QString cleanedText = cleaner.clean(text);
+    static const QRegularExpression pageBreak(R"(\s*\|\s*)");
+    static const QRegularExpression paragraphBreak(R"(\n\s*\n)");
+
+    // Same pieces as QString::split(), as trimmed ranges of cleanedText
+    auto split = [&cleanedText](qsizetype begin, qsizetype end, const QRegularExpression& separator) {
+        QVector<QPair<qsizetype, qsizetype>> pieces;
+        auto addPiece = [&](qsizetype from, qsizetype to) {
+            while (from < to && cleanedText[from].isSpace()) ++from;
+            while (to > from && cleanedText[to - 1].isSpace()) --to;
+            pieces.append({from, to});
+        };
+
+        QRegularExpressionMatchIterator it =
+            separator.globalMatchView(QStringView(cleanedText).mid(begin, end - begin));
+        qsizetype last = begin;
+        while (it.hasNext()) {
+            const QRegularExpressionMatch match = it.next();
+            addPiece(last, begin + match.capturedStart());
+            last = begin + match.capturedEnd();
+        }
+        addPiece(last, end);
+        return pieces;
+    };
 
     QString formatted;
+    m_segments.clear();
+    m_sourceOffsets = sourceOffsets;
+
+    auto appendParagraph = [&](qsizetype from, qsizetype to) {
+        m_segments.append({int(formatted.size()), from, to - from});
+        formatted += QStringView(cleanedText).mid(from, to - from);
+        formatted += "\n\n";
+    };
+
     int currentPage = startPage;
     int paragraphNum = 1;
 
     // Split by page markers first (| character)
-    QStringList pages = cleanedText.split(QRegularExpression(R"(\s*\|\s*)"));
+    const auto pages = split(0, cleanedText.size(), pageBreak);
 
     for (int pageIdx = 0; pageIdx < pages.size(); ++pageIdx) {
-        QString pageContent = pages[pageIdx].trimmed();
-        if (pageContent.isEmpty()) continue;
+        const auto [pageStart, pageEnd] = pages[pageIdx];
+        if (pageStart == pageEnd) continue;
 
         // Add page header
         if (pageIdx > 0) {
@@ -176,21 +230,20 @@ void TextViewerWidget::setTextWithVerses(const QString& text, int startPage) {
         }
 
         // Split into paragraphs (double newline or significant indentation)
-        QStringList paragraphs = pageContent.split(QRegularExpression(R"(\n\s*\n)"));
-
-        for (const QString& para : paragraphs) {
-            QString trimmedPara = para.trimmed();
-            if (trimmedPara.isEmpty()) continue;
+        for (const auto& [paraStart, paraEnd] : split(pageStart, pageEnd, paragraphBreak)) {
+            if (paraStart == paraEnd) continue;
 
             // Skip footnotes and annotations (lines starting with *)
-            if (trimmedPara.startsWith("*") || trimmedPara.startsWith("†")) {
-                formatted += QString("    %1\n\n").arg(trimmedPara);
+            const QChar first = cleanedText[paraStart];
+            if (first == u'*' || first == u'†') {
+                formatted += "    ";
+                appendParagraph(paraStart, paraEnd);
                 continue;
             }
 
             // Add verse number
-            QString verseRef = QString("[%1:%2] ").arg(currentPage).arg(paragraphNum);
-            formatted += verseRef + trimmedPara + "\n\n";
+            formatted += QString("[%1:%2] ").arg(currentPage).arg(paragraphNum);
+            appendParagraph(paraStart, paraEnd);
             paragraphNum++;
         }
     }
@@ -199,6 +252,52 @@ void TextViewerWidget::setTextWithVerses(const QString& text, int startPage) {
     LOG_INFO(QString("Formatted text with verses starting at page %1").arg(startPage));
 }
 
+QPair<qsizetype, qsizetype> TextViewerWidget::sourceRange(int start, int end) const {
+    if (m_sourceOffsets.isEmpty() || end <= start) return {-1, -1};
+
+    // First paragraph ending after start, last one starting before end
+    auto first = std::upper_bound(m_segments.cbegin(), m_segments.cend(), start,
+                                  [](int pos, const Segment& s) { return pos < s.view + s.length; });
+    auto last = std::lower_bound(m_segments.cbegin(), m_segments.cend(), end,
+                                 [](const Segment& s, int pos) { return s.view < pos; });
+    if (first == m_segments.cend() || last == m_segments.cbegin() || first >= last) return {-1, -1};
+    --last;
+
+    const qsizetype textStart = first->text + qMax(0, start - first->view);
+    const qsizetype textEnd = last->text + qMin(qsizetype(end - last->view), last->length);
+    if (textEnd <= textStart || textEnd > m_sourceOffsets.size()) return {-1, -1};
+
+    return {m_sourceOffsets[textStart], m_sourceOffsets[textEnd - 1] + 1};
+}
+
+QPair<int, int> TextViewerWidget::viewRange(qsizetype sourceStart, qsizetype sourceEnd) const {
+    if (m_sourceOffsets.isEmpty() || sourceEnd <= sourceStart) return {-1, -1};
+
+    // Source offsets grow with the cleaned text. The header repeats the first
+    // offset of the treatise: take the last character copied from sourceStart,
+    // or the first one after it when the cleaner removed it
+    auto from = std::upper_bound(m_sourceOffsets.cbegin(), m_sourceOffsets.cend(), sourceStart);
+    if (from != m_sourceOffsets.cbegin() && *(from - 1) == sourceStart) --from;
+    const auto to = std::lower_bound(m_sourceOffsets.cbegin(), m_sourceOffsets.cend(), sourceEnd);
+    const qsizetype textStart = from - m_sourceOffsets.cbegin();
+    const qsizetype textEnd = to - m_sourceOffsets.cbegin();
+    if (textEnd <= textStart) return {-1, -1};
+
+    // First paragraph ending after textStart, last one starting before textEnd
+    auto first = std::upper_bound(m_segments.cbegin(), m_segments.cend(), textStart,
+                                  [](qsizetype pos, const Segment& s) { return pos < s.text + s.length; });
+    auto last = std::lower_bound(m_segments.cbegin(), m_segments.cend(), textEnd,
+                                 [](const Segment& s, qsizetype pos) { return s.text < pos; });
+    if (first == m_segments.cend() || last == m_segments.cbegin() || first >= last) return {-1, -1};
+    --last;
+
+    const int viewStart = first->view + int(qMax(qsizetype(0), textStart - first->text));
+    const int viewEnd = last->view + int(qMin(textEnd - last->text, last->length));
+    if (viewEnd <= viewStart) return {-1, -1};
+
+    return {viewStart, viewEnd};
+}
+
 QString TextViewerWidget::selectedText() const {
     return m_textEdit->textCursor().selectedText();
 }
@@ -224,4 +323,48 @@ void TextViewerWidget::selectRange(int start, int end) {
     m_textEdit->ensureCursorVisible();
 }
 
+bool TextViewerWidget::selectSourceRange(qsizetype sourceStart, qsizetype sourceEnd) {
+    const auto [start, end] = viewRange(sourceStart, sourceEnd);
+    if (start < 0) return false;
+
+    selectRange(start, end);
+    return true;
+}
+
+bool TextViewerWidget::selectPassage(const QString& passage) {
+    // The view is cleaned and numbered: match the passage words while skipping
+    // punctuation, verse references and line breaks between them. Words may also
+    // be glued together, since the cleaner repairs "V erite" and "Sau-\nveur"
+    static const QRegularExpression wordRegex(R"(\p{L}+)");
+    QStringList words;
+    QRegularExpressionMatchIterator it = wordRegex.globalMatch(passage);
+    while (it.hasNext()) {
+        words.append(QRegularExpression::escape(it.next().captured()));
+    }
+    if (words.isEmpty()) return false;
+
+    constexpr int ANCHOR_WORDS = 6;
+    const QString separator = R"([^\p{L}]*)";
+    const QString plainText = m_textEdit->toPlainText();
+
+    QRegularExpression head(words.mid(0, ANCHOR_WORDS).join(separator));
+    QRegularExpressionMatch headMatch = head.match(plainText);
+    if (!headMatch.hasMatch()) return false;
+
+    int start = headMatch.capturedStart();
+    int end = headMatch.capturedEnd();
+
+    if (words.size() > ANCHOR_WORDS) {
+        QRegularExpression tail(words.mid(words.size() - ANCHOR_WORDS).join(separator));
+        QRegularExpressionMatch tailMatch = tail.match(plainText, end);
+        // Verse numbers and removed notes make the view a bit longer, not twice as long
+        if (tailMatch.hasMatch() && tailMatch.capturedEnd() - start <= 2 * passage.size()) {
+            end = tailMatch.capturedEnd();
+        }
+    }
+
+    selectRange(start, end);
+    return true;
+}
+
 } // namespace codex::ui
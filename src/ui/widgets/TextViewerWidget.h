@@ -1,8 +1,12 @@
 #pragma once
 
+#include "core/services/NarrationCache.h"
+
 #include <QWidget>
 #include <QPlainTextEdit>
 #include <QPainter>
+#include <QPair>
+#include <QVector>
 
 namespace codex::ui {
 
@@ -32,9 +36,30 @@ public:
     void loadFile(const QString& filePath);
     void setText(const QString& text);
     void setTextWithVerses(const QString& text, int startPage);
+
+    // Show a treatise already cleaned with cleaner() and keep its source offsets
+    void setCleanTextWithVerses(const QString& header, const codex::core::NarrationText& text, int startPage);
+
+    // False for text shown without a narration cache
+    bool hasSourceOffsets() const { return !m_sourceOffsets.isEmpty(); }
+
+    // Raw-content range of a selection in the formatted view; {-1, -1} without source offsets
+    QPair<qsizetype, qsizetype> sourceRange(int start, int end) const;
+
+    // The reverse: range of the formatted view showing a raw-content range, {-1, -1} if not shown
+    QPair<int, int> viewRange(qsizetype sourceStart, qsizetype sourceEnd) const;
+
+    // Cleaning rules of the view (pipes kept for page splitting)
+    static codex::core::NarrationCleaner cleaner();
     QString selectedText() const;
     void selectRange(int start, int end);
 
+    // Select a raw-content range in the formatted view; false if not shown
+    bool selectSourceRange(qsizetype sourceStart, qsizetype sourceEnd);
+
+    // Select a passage of the source text in the formatted view; false if not found
+    bool selectPassage(const QString& passage);
+
     // Update alternating colors from theme
     void updateColors();
 
@@ -46,7 +71,18 @@ private slots:
     void onThemeChanged();
 
 private:
+    // Paragraph of the cleaned text copied into the formatted view
+    struct Segment {
+        int view = 0;               // Start in the formatted view
+        qsizetype text = 0;         // Start in the cleaned text
+        qsizetype length = 0;
+    };
+
+    void showVerses(const QString& cleanedText, const QVector<qsizetype>& sourceOffsets, int startPage);
+
     AlternatingTextEdit* m_textEdit;
+    QVector<Segment> m_segments;
+    QVector<qsizetype> m_sourceOffsets;     // Raw-content offset of each cleaned character
 };
 
 } // namespace codex::ui
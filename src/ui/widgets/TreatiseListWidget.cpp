@@ -7,6 +7,8 @@
 #include <QHeaderView>
 #include <QLabel>
 #include <QFrame>
+#include <QRegularExpression>
+#include <QHash>
 
 namespace codex::ui {
 
@@ -30,7 +32,7 @@ void TreatiseListWidget::setupUi() {
 
     // Search field
     m_searchEdit = new QLineEdit(this);
-    m_searchEdit->setPlaceholderText("Rechercher un traite...");
+    m_searchEdit->setPlaceholderText("Rechercher un traite ou une entite...");
     m_searchEdit->setClearButtonEnabled(true);
     m_searchEdit->setStyleSheet(R"(
         QLineEdit {
@@ -200,6 +202,31 @@ void TreatiseListWidget::onSearchTextChanged(const QString& text) {
 void TreatiseListWidget::applyFilter(const QString& filter) {
     QString lowerFilter = filter.toLower();
 
+    // "sophia yaldabaoth": treatises mentioning every entity, from the corpus index
+    QVector<int> entities;
+    QHash<QString, QString> entityCounts;   // code -> tooltip
+    if (m_parser && !filter.trimmed().isEmpty()) {
+        const QStringList terms = filter.split(QRegularExpression("[\\s,+]+"), Qt::SkipEmptyParts);
+        for (const QString& term : terms) {
+            const int entity = m_parser->resolveEntity(term);
+            if (entity < 0) {
+                entities.clear();
+                break;
+            }
+            entities.append(entity);
+        }
+
+        const codex::core::EntityIndex& index = m_parser->entityIndex();
+        for (int treatise : index.treatisesMentioning(entities)) {
+            QStringList counts;
+            for (int entity : entities) {
+                counts.append(QString("%1: %2").arg(index.entityName(entity))
+                              .arg(index.occurrenceCount(entity, treatise)));
+            }
+            entityCounts.insert(index.treatiseCode(treatise), counts.join(", "));
+        }
+    }
+
     for (auto it = m_codexItems.begin(); it != m_codexItems.end(); ++it) {
         QTreeWidgetItem* codexItem = it.value();
         bool hasVisibleChild = false;
@@ -209,10 +236,14 @@ void TreatiseListWidget::applyFilter(const QString& filter) {
             QString code = child->text(0).toLower();
             QString title = child->text(1).toLower();
 
+            const QString entityCount = entityCounts.value(child->data(0, Qt::UserRole).toString());
+
             bool matches = filter.isEmpty() ||
                            code.contains(lowerFilter) ||
-                           title.contains(lowerFilter);
+                           title.contains(lowerFilter) ||
+                           !entityCount.isEmpty();
 
+            child->setToolTip(1, entityCount.isEmpty() ? child->text(1) : entityCount);
             child->setHidden(!matches);
             if (matches) hasVisibleChild = true;
         }
@@ -31,6 +31,9 @@ public:
     // Clear the list
     void clear();
 
+    // Parser whose entity index lets the search field filter by entity names
+    void setTextParser(const codex::core::TextParser* parser) { m_parser = parser; }
+
 signals:
     void treatiseSelected(const QString& code, const QString& title, const QString& category);
     void treatiseDoubleClicked(const QString& code, const QString& title, const QString& category);
@@ -52,6 +55,7 @@ private:
     QMap<QString, QTreeWidgetItem*> m_codexItems;  // Codex root items
     QVector<codex::core::TreatiseInfo> m_treatises;
     codex::core::MythicClassifier* m_classifier = nullptr;
+    const codex::core::TextParser* m_parser = nullptr;
 };
 
 } // namespace codex::ui
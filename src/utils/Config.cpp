@@ -7,6 +7,22 @@
 
 namespace codex::utils {
 
+namespace {
+
+// Limits of the model family when config.json has no entry for the key,
+// lowered further at runtime whenever the provider answers 429
+QJsonObject defaultQuota(const QString& key) {
+    if (key.contains("veo")) {
+        return {{"requests_per_minute", 2}, {"burst", 1}};
+    }
+    if (key.contains("imagen")) {
+        return {{"requests_per_minute", 20}, {"burst", 4}};
+    }
+    return {{"requests_per_minute", 60}, {"burst", 4}};
+}
+
+} // namespace
+
 Config& Config::instance() {
     static Config instance;
     return instance;
@@ -61,6 +77,17 @@ bool Config::load() {
                     {"service_account_path", ""}
                 }}
             }},
+            {"generation", QJsonObject{
+                {"plate_max_in_flight", 3},
+                {"plate_batch_enrichment", true}
+            }},
+            {"quotas", QJsonObject{
+                {"max_retries", 5}
+            }},
+            {"cache", QJsonObject{
+                {"enabled", true},
+                {"max_mb", 1024}
+            }},
             {"paths", QJsonObject{
                 {"codex_file", ""},
                 {"output_images", "./images"},
@@ -307,6 +334,74 @@ void Config::setVertexServiceAccountPath(const QString& path) {
     save();
 }
 
+// Generation settings
+
+int Config::plateMaxInFlight() const {
+    int count = m_config["generation"].toObject()["plate_max_in_flight"].toInt(3);
+    return qBound(1, count, 8);
+}
+
+void Config::setPlateMaxInFlight(int count) {
+    QJsonObject generation = m_config["generation"].toObject();
+    generation["plate_max_in_flight"] = qBound(1, count, 8);
+    m_config["generation"] = generation;
+    save();
+}
+
+bool Config::plateBatchEnrichment() const {
+    return m_config["generation"].toObject()["plate_batch_enrichment"].toBool(true);
+}
+
+void Config::setPlateBatchEnrichment(bool enabled) {
+    QJsonObject generation = m_config["generation"].toObject();
+    generation["plate_batch_enrichment"] = enabled;
+    m_config["generation"] = generation;
+    save();
+}
+
+// Rate limits
+
+QJsonObject Config::quota(const QString& key) const {
+    const QJsonValue entry = m_config["quotas"].toObject()[key];
+    return entry.isObject() ? entry.toObject() : defaultQuota(key);
+}
+
+int Config::quotaRequestsPerMinute(const QString& key) const {
+    return qBound(1, quota(key)["requests_per_minute"].toInt(60), 6000);
+}
+
+int Config::quotaBurst(const QString& key) const {
+    return qBound(1, quota(key)["burst"].toInt(1), 64);
+}
+
+int Config::quotaMaxRetries() const {
+    return qBound(0, m_config["quotas"].toObject()["max_retries"].toInt(5), 20);
+}
+
+// Response cache
+
+bool Config::responseCacheEnabled() const {
+    return m_config["cache"].toObject()["enabled"].toBool(true);
+}
+
+int Config::responseCacheMaxMb() const {
+    return qBound(16, m_config["cache"].toObject()["max_mb"].toInt(1024), 65536);
+}
+
+void Config::setResponseCacheEnabled(bool enabled) {
+    QJsonObject cache = m_config["cache"].toObject();
+    cache["enabled"] = enabled;
+    m_config["cache"] = cache;
+    save();
+}
+
+void Config::setResponseCacheMaxMb(int megabytes) {
+    QJsonObject cache = m_config["cache"].toObject();
+    cache["max_mb"] = qBound(16, megabytes, 65536);
+    m_config["cache"] = cache;
+    save();
+}
+
 // Session restore methods
 
 bool Config::rememberText() const {
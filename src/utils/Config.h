@@ -34,6 +34,21 @@ public:
     QString vertexRegion() const;
     QString vertexServiceAccountPath() const;
 
+    // Generation settings
+    int plateMaxInFlight() const;           // Concurrent pipeline runs for a plate
+    bool plateBatchEnrichment() const;      // One LLM request for all plate segments
+
+    // Rate limits per "provider/model" key ("aistudio/imagen-3.0-generate-001"),
+    // built-in limits of the model family when the key has no entry. Set in the
+    // "quotas" section of config.json: {"<key>": {"requests_per_minute", "burst"}}
+    int quotaRequestsPerMinute(const QString& key) const;
+    int quotaBurst(const QString& key) const;       // Requests that may leave at once
+    int quotaMaxRetries() const;                    // Retries on 429, 5xx and dropped connections
+
+    // Cache of generation responses on disk
+    bool responseCacheEnabled() const;
+    int responseCacheMaxMb() const;
+
     // Paths
     QString codexFilePath() const;
     QString outputImagesPath() const;
@@ -67,6 +82,10 @@ public:
     void setVertexProjectId(const QString& projectId);
     void setVertexRegion(const QString& region);
     void setVertexServiceAccountPath(const QString& path);
+    void setPlateMaxInFlight(int count);
+    void setPlateBatchEnrichment(bool enabled);
+    void setResponseCacheEnabled(bool enabled);
+    void setResponseCacheMaxMb(int megabytes);
 
 private:
     Config();
@@ -74,6 +93,7 @@ private:
     Config& operator=(const Config&) = delete;
 
     QString configFilePath() const;
+    QJsonObject quota(const QString& key) const;
 
     QJsonObject m_config;
     bool m_loaded = false;
@@ -0,0 +1,254 @@
+// Regression test: NarrationCleaner against the former sequential passes.
+//
+// Usage: test_narration_cleaner [files...]
+// Without files, runs on codex-nag-hammadi.md and texts_clean/*.md from the
+// source tree. Each file is cleaned whole and page by page; the fused and
+// hand-written passes must give the text of the former one-regex-per-rule
+// cleaner, clean() with offsets the same text with one increasing origin per
+// character, and NarrationStream fed in chunks the text of clean() on the
+// whole file. A few inputs where a removal creates a match for a later rule
+// are checked too. The exit code is non-zero on any mismatch.
+
+#include "core/services/NarrationCleaner.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QSet>
+#include <QTextStream>
+
+#include <algorithm>
+
+using namespace codex::core;
+
+namespace {
+
+// Same normalization as TextParser::normalizeContent()
+QString loadNormalized(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return {};
+
+    QString content = QString::fromUtf8(file.readAll());
+    if (content.startsWith(QChar(0xFEFF))) content.remove(0, 1);
+    content.replace("\r\n", "\n");
+    content.replace(u'\r', u'\n');
+    content.replace(QChar(0x2013), u'-');
+    content.replace(QChar(0x2014), u'-');
+    return content;
+}
+
+// Former NarrationCleaner::clean(), default settings: one regex per rule, in order
+QString legacyClean(const QString& text) {
+    using RE = QRegularExpression;
+    QString result = text;
+
+    // 1-2. Page headers, separators, pipes
+    result.remove(RE(R"(^##\s*Page\s*\d+\s*$)", RE::MultilineOption));
+    result.remove(RE(R"(^-{3,}$)", RE::MultilineOption));
+    result.replace(RE(R"(\s*\|\s*)"), " ");
+
+    // 3-6. Treatise titles, codex references, translator notes, lacunas
+    result.remove(RE(R"(^[A-ZÉÈÊËÀÂÄÔÖÛÜÙÏÎÇ'\s\-<>]+\s*\(NH\s+[IVX]+,?\s*\d+\)\s*$)", RE::MultilineOption));
+    result.remove(RE(R"(\s*\(NH\s+[IVX]+,?\s*\d+\))"));
+    result.remove(RE(R"(^(Traduction\s+de\s+[^\n]+|Traduit\s+par\s+[^\n]+)$)",
+                     RE::MultilineOption | RE::CaseInsensitiveOption));
+    result.remove(RE(R"(\(Lacune[^)]*\)|\(lacune[^)]*\)|\(Peut-être lacune[^)]*\))", RE::CaseInsensitiveOption));
+    result.remove(RE(R"(\[[\s.]+\])"));
+    result.replace(RE(R"(\.\s+\.\s+\.[\s.]*)"), "... ");
+    result.replace(RE(R"(\.{4,})"), "...");
+
+    // 7. Decorations, notes, symbol lines
+    result.remove(RE(R"(\(Décoration\s*:[^)]*\))"));
+    result.remove(RE(R"(\(Note\s*\*?\s*:?[^)]*\)|\*(?=\s|$))"));
+    result.remove(RE(R"(^[\s\+\*\#\-\=\†]+$)", RE::MultilineOption));
+
+    // 8-9. Brackets, chevrons
+    for (int i = 0; i < 3; ++i) {
+        QString newResult = result;
+        newResult.replace(RE(R"(\[([^\]]{1,60})\])"), "\\1");
+        if (newResult == result) break;
+        result = newResult;
+    }
+    result.replace(RE(R"(<([^<>]+)>)"), "\\1");
+
+    // 10. Line and verse numbers
+    result.remove(RE(R"(^\s*\d{1,3}\s*$)", RE::MultilineOption));
+    for (int i = 0; i < 3; ++i) {
+        QString newResult = result;
+        newResult.replace(RE(R"((\s)(\d{1,2})(\s)([A-Za-zÀ-ÿ«"]))"), "\\1\\4");
+        if (newResult == result) break;
+        result = newResult;
+    }
+    result.remove(RE(R"(\s+\d{1,2}\s*$)", RE::MultilineOption));
+
+    // 11. Broken words
+    result.replace(RE(R"(\b([A-ZÉÈÊËÀÂÄÔÖÛÜÙÏÎÇ])\s+([a-zéèêëàâäôöûüùïîç]))"), "\\1\\2");
+
+    // 12. Repeated upper-case titles
+    QStringList lines;
+    QSet<QString> seenTitles;
+    for (const QString& line : result.split(u'\n')) {
+        const QString stripped = line.trimmed();
+        if (!stripped.isEmpty() && stripped.size() > 5) {
+            const bool isUpperCase = std::none_of(stripped.cbegin(), stripped.cend(),
+                                                  [](QChar c) { return c.isLetter() && !c.isUpper(); });
+            if (isUpperCase) {
+                if (seenTitles.contains(stripped.left(30))) continue;
+                seenTitles.insert(stripped.left(30));
+            }
+        }
+        lines.append(line);
+    }
+    result = lines.join(u'\n');
+
+    // 13. Whitespace
+    result.replace(RE(R"([ \t]+)"), " ");
+    result.replace(RE(R"(\n\s*\n\s*\n+)"), "\n\n");
+    result.remove(RE(R"(^[ \t]+|[ \t]+$)", RE::MultilineOption));
+    return result.trimmed();
+}
+
+// Context around the first difference, for the report
+QString firstDifference(const QString& expected, const QString& actual) {
+    const auto mismatch = std::mismatch(expected.cbegin(), expected.cend(), actual.cbegin(), actual.cend());
+    const qsizetype at = mismatch.first - expected.cbegin();
+    auto excerpt = [at](const QString& text) {
+        const qsizetype from = qMax<qsizetype>(0, at - 40);
+        return text.mid(from, 80).replace(u'\n', u'/');
+    };
+    return QString("at %1\n    expected: %2\n    actual:   %3").arg(at).arg(excerpt(expected), excerpt(actual));
+}
+
+bool increasing(const QVector<qsizetype>& offsets, qsizetype sourceSize) {
+    return std::is_sorted(offsets.cbegin(), offsets.cend())
+        && (offsets.isEmpty() || (offsets.first() >= 0 && offsets.last() <= sourceSize));
+}
+
+class Checker {
+public:
+    explicit Checker(QTextStream& out) : m_out(out) {}
+
+    // Fused and offset-tracking cleaning against the former passes
+    void checkClean(const QString& name, const QString& text) {
+        ++m_samples;
+        const NarrationCleaner cleaner;
+        const QString expected = legacyClean(text);
+
+        const QString cleaned = cleaner.clean(text);
+        if (cleaned != expected) {
+            fail(name, "clean() differs from the sequential passes " + firstDifference(expected, cleaned));
+            return;
+        }
+
+        QVector<qsizetype> offsets;
+        const QString tracked = cleaner.clean(text, offsets);
+        if (tracked != expected) {
+            fail(name, "clean() with offsets differs " + firstDifference(expected, tracked));
+        } else if (offsets.size() != tracked.size() || !increasing(offsets, text.size())) {
+            fail(name, "clean() offsets are not one increasing origin per character");
+        }
+    }
+
+    // Streaming in fixed-size chunks against clean() on the whole text
+    void checkStream(const QString& name, const QString& text, qsizetype chunkSize) {
+        ++m_samples;
+        const NarrationCleaner cleaner;
+        const QString expected = cleaner.clean(text);
+
+        NarrationStream stream(cleaner);
+        NarrationStream trackedStream(cleaner);
+        QString streamed, tracked;
+        QVector<qsizetype> offsets;
+        for (qsizetype from = 0; from < text.size(); from += chunkSize) {
+            const QStringView chunk = QStringView(text).mid(from, chunkSize);
+            streamed += stream.append(chunk);
+            tracked += trackedStream.append(chunk, from, offsets);
+        }
+        streamed += stream.finish();
+        tracked += trackedStream.finish(offsets);
+
+        if (streamed != expected) {
+            fail(name, QString("NarrationStream (%1-char chunks) differs from clean() ").arg(chunkSize)
+                       + firstDifference(expected, streamed));
+        } else if (tracked != expected) {
+            fail(name, "NarrationStream with offsets differs " + firstDifference(expected, tracked));
+        } else if (offsets.size() != tracked.size() || !increasing(offsets, text.size())) {
+            fail(name, "NarrationStream offsets are not one increasing origin per character");
+        }
+    }
+
+    bool ok() const { return m_failures == 0; }
+    int samples() const { return m_samples; }
+    int failures() const { return m_failures; }
+
+private:
+    void fail(const QString& name, const QString& message) {
+        ++m_failures;
+        if (m_failures <= 20) m_out << "FAIL " << name << ": " << message << "\n";
+    }
+
+    QTextStream& m_out;
+    int m_samples = 0;
+    int m_failures = 0;
+};
+
+// Inputs where removing one annotation makes another appear
+const QStringList EDGE_CASES = {
+    "texte*(Décoration : x) suite",
+    "(Note (Décoration : x))",
+    "Il dit . . . . (Note : a) et *\nfin",
+    "A .(Décoration : b)... B",
+    "* † (Décoration : c)\nTexte",
+    "[ . . . ] | [mot] restauré <corrigé> 12 Suite",
+    "LE LIVRE SECRET (NH II, 1)\nT exte 3 Jésus dit.\n\n\nLE LIVRE SECRET\nFin (NH II, 1).",
+    "## Page 12\n---\nTraduction de X\n(Lacune de 3 lignes)\n  14  \nMot",
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QTextStream out(stdout);
+
+    QStringList files;
+    for (int i = 1; i < argc; ++i) {
+        files.append(QString::fromLocal8Bit(argv[i]));
+    }
+    if (files.isEmpty()) {
+        const QDir source(CODEX_SOURCE_DIR);
+        files.append(source.filePath("codex-nag-hammadi.md"));
+        const QDir texts(source.filePath("texts_clean"));
+        for (const QString& name : texts.entryList({"*.md"}, QDir::Files, QDir::Name)) {
+            files.append(texts.filePath(name));
+        }
+    }
+
+    Checker checker(out);
+    for (int i = 0; i < EDGE_CASES.size(); ++i) {
+        checker.checkClean(QString("edge case %1").arg(i + 1), EDGE_CASES[i]);
+    }
+
+    bool readAll = true;
+    for (const QString& path : files) {
+        const QString content = loadNormalized(path);
+        if (content.isEmpty()) {
+            out << "cannot read " << path << "\n";
+            readAll = false;
+            continue;
+        }
+        const QString name = QFileInfo(path).fileName();
+
+        checker.checkClean(name, content);
+        const QStringList pages = content.split(QRegularExpression(R"(\n(?=## Page \d))"));
+        for (int p = 0; p < pages.size(); ++p) {
+            checker.checkClean(QString("%1, page block %2").arg(name).arg(p), pages[p]);
+        }
+
+        checker.checkStream(name, content, 4096);
+        checker.checkStream(name, content, 97);
+    }
+
+    out << QString("%1 samples, %2 failures\n").arg(checker.samples()).arg(checker.failures());
+    out.flush();
+    return checker.ok() && readAll ? 0 : 1;
+}